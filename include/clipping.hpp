@@ -0,0 +1,72 @@
+#pragma once
+#include "geometry.hpp"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace geometry::clipping {
+
+// Часть отрезка внутри окна (алгоритм Лианга–Барски); nullopt, если отрезок окна не задевает
+[[nodiscard]] std::optional<Line> ClipLine(const Line &line, const BoundingBox &window) noexcept;
+
+// Кольцо, обрезанное окном (алгоритм Сазерленда–Ходжмана); пустое, если от кольца ничего не осталось
+[[nodiscard]] std::vector<Point2D> ClipRing(std::span<const Point2D> ring, const BoundingBox &window);
+
+// Отрезки в виде структуры массивов: одноимённые координаты лежат подряд и обрабатываются векторно
+struct LineSoA {
+    std::vector<double> x0, y0, x1, y1;
+
+    void Assign(std::span<const Line> lines);
+    // Не освобождает память при уменьшении, поэтому буфер можно переиспользовать между кадрами
+    void Resize(size_t n);
+    [[nodiscard]] size_t Size() const noexcept { return x0.size(); }
+    [[nodiscard]] Line At(size_t i) const noexcept { return Line{{x0[i], y0[i]}, {x1[i], y1[i]}}; }
+};
+
+/**
+    @brief Пакетное отсечение отрезков окном по Лиангу–Барски
+
+    out и visible должны заранее иметь размер in.Size() — функция не выделяет память. В out[i] пишется
+    обрезанный отрезок i, в visible[i] — 1, если он задел окно. Координаты невидимого отрезка — NaN,
+    поэтому out можно сразу отдавать на отрисовку ломаными. Возвращает число видимых отрезков.
+    in и out могут совпадать.
+*/
+size_t ClipLines(const LineSoA &in, const BoundingBox &window, LineSoA &out, std::span<uint8_t> visible) noexcept;
+
+/**
+    @brief Отсечение колец окном по Сазерленду–Ходжману над массивами координат
+
+    Вершины кольца передаются отдельными массивами x и y. Все рабочие буферы принадлежат объекту и только
+    растут, поэтому при повторных вызовах на кольцах сопоставимого размера память не выделяется.
+    Для многопоточной обработки нужен свой объект на поток.
+*/
+class RingClipper {
+public:
+    // Результат действителен до следующего вызова Clip или ClipRings
+    std::pair<std::span<const double>, std::span<const double>> Clip(std::span<const double> xs,
+                                                                     std::span<const double> ys,
+                                                                     const BoundingBox &window);
+
+    /**
+        @brief Пакет колец: кольцо r занимает вершины [offsets[r], offsets[r + 1]) массивов xs, ys
+
+        Результат дописывается в out_xs, out_ys после их очистки (ёмкость сохраняется), в out_offsets —
+        границы обрезанных колец в том же формате. Пустые после отсечения кольца остаются пустыми.
+    */
+    void ClipRings(std::span<const double> xs, std::span<const double> ys, std::span<const size_t> offsets,
+                   const BoundingBox &window, std::vector<double> &out_xs, std::vector<double> &out_ys,
+                   std::vector<size_t> &out_offsets);
+
+private:
+    // Один проход по стороне окна: из (src_x, src_y) в (dst_x, dst_y)
+    template <bool ALONG_X, bool KEEP_GREATER>
+    void ClipSide(double bound);
+
+    std::vector<double> src_x_, src_y_, dst_x_, dst_y_;
+    std::vector<double> cross_x_, cross_y_;  // Пересечение ребра (i - 1, i) со стороной
+    std::vector<double> inside_;  // 1.0 — вершина внутри; double, чтобы цикл не смешивал ширины типов
+};
+
+}  // namespace geometry::clipping
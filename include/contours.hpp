@@ -0,0 +1,34 @@
+#pragma once
+#include "geometry.hpp"
+#include "tin.hpp"
+#include "triangle_mesh.hpp"
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace geometry::triangulation {
+
+/**
+    @brief Изолиния одного уровня
+
+    Цепочка ориентирована так, что значения выше уровня лежат справа: замкнутая изолиния вокруг вершины
+    холма идёт по часовой стрелке. Незамкнутые цепочки начинаются и заканчиваются на границе сетки.
+*/
+struct Contour {
+    double level = 0.0;
+    std::vector<Point2D> points;
+    bool closed = false;
+
+    // Замкнутая изолиния как многоугольник (без повторения первой точки)
+    [[nodiscard]] std::optional<Polygon> AsPolygon() const;
+};
+
+// Изолинии по уровням levels методом marching triangles; результат сгруппирован по уровням в их порядке
+std::vector<Contour> ExtractContours(const TriangleMesh &mesh, std::span<const double> values,
+                                     std::span<const double> levels, size_t threads = 0);
+
+inline std::vector<Contour> ExtractContours(const Tin &tin, std::span<const double> levels, size_t threads = 0) {
+    return ExtractContours(tin.Mesh(), tin.Values(), levels, threads);
+}
+
+}  // namespace geometry::triangulation
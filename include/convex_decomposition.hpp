@@ -0,0 +1,64 @@
+#pragma once
+#include "geometry.hpp"
+#include <array>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace geometry::decomposition {
+
+struct ConvexPart {
+    std::vector<Point2D> points;  // Против часовой стрелки
+    BoundingBox box;
+};
+
+// Триангуляция простого многоугольника отсечением ушей; индексы вершин ring, треугольники против часовой стрелки
+std::expected<std::vector<std::array<size_t, 3>>, std::string> TriangulateSimplePolygon(std::span<const Point2D> ring);
+
+// Разбиение простого многоугольника на выпуклые части (Хертель–Мельхорн): частей не больше чем вчетверо больше оптимума
+std::expected<std::vector<ConvexPart>, std::string> ConvexDecomposition(std::span<const Point2D> ring);
+
+// Пересечение выпуклых многоугольников по теореме о разделяющей оси; касание считается пересечением
+[[nodiscard]] bool ConvexPartsIntersect(std::span<const Point2D> a, std::span<const Point2D> b) noexcept;
+
+// Расстояние между выпуклыми многоугольниками, 0 при пересечении
+[[nodiscard]] double ConvexPartsDistance(std::span<const Point2D> a, std::span<const Point2D> b);
+
+/**
+    @brief Кеш выпуклых разбиений многоугольников
+
+    Ключ — последовательность вершин, поэтому копии одного многоугольника разделяют одно разбиение.
+    Части отдаются через shared_ptr и остаются валидными после вытеснения из кеша. Многоугольник,
+    который не удалось разбить (самопересечение, вырождение), кешируется с пустым списком частей.
+    Методы потокобезопасны.
+*/
+class ConvexDecompositionCache {
+public:
+    using Parts = std::vector<ConvexPart>;
+
+    explicit ConvexDecompositionCache(size_t capacity = 4096) : capacity_(capacity) {}
+
+    [[nodiscard]] std::shared_ptr<const Parts> Get(const Polygon &polygon);
+
+    [[nodiscard]] size_t Size() const;
+    void Clear();
+
+private:
+    struct RingHash {
+        [[nodiscard]] size_t operator()(const std::vector<Point2D> &ring) const noexcept;
+    };
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::vector<Point2D>, std::shared_ptr<const Parts>, RingHash> entries_;
+};
+
+// Пересечение и расстояние многоугольников через попарные проверки их выпуклых частей
+[[nodiscard]] bool PolygonsIntersect(const Polygon &a, const Polygon &b, ConvexDecompositionCache &cache);
+[[nodiscard]] double PolygonsDistance(const Polygon &a, const Polygon &b, ConvexDecompositionCache &cache);
+
+}  // namespace geometry::decomposition
@@ -1,6 +1,9 @@
 #pragma once
 #include "geometry.hpp"
 #include <expected>
+#include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace geometry::convex_hull {
@@ -24,4 +27,35 @@ private:
 
 std::expected<std::vector<Point2D>, std::string> GrahamScan(std::span<Point2D> points) noexcept;
 
+/**
+    @brief Запросы к выпуклому многоугольнику за O(log n) двоичным поиском по его вершинам
+
+    Обёртка не копирует вершины: это представление над массивом, например над результатом GrahamScan,
+    который должен жить дольше неё. Вершины идут против часовой стрелки; коллинеарные вершины на рёбрах
+    допустимы. Для многоугольника меньше чем из трёх вершин запросы возвращают «пусто».
+*/
+class ConvexPolygon {
+public:
+    explicit ConvexPolygon(std::span<const Point2D> vertices) noexcept : vertices_(vertices) {}
+
+    [[nodiscard]] std::span<const Point2D> Vertices() const noexcept { return vertices_; }
+    [[nodiscard]] size_t Size() const noexcept { return vertices_.size(); }
+
+    // Точка внутри многоугольника или на его границе
+    [[nodiscard]] bool Contains(const Point2D &p) const noexcept;
+
+    // Индексы вершин касания (правой и левой, если смотреть из p) для точки строго снаружи
+    [[nodiscard]] std::optional<std::pair<size_t, size_t>> Tangents(const Point2D &p) const noexcept;
+
+    // Отрезок пересечения прямой через a и b с многоугольником, концы упорядочены по направлению b - a
+    [[nodiscard]] std::optional<std::pair<Point2D, Point2D>> IntersectLine(const Point2D &a,
+                                                                          const Point2D &b) const noexcept;
+
+    // Индекс вершины, наиболее удалённой в направлении direction
+    [[nodiscard]] size_t ExtremeVertex(const Point2D &direction) const noexcept;
+
+private:
+    std::span<const Point2D> vertices_;
+};
+
 }  // namespace geometry::convex_hull
\ No newline at end of file
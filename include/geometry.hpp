@@ -1,10 +1,16 @@
 #pragma once
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cmath>
+#include <cstdint>
 #include <format>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <numbers>
 #include <ranges>
+#include <span>
 #include <variant>
 #include <vector>
 
@@ -16,7 +22,10 @@ struct Point2D {
     constexpr Point2D() noexcept : x(0), y(0) {}
     constexpr Point2D(double x, double y) noexcept : x(x), y(y) {}
 
-    [[nodiscard]] constexpr bool operator<(const Point2D &other) const noexcept { return x < other.x && y < other.y; }
+    // Лексикографический порядок (сначала x, затем y) — строгий слабый порядок, пригоден для sort/set
+    [[nodiscard]] constexpr bool operator<(const Point2D &other) const noexcept {
+        return x < other.x || (x == other.x && y < other.y);
+    }
     [[nodiscard]] constexpr bool operator==(const Point2D &other) const noexcept {
         return x == other.x && y == other.y;
     }
@@ -264,9 +273,356 @@ private:
     BoundingBox bounding_box_;
 };
 
-using Shape = std::variant<Line, Triangle, Rectangle, RegularPolygon, Circle, Polygon>;
+/**
+    @brief Замкнутые кольца в общем пуле вершин с bounding box у каждого кольца
+
+    Внешние кольца хранятся против часовой стрелки, дыры — по часовой, поэтому принадлежность точки
+    определяется одним проходом по рёбрам: точка внутри, если число оборотов ненулевое. Кольцо, в чей
+    bounding box точка не попадает, пропускается целиком — его вклад в число оборотов нулевой.
+*/
+class RingSet {
+public:
+    [[nodiscard]] size_t RingCount() const noexcept { return rings_.size(); }
+    [[nodiscard]] std::span<const Point2D> Ring(size_t i) const noexcept {
+        return std::span(points_).subspan(rings_[i].begin, rings_[i].end - rings_[i].begin);
+    }
+    [[nodiscard]] const BoundingBox &RingBox(size_t i) const noexcept { return rings_[i].box; }
+    // Вершины всех колец подряд
+    [[nodiscard]] std::span<const Point2D> Vertices() const noexcept { return points_; }
+
+    // Кольца, разделённые NaN, чтобы при отрисовке они не соединялись
+    [[nodiscard]] Lines2DDyn Lines() const {
+        Lines2DDyn lines;
+        lines.Reserve(points_.size() + 2 * rings_.size());
+        for (size_t r = 0; r < rings_.size(); ++r) {
+            if (r > 0) {
+                lines.PushBack(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN());
+            }
+            for (const auto &p : Ring(r)) {
+                lines.PushBack(p);
+            }
+            if (!Ring(r).empty()) {
+                lines.PushBack(Ring(r).front());
+            }
+        }
+        return lines;
+    }
+
+protected:
+    // Число оборотов колец [first, last) вокруг точки
+    [[nodiscard]] int WindingNumber(const Point2D &p, size_t first, size_t last) const noexcept {
+        int winding = 0;
+        for (size_t r = first; r < last; ++r) {
+            const auto &box = rings_[r].box;
+            if (p.x < box.min_x || p.x > box.max_x || p.y < box.min_y || p.y > box.max_y) {
+                continue;
+            }
+            const auto ring = Ring(r);
+            for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+                const Point2D &a = ring[j], &b = ring[i];
+                const double side = (b - a).Cross(p - a);
+                if (a.y <= p.y) {
+                    winding += (b.y > p.y && side > 0) ? 1 : 0;
+                } else {
+                    winding -= (b.y <= p.y && side < 0) ? 1 : 0;
+                }
+            }
+        }
+        return winding;
+    }
+
+    // Добавляет кольцо, приводя его к обходу против часовой стрелки (внешнее) или по часовой (дыра)
+    BoundingBox AddRing(std::span<const Point2D> ring, bool hole) {
+        const size_t begin = points_.size();
+        points_.insert(points_.end(), ring.begin(), ring.end());
+
+        double doubled_area = 0.0;
+        for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+            doubled_area += ring[j].Cross(ring[i]);
+        }
+        if ((doubled_area < 0) != hole) {
+            std::reverse(points_.begin() + static_cast<std::ptrdiff_t>(begin), points_.end());
+        }
+
+        BoundingBox box;
+        if (!ring.empty()) {
+            box = {ring.front().x, ring.front().y, ring.front().x, ring.front().y};
+            for (const auto &p : ring) {
+                box = {std::min(box.min_x, p.x), std::min(box.min_y, p.y), std::max(box.max_x, p.x),
+                       std::max(box.max_y, p.y)};
+            }
+        }
+        rings_.push_back({begin, points_.size(), box});
+        return box;
+    }
+
+    struct RingRange {
+        size_t begin, end;
+        BoundingBox box;
+    };
+
+    std::vector<Point2D> points_;
+    std::vector<RingRange> rings_;
+};
+
+// Многоугольник с дырами: кольцо 0 — внешняя граница, остальные — дыры
+class PolygonWithHoles : public RingSet {
+public:
+    explicit PolygonWithHoles(const std::vector<Point2D> &outer, const std::vector<std::vector<Point2D>> &holes = {}) {
+        bounding_box_ = AddRing(outer, false);
+        for (const auto &hole : holes) {
+            AddRing(hole, true);
+        }
+    }
+
+    [[nodiscard]] BoundingBox BoundBox() const noexcept { return bounding_box_; }
+    [[nodiscard]] double Height() const noexcept { return bounding_box_.max_y; }
+    [[nodiscard]] Point2D Center() const noexcept { return bounding_box_.Center(); }
+
+    [[nodiscard]] std::span<const Point2D> Outer() const noexcept { return Ring(0); }
+    [[nodiscard]] size_t HoleCount() const noexcept { return RingCount() - 1; }
+    [[nodiscard]] std::span<const Point2D> Hole(size_t i) const noexcept { return Ring(i + 1); }
+
+    [[nodiscard]] bool Contains(const Point2D &p) const noexcept { return WindingNumber(p, 0, RingCount()) != 0; }
+
+private:
+    BoundingBox bounding_box_;
+};
+
+/**
+    @brief Несколько многоугольников с дырами в одном пуле вершин
+
+    Bounding box образуют иерархию: вся фигура — части — кольца, так что при проверке принадлежности
+    рёбра перебираются только у колец, которые могут содержать точку.
+*/
+class MultiPolygon : public RingSet {
+public:
+    explicit MultiPolygon(const std::vector<PolygonWithHoles> &parts) {
+        for (const auto &part : parts) {
+            const size_t first = RingCount();
+            for (size_t r = 0; r < part.RingCount(); ++r) {
+                AddRing(part.Ring(r), r > 0);
+            }
+            parts_.push_back({first, RingCount(), part.BoundBox()});
+        }
+        if (!parts_.empty()) {
+            bounding_box_ = parts_.front().box;
+            for (const auto &part : parts_) {
+                bounding_box_ = {std::min(bounding_box_.min_x, part.box.min_x),
+                                 std::min(bounding_box_.min_y, part.box.min_y),
+                                 std::max(bounding_box_.max_x, part.box.max_x),
+                                 std::max(bounding_box_.max_y, part.box.max_y)};
+            }
+        }
+    }
+
+    [[nodiscard]] BoundingBox BoundBox() const noexcept { return bounding_box_; }
+    [[nodiscard]] double Height() const noexcept { return bounding_box_.max_y; }
+    [[nodiscard]] Point2D Center() const noexcept { return bounding_box_.Center(); }
+
+    [[nodiscard]] size_t PartCount() const noexcept { return parts_.size(); }
+    [[nodiscard]] const BoundingBox &PartBox(size_t i) const noexcept { return parts_[i].box; }
+    // Кольца части i — это кольца [first, last) общего набора
+    [[nodiscard]] std::pair<size_t, size_t> PartRings(size_t i) const noexcept {
+        return {parts_[i].first_ring, parts_[i].last_ring};
+    }
+
+    [[nodiscard]] bool Contains(const Point2D &p) const noexcept {
+        int winding = 0;
+        for (const auto &part : parts_) {
+            if (part.box.Overlaps({p.x, p.y, p.x, p.y})) {
+                winding += WindingNumber(p, part.first_ring, part.last_ring);
+            }
+        }
+        return winding != 0;
+    }
+
+private:
+    struct Part {
+        size_t first_ring, last_ring;
+        BoundingBox box;
+    };
+
+    std::vector<Part> parts_;
+    BoundingBox bounding_box_;
+};
+
+// Преобразование подобия: масштаб, поворот вокруг начала координат, затем сдвиг
+struct Transform2D {
+    Point2D offset{0, 0};
+    double cos_angle = 1.0, sin_angle = 0.0;
+    double scale = 1.0;  // Строго положительный
+
+    [[nodiscard]] static Transform2D Make(Point2D offset, double angle = 0.0, double scale = 1.0) noexcept {
+        return {offset, std::cos(angle), std::sin(angle), scale};
+    }
+
+    [[nodiscard]] constexpr bool IsAxisAligned() const noexcept { return sin_angle == 0.0 && cos_angle > 0.0; }
+
+    [[nodiscard]] constexpr Point2D Apply(const Point2D &p) const noexcept {
+        return offset + Point2D{p.x * cos_angle - p.y * sin_angle, p.x * sin_angle + p.y * cos_angle} * scale;
+    }
+    [[nodiscard]] constexpr Point2D ApplyInverse(const Point2D &p) const noexcept {
+        const Point2D d = (p - offset) / scale;
+        return {d.x * cos_angle + d.y * sin_angle, -d.x * sin_angle + d.y * cos_angle};
+    }
+
+    [[nodiscard]] constexpr Transform2D Inverse() const noexcept {
+        Transform2D inverse{{0, 0}, cos_angle, -sin_angle, 1.0 / scale};
+        inverse.offset = Point2D{0, 0} - inverse.Apply(offset);
+        return inverse;
+    }
+    // Сначала *this, затем next
+    [[nodiscard]] constexpr Transform2D Then(const Transform2D &next) const noexcept {
+        return {next.Apply(offset), next.cos_angle * cos_angle - next.sin_angle * sin_angle,
+                next.sin_angle * cos_angle + next.cos_angle * sin_angle, next.scale * scale};
+    }
+};
+
+// Фигуры, которые могут служить прототипом экземпляра (вложенные экземпляры не допускаются)
+using PrototypeShape =
+    std::variant<Line, Triangle, Rectangle, RegularPolygon, Circle, Polygon, PolygonWithHoles, MultiPolygon>;
+
+// Образ фигуры при преобразовании; повёрнутые прямоугольник и правильный многоугольник становятся Polygon
+[[nodiscard]] inline PrototypeShape Transformed(const PrototypeShape &shape, const Transform2D &transform) {
+    auto map = [&transform](std::span<const Point2D> points) {
+        std::vector<Point2D> mapped;
+        mapped.reserve(points.size());
+        for (const auto &p : points) {
+            mapped.push_back(transform.Apply(p));
+        }
+        return mapped;
+    };
+    return std::visit(
+        [&](const auto &s) -> PrototypeShape {
+            using T = std::decay_t<decltype(s)>;
+            if constexpr (std::is_same_v<T, Line>) {
+                return Line{transform.Apply(s.start), transform.Apply(s.end)};
+            } else if constexpr (std::is_same_v<T, Triangle>) {
+                return Triangle{transform.Apply(s.a), transform.Apply(s.b), transform.Apply(s.c)};
+            } else if constexpr (std::is_same_v<T, Circle>) {
+                return Circle{transform.Apply(s.center_p), s.radius * transform.scale};
+            } else if constexpr (std::is_same_v<T, Rectangle>) {
+                if (transform.IsAxisAligned()) {
+                    return Rectangle{transform.Apply(s.bottom_left), s.width * transform.scale,
+                                     s.height * transform.scale};
+                }
+                const auto vertices = s.Vertices();
+                return Polygon{map(vertices)};
+            } else if constexpr (std::is_same_v<T, PolygonWithHoles>) {
+                std::vector<std::vector<Point2D>> holes;
+                for (size_t i = 0; i < s.HoleCount(); ++i) {
+                    holes.push_back(map(s.Hole(i)));
+                }
+                return PolygonWithHoles{map(s.Outer()), holes};
+            } else if constexpr (std::is_same_v<T, MultiPolygon>) {
+                std::vector<PolygonWithHoles> parts;
+                for (size_t part = 0; part < s.PartCount(); ++part) {
+                    const auto [first, last] = s.PartRings(part);
+                    std::vector<std::vector<Point2D>> holes;
+                    for (size_t r = first + 1; r < last; ++r) {
+                        holes.push_back(map(s.Ring(r)));
+                    }
+                    parts.emplace_back(map(s.Ring(first)), holes);
+                }
+                return MultiPolygon{parts};
+            } else {
+                const auto vertices = s.Vertices();
+                return Polygon{map(vertices)};
+            }
+        },
+        shape);
+}
+
+/**
+    @brief Экземпляр общей фигуры-прототипа с собственным преобразованием подобия
+
+    Прототип разделяется всеми экземплярами, сам экземпляр хранит только преобразование и bounding box.
+    Запросы переводят точку или вторую фигуру в систему координат прототипа, поэтому вершины
+    экземпляра не материализуются, а структуры прототипа (bounding box колец, кеш разбиения на выпуклые
+    части) переиспользуются всеми его копиями.
+*/
+class InstancedShape {
+public:
+    InstancedShape(std::shared_ptr<const PrototypeShape> prototype, const Transform2D &transform)
+        : prototype_(std::move(prototype)), transform_(transform) {
+        CalculateBoundBox();
+    }
+
+    [[nodiscard]] const PrototypeShape &Prototype() const noexcept { return *prototype_; }
+    [[nodiscard]] const std::shared_ptr<const PrototypeShape> &SharedPrototype() const noexcept { return prototype_; }
+    [[nodiscard]] const Transform2D &GetTransform() const noexcept { return transform_; }
+
+    [[nodiscard]] BoundingBox BoundBox() const noexcept { return bounding_box_; }
+    [[nodiscard]] double Height() const noexcept { return bounding_box_.max_y; }
+    [[nodiscard]] Point2D Center() const {
+        return transform_.Apply(std::visit([](const auto &s) -> Point2D { return s.Center(); }, *prototype_));
+    }
+
+    // Вершины в мировых координатах — копия, для отрисовки и сбора точек
+    [[nodiscard]] std::vector<Point2D> Vertices() const {
+        return std::visit(
+            [this](const auto &s) {
+                std::vector<Point2D> points;
+                for (const auto &p : s.Vertices()) {
+                    points.push_back(transform_.Apply(p));
+                }
+                return points;
+            },
+            *prototype_);
+    }
+    [[nodiscard]] Lines2DDyn Lines() const {
+        return std::visit(
+            [this](const auto &s) {
+                const auto source = s.Lines();
+                Lines2DDyn lines;
+                lines.Reserve(source.x.size());
+                for (size_t i = 0; i < source.x.size(); ++i) {
+                    lines.PushBack(transform_.Apply({source.x[i], source.y[i]}));
+                }
+                return lines;
+            },
+            *prototype_);
+    }
+
+private:
+    void CalculateBoundBox() {
+        if (const auto *circle = std::get_if<Circle>(prototype_.get())) {
+            bounding_box_ = Circle{transform_.Apply(circle->center_p), circle->radius * transform_.scale}.BoundBox();
+            return;
+        }
+        const auto points = Vertices();
+        if (points.empty()) {
+            bounding_box_ = BoundingBox{transform_.offset.x, transform_.offset.y, transform_.offset.x,
+                                        transform_.offset.y};
+            return;
+        }
+        bounding_box_ = BoundingBox{points.front().x, points.front().y, points.front().x, points.front().y};
+        for (const auto &p : points) {
+            bounding_box_ = {std::min(bounding_box_.min_x, p.x), std::min(bounding_box_.min_y, p.y),
+                             std::max(bounding_box_.max_x, p.x), std::max(bounding_box_.max_y, p.y)};
+        }
+    }
+
+    std::shared_ptr<const PrototypeShape> prototype_;
+    Transform2D transform_;
+    BoundingBox bounding_box_;
+};
+
+using Shape = std::variant<Line, Triangle, Rectangle, RegularPolygon, Circle, Polygon, PolygonWithHoles, MultiPolygon,
+                           InstancedShape>;
 }  // namespace geometry
 
+template <>
+struct std::hash<geometry::Point2D> {
+    [[nodiscard]] size_t operator()(const geometry::Point2D &p) const noexcept {
+        // +0.0 нормализует -0.0, чтобы равные по operator== точки имели одинаковый хеш
+        const auto hx = std::bit_cast<uint64_t>(p.x + 0.0);
+        const auto hy = std::bit_cast<uint64_t>(p.y + 0.0);
+        return static_cast<size_t>(hx ^ (hy + 0x9e3779b97f4a7c15ULL + (hx << 6) + (hx >> 2)));
+    }
+};
+
 template <>
 struct std::formatter<geometry::Point2D> {
     constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
@@ -390,6 +746,39 @@ struct std::formatter<geometry::Polygon> {
     }
 };
 
+template <>
+struct std::formatter<geometry::PolygonWithHoles> {
+    constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
+
+    template <typename FormatContext>
+    auto format(const geometry::PolygonWithHoles &poly, FormatContext &ctx) const {
+        return std::format_to(ctx.out(), "PolygonWithHoles[{} points, {} holes]", poly.Vertices().size(),
+                              poly.HoleCount());
+    }
+};
+
+template <>
+struct std::formatter<geometry::MultiPolygon> {
+    constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
+
+    template <typename FormatContext>
+    auto format(const geometry::MultiPolygon &poly, FormatContext &ctx) const {
+        return std::format_to(ctx.out(), "MultiPolygon[{} parts, {} rings]", poly.PartCount(), poly.RingCount());
+    }
+};
+
+template <>
+struct std::formatter<geometry::InstancedShape> {
+    constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
+
+    template <typename FormatContext>
+    auto format(const geometry::InstancedShape &shape, FormatContext &ctx) const {
+        const auto &transform = shape.GetTransform();
+        return std::format_to(ctx.out(), "InstancedShape[offset={}, angle={:.2f}, scale={:.2f}]", transform.offset,
+                              std::atan2(transform.sin_angle, transform.cos_angle), transform.scale);
+    }
+};
+
 template <>
 struct std::formatter<geometry::Shape> {
     constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
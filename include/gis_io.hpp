@@ -0,0 +1,113 @@
+#pragma once
+#include "geometry.hpp"
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace geometry::io {
+
+// Коды типов совпадают с кодами WKB
+enum class GeometryType : uint32_t {
+    Point = 1,
+    LineString = 2,
+    Polygon = 3,
+    MultiPoint = 4,
+    MultiLineString = 5,
+    MultiPolygon = 6,
+    GeometryCollection = 7,
+};
+
+/**
+    @brief Геометрия в общем пуле вершин: пути в CSR-виде поверх одного массива точек
+
+    Путь — линия, кольцо многоугольника или все точки MultiPoint. Многоугольник — диапазон путей: первое
+    кольцо внешнее, остальные дыры. Кольца лежат так, как записаны в источнике, обычно с повторённой
+    первой точкой в конце. Читатели заполняют пул заново для каждой геометрии и память не отдают,
+    поэтому view действителен только внутри вызова visit.
+*/
+struct GeometryView {
+    GeometryType type = GeometryType::Point;
+    std::span<const Point2D> points;
+    std::span<const size_t> paths;  // Путь i — points[paths[i], paths[i + 1])
+    std::span<const size_t> parts;  // Многоугольник j — пути [parts[j], parts[j + 1]); только у Polygon, MultiPolygon
+
+    [[nodiscard]] size_t PathCount() const noexcept { return paths.empty() ? 0 : paths.size() - 1; }
+    [[nodiscard]] std::span<const Point2D> Path(size_t i) const noexcept {
+        return points.subspan(paths[i], paths[i + 1] - paths[i]);
+    }
+    [[nodiscard]] size_t PartCount() const noexcept { return parts.empty() ? 0 : parts.size() - 1; }
+};
+
+using GeometryVisitor = std::function<void(const GeometryView &)>;
+
+/**
+    @brief Потоковое чтение: каждая геометрия передаётся в visit сразу после разбора
+
+    Возвращают число переданных геометрий. GeometryCollection раскрывается в свои элементы, Feature и
+    FeatureCollection GeoJSON — в свои geometry. Координаты Z и M не поддерживаются.
+    WKB — последовательность геометрий подряд. Если порядок байтов геометрии совпадает с машинным,
+    координаты кольца переносятся в пул одним memcpy прямо из буфера (например, отображённого
+    MappedFile). Буквально без копирования нельзя: double в WKB не выровнены, а фигуры владеют вершинами.
+    WKT — геометрии, разделённые пробелами или «;».
+*/
+[[nodiscard]] std::expected<size_t, std::string> ReadWkb(std::span<const uint8_t> data, const GeometryVisitor &visit);
+[[nodiscard]] std::expected<size_t, std::string> ReadWkt(std::string_view text, const GeometryVisitor &visit);
+[[nodiscard]] std::expected<size_t, std::string> ReadGeoJson(std::string_view text, const GeometryVisitor &visit);
+
+// Прочитанное в виде фигур: точки (Point, MultiPoint) отдельно, линии — отрезками по парам соседних вершин
+struct Geometries {
+    std::vector<Shape> shapes;
+    std::vector<Point2D> points;
+};
+
+// Polygon без дыр становится Polygon, с дырами — PolygonWithHoles; повторённая замыкающая точка снимается
+void AppendShapes(const GeometryView &view, Geometries &out);
+
+[[nodiscard]] std::expected<Geometries, std::string> DecodeWkb(std::span<const uint8_t> data);
+[[nodiscard]] std::expected<Geometries, std::string> DecodeWkt(std::string_view text);
+[[nodiscard]] std::expected<Geometries, std::string> DecodeGeoJson(std::string_view text);
+
+// Запись одной геометрии; кольца замыкаются, числа пишутся в кратчайшем точном виде
+void WriteWkb(const GeometryView &view, std::vector<uint8_t> &out);
+void WriteWkt(const GeometryView &view, std::string &out);
+void WriteGeoJson(const GeometryView &view, std::string &out);
+
+/**
+    @brief Фигуры и точки в формате обмена
+
+    Отрезок пишется как LineString, многоугольники всех видов — как Polygon или MultiPolygon, круг —
+    как многоугольник из CIRCLE_VERTICES вершин, экземпляр — как образ прототипа. Точки, если они есть,
+    идут последней геометрией MultiPoint. WKB — геометрии подряд, WKT — по одной на строку,
+    GeoJSON — FeatureCollection, у объекта свойство index — его номер во входном наборе.
+*/
+inline constexpr size_t CIRCLE_VERTICES = 64;
+
+[[nodiscard]] std::vector<uint8_t> EncodeWkb(std::span<const Shape> shapes, std::span<const Point2D> points = {});
+[[nodiscard]] std::string EncodeWkt(std::span<const Shape> shapes, std::span<const Point2D> points = {});
+[[nodiscard]] std::string EncodeGeoJson(std::span<const Shape> shapes, std::span<const Point2D> points = {});
+
+// Файл, отображённый в память только для чтения
+class MappedFile {
+public:
+    [[nodiscard]] static std::expected<MappedFile, std::string> Open(const std::string &path);
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    [[nodiscard]] std::span<const uint8_t> Bytes() const noexcept { return {data_, size_}; }
+
+private:
+    MappedFile(const uint8_t *data, size_t size) noexcept : data_(data), size_(size) {}
+
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}  // namespace geometry::io
@@ -0,0 +1,54 @@
+#pragma once
+#include "geometry.hpp"
+#include "image.hpp"
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace geometry::visualization {
+
+// Двумерная гистограмма над extent: ячейка (x, y) — x слева направо, y снизу вверх
+struct DensityGrid {
+    BoundingBox extent;
+    size_t width = 0, height = 0;
+    std::vector<double> values;  // values[y * width + x]
+    size_t outside = 0;          // Точек, не попавших в extent
+
+    [[nodiscard]] double &At(size_t x, size_t y) noexcept { return values[y * width + x]; }
+    [[nodiscard]] double At(size_t x, size_t y) const noexcept { return values[y * width + x]; }
+    [[nodiscard]] double Total() const noexcept;
+    [[nodiscard]] double Max() const noexcept;
+};
+
+// Какие точки фигур попадают в гистограмму
+enum class ShapePoints { Centers, Vertices };
+
+struct HeatmapOptions {
+    size_t width = 512, height = 512;
+    std::optional<BoundingBox> extent;  // nullopt — bounding box входных точек
+    double bandwidth = 0.0;             // σ гауссова ядра в ячейках; 0 — без сглаживания
+    bool log_scale = true;              // Цвет по log(1 + v): иначе редкие точки рядом с пиком не видны
+    size_t threads = 0;                 // 0 — по числу аппаратных потоков
+};
+
+/**
+    @brief Раскладывает точки по ячейкам сетки width × height
+
+    Каждый поток считает свой блок точек в собственную гистограмму, без атомарных операций и общих
+    кеш-линий, затем гистограммы параллельно суммируются по ячейкам. Точка на правой или верхней
+    границе extent попадает в крайнюю ячейку.
+*/
+[[nodiscard]] DensityGrid BinPoints(std::span<const Point2D> points, const HeatmapOptions &options = {});
+[[nodiscard]] DensityGrid BinShapes(std::span<const Shape> shapes, ShapePoints source,
+                                    const HeatmapOptions &options = {});
+
+// Оценка плотности гауссовым ядром: два одномерных прохода вместо двумерной свёртки; за краем сетки нули
+void GaussianBlur(DensityGrid &grid, double sigma, size_t threads = 0);
+
+// Палитра viridis; строка 0 кадра — верхняя строка сетки
+[[nodiscard]] Image Colorize(const DensityGrid &grid, bool log_scale = true);
+
+// Гистограмма, сглаживание при bandwidth > 0 и раскраска
+[[nodiscard]] Image RenderHeatmap(std::span<const Point2D> points, const HeatmapOptions &options = {});
+
+}  // namespace geometry::visualization
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace geometry::visualization {
+
+struct Rgb {
+    uint8_t r = 0, g = 0, b = 0;
+
+    bool operator==(const Rgb &) const = default;
+};
+
+// Кадр в памяти: строки сверху вниз, пиксель (x, y) — pixels[y * width + x]
+struct Image {
+    size_t width = 0, height = 0;
+    std::vector<Rgb> pixels;
+
+    [[nodiscard]] Rgb &At(size_t x, size_t y) noexcept { return pixels[y * width + x]; }
+    [[nodiscard]] const Rgb &At(size_t x, size_t y) const noexcept { return pixels[y * width + x]; }
+    bool operator==(const Image &) const = default;
+};
+
+// PNG 8 бит на канал без сжатия (deflate из несжатых блоков), чтобы не тянуть zlib
+[[nodiscard]] std::vector<uint8_t> EncodePng(const Image &image);
+[[nodiscard]] std::expected<void, std::string> SavePng(const Image &image, std::string_view filename);
+
+}  // namespace geometry::visualization
@@ -0,0 +1,25 @@
+#pragma once
+#include "geometry.hpp"
+#include <span>
+#include <vector>
+
+namespace geometry::labeling {
+
+/**
+    @brief Полюс недоступности: внутренняя точка многоугольника, наиболее удалённая от его границы
+
+    precision — допустимый недобор расстояния до границы; при precision <= 0 берётся тысячная доля
+    наибольшей стороны bounding box. Ориентация контура не важна.
+*/
+Point2D PoleOfInaccessibility(std::span<const Point2D> ring, double precision = 0.0);
+
+// Полюс недоступности многоугольника с дырами или мультиполигона: точка не попадает в дыры
+Point2D PoleOfInaccessibility(const RingSet &rings, double precision = 0.0);
+
+// Точка для подписи фигуры: для многоугольников — полюс недоступности, для выпуклых фигур — их центр
+Point2D LabelPoint(const Shape &shape, double precision = 0.0);
+
+// Точки подписей для набора фигур, считаются параллельно
+std::vector<Point2D> LabelPoints(std::span<const Shape> shapes, double precision = 0.0, size_t threads = 0);
+
+}  // namespace geometry::labeling
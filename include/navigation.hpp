@@ -0,0 +1,83 @@
+#pragma once
+#include "geometry.hpp"
+#include "spatial_index.hpp"
+#include <expected>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace geometry::navigation {
+
+struct Path {
+    std::vector<Point2D> points;
+    double length = 0.0;
+};
+
+// Контуры фигуры-препятствия: окружность заменяется описанным вокруг неё многоугольником,
+// у многоугольников с дырами берутся только внешние контуры
+std::vector<std::vector<Point2D>> ObstacleOutlines(const Shape &shape);
+
+/**
+    @brief Граф видимости над препятствиями для поиска кратчайших евклидовых путей
+
+    Кратчайший путь огибает препятствия только в их выпуклых вершинах и идёт по касательным, поэтому в граф
+    попадают лишь выпуклые вершины и рёбра, касательные к препятствиям в обоих концах (редуцированный граф).
+    Граф строится один раз в конструкторе и переиспользуется всеми запросами; видимость концов пути
+    дополнительно кешируется, так что повторные запросы из тех же точек стоят только A*.
+    Окружности аппроксимируются описанным многоугольником, чтобы путь не срезал их края.
+    Соседей каждой вершины находит вращательная развёртка Ли за O(n log n), весь граф строится за O(n² log n),
+    где n — число рёбер препятствий. Пересекающиеся рёбра наложенных препятствий режутся в точках пересечения.
+*/
+class VisibilityGraph {
+public:
+    explicit VisibilityGraph(std::span<const Shape> obstacles, size_t threads = 0);
+    ~VisibilityGraph();
+    VisibilityGraph(VisibilityGraph &&) noexcept;
+    VisibilityGraph &operator=(VisibilityGraph &&) noexcept;
+
+    [[nodiscard]] std::expected<Path, std::string> ShortestPath(const Point2D &start, const Point2D &goal) const;
+
+    // Отрезок [a, b] не проходит через внутренность препятствий и не пересекает их границ
+    [[nodiscard]] bool IsVisible(const Point2D &a, const Point2D &b) const;
+    // Точка не лежит строго внутри препятствия
+    [[nodiscard]] bool IsFree(const Point2D &p) const;
+
+    [[nodiscard]] std::span<const Point2D> Vertices() const noexcept { return vertices_; }
+    [[nodiscard]] size_t EdgeCount() const noexcept { return neighbors_.size() / 2; }
+
+private:
+    struct Ring {
+        std::vector<Point2D> points;
+        BoundingBox box;
+        bool closed;
+    };
+    struct Segment {
+        Point2D a, b;
+    };
+    struct Neighbor {
+        size_t vertex;
+        double weight;
+    };
+    struct EndpointCache;
+
+    [[nodiscard]] bool IsTangent(size_t vertex, const Point2D &toward) const;
+    [[nodiscard]] bool StrictlyInside(const Point2D &p) const;
+    // Видимые из p вершины графа в порядке углового обхода вокруг p; вырожденные лучи проверяются IsVisible
+    [[nodiscard]] std::vector<Neighbor> ScanVisible(const Point2D &p, size_t self) const;
+    [[nodiscard]] std::vector<Neighbor> EndpointNeighbors(const Point2D &p) const;
+
+    std::vector<Ring> rings_;
+    std::vector<Segment> segments_;
+    index::GridIndex segment_index_;
+    index::GridIndex ring_index_;
+
+    std::vector<Point2D> vertices_;
+    std::vector<Point2D> vertex_prev_, vertex_next_;  // Соседи вершины по контуру (для концов Line совпадают)
+
+    std::vector<size_t> offsets_;
+    std::vector<Neighbor> neighbors_;
+    std::unique_ptr<EndpointCache> cache_;
+};
+
+}  // namespace geometry::navigation
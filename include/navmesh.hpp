@@ -0,0 +1,46 @@
+#pragma once
+#include "geometry.hpp"
+#include "navigation.hpp"
+#include "spatial_index.hpp"
+#include "triangle_mesh.hpp"
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace geometry::navigation {
+
+struct NavMeshOptions {
+    // Длиннее этого рёбра препятствий и границы области дробятся, чтобы триангуляция Делоне их сохранила;
+    // 0 — 1/32 наибольшей стороны области
+    double max_edge_length = 0.0;
+};
+
+/**
+    @brief Навигационная сетка: триангуляция свободного пространства области за вычетом препятствий
+
+    Вершины препятствий и области (с дроблением длинных рёбер) триангулируются модулем triangulation,
+    после чего отбрасываются треугольники внутри препятствий или пересекающие их рёбра. Запрос пути —
+    A* по смежности треугольников и спрямление коридора «воронкой» (string pulling). Треугольник
+    под точкой ищется по сетке над их bounding box, без перебора.
+*/
+class NavMesh {
+public:
+    static std::expected<NavMesh, std::string> Build(const BoundingBox &region, std::span<const Shape> obstacles,
+                                                     const NavMeshOptions &options = {});
+
+    [[nodiscard]] std::expected<Path, std::string> FindPath(const Point2D &start, const Point2D &goal) const;
+
+    // Треугольник сетки, содержащий точку
+    [[nodiscard]] std::optional<size_t> Locate(const Point2D &p) const;
+
+    [[nodiscard]] const triangulation::TriangleMesh &Mesh() const noexcept { return mesh_; }
+
+private:
+    NavMesh() = default;
+
+    triangulation::TriangleMesh mesh_;
+    index::GridIndex triangle_index_;
+};
+
+}  // namespace geometry::navigation
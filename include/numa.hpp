@@ -0,0 +1,154 @@
+#pragma once
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace geometry::numa {
+
+enum class Placement {
+    Default,     // Политика ядра: страница достаётся узлу потока, первым записавшего в неё
+    FirstTouch,  // Область делится на непрерывные куски по числу узлов, каждый кусок трогается потоком своего узла
+    Node,        // Вся область на узле MemoryOptions::node (MPOL_BIND: другие узлы не используются)
+    Interleave,  // Страницы по очереди на всех узлах
+};
+
+enum class HugePages {
+    None,
+    Transparent,  // madvise(MADV_HUGEPAGE): ядро собирает большие страницы, когда может
+    Explicit,     // MAP_HUGETLB из заранее выделенного пула; если пул пуст — обычные страницы
+};
+
+struct MemoryOptions {
+    Placement placement = Placement::Default;
+    size_t node = 0;
+    HugePages huge_pages = HugePages::None;
+
+    bool operator==(const MemoryOptions &) const = default;
+};
+
+// Число узлов NUMA в сети; 1, если топология недоступна. Узлы нумеруются подряд с 0 в порядке номеров ядра
+[[nodiscard]] size_t NodeCount();
+// Процессоры узла
+[[nodiscard]] std::vector<size_t> NodeCpus(size_t node);
+// Узел, на котором сейчас выполняется поток
+[[nodiscard]] size_t CurrentNode();
+// Закрепляет текущий поток за процессорами узла; повторный вызов для того же узла ничего не стоит
+bool PinCurrentThreadToNode(size_t node);
+
+// Узел рабочего потока worker из threads: потоки делятся между узлами поровну непрерывными группами
+[[nodiscard]] inline size_t WorkerNode(size_t worker, size_t threads) {
+    return threads == 0 ? 0 : worker * NodeCount() / threads;
+}
+
+// Непрерывный кусок [begin, end) из count элементов, приходящийся на узел при Placement::FirstTouch
+[[nodiscard]] inline std::pair<size_t, size_t> NodeSlice(size_t count, size_t node) {
+    const size_t nodes = NodeCount();
+    return {count * node / nodes, count * (node + 1) / nodes};
+}
+
+// Страницы под bytes байт с заданным размещением; nullptr, если отобразить память не удалось
+[[nodiscard]] void *AllocatePages(size_t bytes, const MemoryOptions &options);
+void FreePages(void *pointer, size_t bytes, const MemoryOptions &options) noexcept;
+
+/**
+    @brief Аллокатор для больших массивов (фигуры, столбцы bounding box, узлы индексов) с размещением по узлам
+
+    С настройками по умолчанию ведёт себя как std::allocator. Иначе память берётся страницами через mmap,
+    размещается по узлам согласно Placement и при необходимости подкрепляется большими страницами.
+    Вложенные аллокации элементов (например, вершины Polygon внутри Shape) идут своим аллокатором.
+*/
+template <typename T>
+class NumaAllocator {
+public:
+    using value_type = T;
+
+    NumaAllocator() noexcept = default;
+    explicit NumaAllocator(const MemoryOptions &options) noexcept : options_(options) {}
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U> &other) noexcept : options_(other.Options()) {}
+
+    [[nodiscard]] T *allocate(size_t n) {
+        if (UsesStdAllocator()) {
+            return std::allocator<T>{}.allocate(n);
+        }
+        void *pointer = AllocatePages(n * sizeof(T), options_);
+        if (pointer == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(pointer);
+    }
+
+    void deallocate(T *pointer, size_t n) noexcept {
+        if (UsesStdAllocator()) {
+            std::allocator<T>{}.deallocate(pointer, n);
+        } else {
+            FreePages(pointer, n * sizeof(T), options_);
+        }
+    }
+
+    [[nodiscard]] const MemoryOptions &Options() const noexcept { return options_; }
+
+    template <typename U>
+    [[nodiscard]] bool operator==(const NumaAllocator<U> &other) const noexcept {
+        return options_ == other.Options();
+    }
+
+private:
+    [[nodiscard]] bool UsesStdAllocator() const noexcept {
+        return options_.placement == Placement::Default && options_.huge_pages == HugePages::None;
+    }
+
+    MemoryOptions options_;
+};
+
+template <typename T>
+using NumaVector = std::vector<T, NumaAllocator<T>>;
+
+/**
+    @brief Копии редко изменяемой структуры (индекса) по одной на узел
+
+    Каждая копия строится в потоке, закреплённом за своим узлом, поэтому её память первой трогается
+    именно там и попадает на этот узел без специальных аллокаторов. Local() отдаёт копию узла
+    вызывающего потока: чтение индекса не ходит в память соседнего сокета.
+*/
+template <typename T>
+class NodeReplicas {
+public:
+    // build(node) вызывается по разу для каждого узла в потоке, закреплённом за этим узлом
+    template <typename Build>
+    explicit NodeReplicas(Build &&build) : replicas_(NodeCount()) {
+        std::vector<std::exception_ptr> errors(replicas_.size());
+        {
+            std::vector<std::jthread> builders;
+            builders.reserve(replicas_.size());
+            for (size_t node = 0; node < replicas_.size(); ++node) {
+                builders.emplace_back([&, node] {
+                    try {
+                        PinCurrentThreadToNode(node);
+                        replicas_[node] = std::make_unique<T>(build(node));
+                    } catch (...) {
+                        errors[node] = std::current_exception();
+                    }
+                });
+            }
+        }
+        for (const auto &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    [[nodiscard]] const T &Local() const { return OnNode(CurrentNode()); }
+    [[nodiscard]] const T &OnNode(size_t node) const { return *replicas_[node < replicas_.size() ? node : 0]; }
+    [[nodiscard]] size_t Count() const noexcept { return replicas_.size(); }
+
+private:
+    std::vector<std::unique_ptr<T>> replicas_;
+};
+
+}  // namespace geometry::numa
@@ -0,0 +1,93 @@
+#pragma once
+#include "geometry.hpp"
+#include "spatial_join.hpp"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace geometry::collision {
+
+using join::IndexPair;
+
+struct PairCacheOptions {
+    double cell_size = 0.0;  // Шаг сетки широкой фазы; 0 — по среднему размеру фигур первого кадра
+    size_t threads = 0;      // 0 — по числу аппаратных потоков
+};
+
+// Что пришлось сделать за кадр
+struct PairCacheStats {
+    size_t pairs = 0;         // Пар с пересекающимися bounding box после кадра
+    size_t rechecked = 0;     // Пар, у которых сдвинулась хотя бы одна фигура
+    size_t warm_started = 0;  // Из них решено по сохранённой оси или точке контакта без узкой фазы
+    size_t narrow_phase = 0;  // Из них прошло полную проверку пересечения
+};
+
+/**
+    @brief Кеш пар фигур между кадрами с учётом временной когерентности
+
+    Широкая фаза — хеш-сетка, в которой перекладываются только сдвинувшиеся фигуры. Пары, где не сдвинулась
+    ни одна фигура, не пересчитываются вовсе. Для остальных сначала пробуется результат прошлого кадра:
+    если сохранённая разделяющая ось всё ещё разделяет проекции фигур, они не пересекаются; если сохранённая
+    общая точка всё ещё лежит в обеих, они пересекаются. Лишь когда ни то ни другое не подтвердилось,
+    выполняется точная проверка queries::ShapesIntersect и заново ищутся ось или точка контакта.
+    Так стоимость кадра в установившемся режиме пропорциональна движению, а не числу фигур.
+*/
+class PairCache {
+public:
+    explicit PairCache(const PairCacheOptions &options = {});
+
+    /**
+        @brief Обновляет кеш для нового кадра
+
+        moved — индексы фигур, изменившихся с прошлого кадра. Если число фигур изменилось, кеш
+        перестраивается целиком, как при первом вызове.
+    */
+    PairCacheStats Update(std::span<const Shape> shapes, std::span<const size_t> moved);
+    // Полный пересчёт: все фигуры считаются сдвинувшимися
+    PairCacheStats Rebuild(std::span<const Shape> shapes);
+
+    // Пересекающиеся пары (i < j) по состоянию последнего кадра, упорядочены
+    [[nodiscard]] std::vector<IndexPair> Collisions() const;
+    [[nodiscard]] size_t PairCount() const noexcept { return pairs_.size(); }
+    void Clear();
+
+private:
+    struct PairState {
+        bool colliding = false;
+        std::optional<Point2D> axis;     // Ось, на которой проекции фигур не перекрывались
+        std::optional<Point2D> contact;  // Точка, лежавшая в обеих фигурах
+    };
+    struct CellSpan {
+        int64_t x0 = 0, y0 = 0, x1 = -1, y1 = -1;  // Пустой диапазон — фигуры нет в сетке
+    };
+
+    [[nodiscard]] static uint64_t PairKey(size_t i, size_t j) noexcept {
+        return (static_cast<uint64_t>(i) << 32) | static_cast<uint64_t>(j);
+    }
+    [[nodiscard]] static uint64_t CellKey(int64_t x, int64_t y) noexcept {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    [[nodiscard]] CellSpan CellsOf(const BoundingBox &box) const noexcept;
+    void Place(size_t shape, const BoundingBox &box);
+    void Unplace(size_t shape);
+    // Фигуры, чьи bounding box пересекают box фигуры shape (без неё самой)
+    [[nodiscard]] std::vector<size_t> Candidates(size_t shape);
+
+    PairCacheOptions options_;
+    double cell_size_ = 0.0;
+
+    std::vector<BoundingBox> boxes_;
+    std::vector<CellSpan> spans_;
+    std::vector<size_t> oversized_;  // Фигуры, покрывающие слишком много ячеек, проверяются отдельно
+    std::unordered_map<uint64_t, std::vector<size_t>> cells_;
+    std::vector<uint64_t> seen_;  // Метки обхода для отсечения повторов кандидатов
+    uint64_t stamp_ = 0;
+
+    std::unordered_map<uint64_t, PairState> pairs_;
+    std::vector<std::vector<size_t>> partners_;
+};
+
+}  // namespace geometry::collision
@@ -0,0 +1,56 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace geometry::parallel {
+
+// 0 означает «по числу аппаратных потоков»
+[[nodiscard]] inline size_t ResolveThreadCount(size_t requested) noexcept {
+    if (requested != 0) {
+        return requested;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+    @brief Параллельно обрабатывает диапазон [0, count) блоками по grain элементов
+
+    Блоки раздаются динамически через атомарный счётчик, поэтому неравномерная нагрузка балансируется сама.
+    body вызывается как body(begin, end, worker), где worker — номер потока в [0, threads),
+    что позволяет писать результаты в буферы отдельных потоков без синхронизации.
+*/
+template <typename Body>
+void ParallelFor(size_t count, size_t grain, Body &&body, size_t threads = 0) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    const size_t blocks = (count + grain - 1) / grain;
+    threads = std::min(ResolveThreadCount(threads), blocks);
+
+    if (threads == 1) {
+        body(size_t{0}, count, size_t{0});
+        return;
+    }
+
+    std::atomic<size_t> next_block{0};
+    auto worker = [&](size_t worker_index) {
+        for (size_t block = next_block.fetch_add(1, std::memory_order_relaxed); block < blocks;
+             block = next_block.fetch_add(1, std::memory_order_relaxed)) {
+            const size_t begin = block * grain;
+            body(begin, std::min(begin + grain, count), worker_index);
+        }
+    };
+
+    std::vector<std::jthread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+}
+
+}  // namespace geometry::parallel
@@ -0,0 +1,134 @@
+#pragma once
+#include "geometry.hpp"
+#include "spatial_join.hpp"
+#include <array>
+#include <expected>
+#include <format>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace geometry::planner {
+
+using join::IndexPair;
+
+// Дешёвые статистики набора, по которым выбирается алгоритм; размеры считаются по выборке
+struct DataStats {
+    // Корзины гистограммы размеров: степени двойки относительно медианы, от <1/8 до >=8 медиан
+    static constexpr size_t HISTOGRAM_BINS = 8;
+
+    size_t count = 0;
+    size_t sampled = 0;
+    BoundingBox extent;
+    double median_size = 0.0;  // Медиана max(ширина, высота) bounding box
+    double p90_size = 0.0;
+    double max_size = 0.0;
+    // Доля «пустоты» грубой сетки относительно равномерного набора: 0 — равномерно, ближе к 1 — скопления
+    double clustering = 0.0;
+    std::array<size_t, HISTOGRAM_BINS> size_histogram{};
+
+    // Насколько крупные объекты больше типичных
+    [[nodiscard]] double SizeSkew() const noexcept { return median_size > 0.0 ? p90_size / median_size : 1.0; }
+};
+
+[[nodiscard]] DataStats CollectStats(std::span<const BoundingBox> boxes);
+
+enum class BroadPhase {
+    BruteForce,  // Все пары подряд — для нескольких сотен объектов быстрее любой структуры
+    HashGrid,    // Равномерная сетка index::GridIndex
+    Bvh,         // Дерево index::WideBvh — устойчиво к разбросу размеров и скоплениям
+};
+
+enum class HullAlgorithm {
+    GrahamScan,      // Сразу Грэхем по всем точкам
+    AklToussaint,    // Отбрасывание точек внутри восьмиугольника крайних точек, затем Грэхем
+    ParallelChunks,  // Оболочки кусков параллельно, затем оболочка их вершин
+};
+
+struct PlannerOptions {
+    size_t threads = 0;  // Верхняя граница числа потоков; 0 — по числу аппаратных потоков
+};
+
+struct CollisionPlan {
+    BroadPhase engine = BroadPhase::BruteForce;
+    double cell_size = 0.0;  // Шаг сетки для HashGrid
+    size_t leaf_size = 0;    // Объектов в листе для Bvh
+    size_t threads = 1;
+    DataStats stats;
+    std::string reason;  // Почему выбран именно этот вариант
+};
+
+struct JoinPlan {
+    join::JoinOptions options;
+    DataStats a_stats, b_stats;
+    std::string reason;
+};
+
+struct HullPlan {
+    HullAlgorithm algorithm = HullAlgorithm::GrahamScan;
+    size_t threads = 1;
+    size_t count = 0;
+    double filter_survivors = 1.0;  // Доля выборки, пережившая отсев Акла–Туссена
+    std::string reason;
+};
+
+[[nodiscard]] CollisionPlan PlanCollisions(std::span<const BoundingBox> boxes, const PlannerOptions &options = {});
+[[nodiscard]] JoinPlan PlanJoin(std::span<const BoundingBox> a, std::span<const BoundingBox> b, bool exact = false,
+                                const PlannerOptions &options = {});
+[[nodiscard]] HullPlan PlanHull(std::span<const Point2D> points, const PlannerOptions &options = {});
+
+// Пересекающиеся пары (i < j) по заданному плану; результат упорядочен
+[[nodiscard]] std::vector<IndexPair> FindCollisions(std::span<const Shape> shapes, const CollisionPlan &plan);
+// То же с планом, выбранным по данным; выбранный план записывается в chosen, если он передан
+[[nodiscard]] std::vector<IndexPair> FindCollisions(std::span<const Shape> shapes, CollisionPlan *chosen = nullptr);
+
+[[nodiscard]] std::vector<IndexPair> SpatialJoin(std::span<const Shape> a, std::span<const Shape> b, bool exact = false,
+                                                 JoinPlan *chosen = nullptr);
+
+[[nodiscard]] std::expected<std::vector<Point2D>, std::string> ConvexHull(std::span<const Point2D> points,
+                                                                         const HullPlan &plan);
+[[nodiscard]] std::expected<std::vector<Point2D>, std::string> ConvexHull(std::span<const Point2D> points,
+                                                                         HullPlan *chosen = nullptr);
+
+[[nodiscard]] std::string_view ToString(BroadPhase engine) noexcept;
+[[nodiscard]] std::string_view ToString(join::JoinStrategy strategy) noexcept;
+[[nodiscard]] std::string_view ToString(HullAlgorithm algorithm) noexcept;
+
+}  // namespace geometry::planner
+
+template <>
+struct std::formatter<geometry::planner::CollisionPlan> {
+    constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
+
+    template <typename FormatContext>
+    auto format(const geometry::planner::CollisionPlan &p, FormatContext &ctx) const {
+        return std::format_to(ctx.out(), "CollisionPlan(engine={}, cell={:.3g}, leaf={}, threads={}, n={}: {})",
+                              geometry::planner::ToString(p.engine), p.cell_size, p.leaf_size, p.threads,
+                              p.stats.count, p.reason);
+    }
+};
+
+template <>
+struct std::formatter<geometry::planner::JoinPlan> {
+    constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
+
+    template <typename FormatContext>
+    auto format(const geometry::planner::JoinPlan &p, FormatContext &ctx) const {
+        return std::format_to(ctx.out(), "JoinPlan(strategy={}, threads={}, n={}x{}: {})",
+                              geometry::planner::ToString(p.options.strategy), p.options.threads, p.a_stats.count,
+                              p.b_stats.count, p.reason);
+    }
+};
+
+template <>
+struct std::formatter<geometry::planner::HullPlan> {
+    constexpr auto parse(std::format_parse_context &ctx) { return ctx.begin(); }
+
+    template <typename FormatContext>
+    auto format(const geometry::planner::HullPlan &p, FormatContext &ctx) const {
+        return std::format_to(ctx.out(), "HullPlan(algorithm={}, threads={}, n={}, survivors={:.2f}: {})",
+                              geometry::planner::ToString(p.algorithm), p.threads, p.count, p.filter_survivors,
+                              p.reason);
+    }
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include "geometry.hpp"
+#include "spatial_index.hpp"
+#include "triangle_mesh.hpp"
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace geometry::triangulation {
+
+/**
+    @brief Локализация точек в треугольниках сетки прыжком по грубой сетке и обходом по смежности
+
+    Каждой ячейке равномерной сетки над сеткой треугольников сопоставлен треугольник-затравка рядом с её
+    центром; от него к точке идёт обход по соседям через рёбра, отделяющие точку от текущего треугольника.
+    Пакетные запросы упорядочиваются вдоль кривой Гильберта, и обход стартует из ответа на предыдущий
+    запрос, если тот ближе затравки. Сетка треугольников должна жить дольше локатора.
+*/
+class PointLocator {
+public:
+    explicit PointLocator(const TriangleMesh &mesh);
+
+    // Треугольник, содержащий точку (граница включительно), или nullopt вне сетки
+    [[nodiscard]] std::optional<size_t> Locate(const Point2D &p) const;
+    // То же, но обход начинается с треугольника hint
+    [[nodiscard]] std::optional<size_t> Locate(const Point2D &p, size_t hint) const;
+
+    // Ответы в порядке исходных точек
+    [[nodiscard]] std::vector<std::optional<size_t>> LocateAll(std::span<const Point2D> points,
+                                                               size_t threads = 0) const;
+
+    [[nodiscard]] const TriangleMesh &Mesh() const noexcept { return *mesh_; }
+
+private:
+    [[nodiscard]] size_t CellOf(const Point2D &p) const noexcept;
+    [[nodiscard]] std::optional<size_t> Walk(const Point2D &p, size_t from) const;
+    [[nodiscard]] std::optional<size_t> Scan(const Point2D &p) const;
+
+    const TriangleMesh *mesh_;
+    BoundingBox bounds_;
+    double cell_width_ = 1.0, cell_height_ = 1.0;
+    size_t nx_ = 1, ny_ = 1;
+    std::vector<size_t> seeds_;
+
+    // У невыпуклой сетки обход может упереться в границу, не дойдя до точки; тогда кандидаты берутся из индекса
+    bool convex_ = true;
+    index::GridIndex fallback_;
+};
+
+}  // namespace geometry::triangulation
@@ -0,0 +1,20 @@
+#pragma once
+#include "geometry.hpp"
+#include <span>
+#include <vector>
+
+namespace geometry::point_set {
+
+struct WeldResult {
+    std::vector<Point2D> points;  // Уникальные представители в порядке первого появления
+    std::vector<size_t> remap;    // remap[i] — индекс представителя для исходной точки i
+};
+
+std::vector<Point2D> RemoveDuplicates(std::span<const Point2D> points);
+
+WeldResult WeldVertices(std::span<const Point2D> points, double tolerance);
+
+// Перестановка индексов вдоль кривой Гильберта: соседние в ней точки близки и на плоскости
+std::vector<size_t> HilbertOrder(std::span<const Point2D> points);
+
+}  // namespace geometry::point_set
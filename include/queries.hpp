@@ -1,8 +1,12 @@
 #pragma once
 #include "geometry.hpp"
 #include <algorithm>
+#include <limits>
 #include <optional>
+#include <span>
+#include <type_traits>
 #include <variant>
+#include <vector>
 
 namespace geometry::queries {
 
@@ -74,6 +78,22 @@ struct DistanceVisitor {
         }
         return min_distance;
     }
+    // Расстояние до ближайшего ребра любого из колец
+    double operator()(const RingSet &rings) const {
+        double min_distance = std::numeric_limits<double>::max();
+        for (size_t r = 0; r < rings.RingCount(); ++r) {
+            const auto ring = rings.Ring(r);
+            for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+                min_distance = std::min(min_distance, (*this)(Line{ring[j], ring[i]}));
+            }
+        }
+        return min_distance;
+    }
+    // Точка переводится в систему координат прототипа, расстояние масштабируется обратно
+    double operator()(const InstancedShape &instance) const {
+        const auto &transform = instance.GetTransform();
+        return transform.scale * std::visit(DistanceVisitor{transform.ApplyInverse(point)}, instance.Prototype());
+    }
 };
 
 struct PointToShapeDistanceVisitor {
@@ -144,6 +164,8 @@ struct PointToShapeDistanceVisitor {
         }
         return min_distance;
     }
+    double operator()(const RingSet &rings) const { return DistanceVisitor{point}(rings); }
+    double operator()(const InstancedShape &instance) const { return DistanceVisitor{point}(instance); }
 };
 
 struct PointInShapeVisitor {
@@ -193,8 +215,21 @@ struct PointInShapeVisitor {
 
     bool operator()(const Circle &circle) const { return point.DistanceTo(circle.center_p) <= circle.radius; }
 
+    bool operator()(const Polygon &polygon) const {
+        return polygon.BoundBox().Overlaps({point.x, point.y, point.x, point.y}) &&
+               point_in_polygon_ray_casting(point, polygon.Vertices());
+    }
+
+    bool operator()(const PolygonWithHoles &polygon) const { return polygon.Contains(point); }
+
+    bool operator()(const MultiPolygon &polygon) const { return polygon.Contains(point); }
+
+    bool operator()(const InstancedShape &instance) const {
+        return std::visit(PointInShapeVisitor{instance.GetTransform().ApplyInverse(point)}, instance.Prototype());
+    }
+
 private:
-    bool point_in_polygon_ray_casting(const Point2D &p, const std::vector<Point2D> &vertices) const {
+    bool point_in_polygon_ray_casting(const Point2D &p, std::span<const Point2D> vertices) const {
         int intersections = 0;
         size_t n = vertices.size();
 
@@ -230,6 +265,258 @@ struct ShapeToShapeDistanceVisitor {
     }
 };
 
+/*
+ * Точная проверка пересечения двух фигур (с учётом внутренней области)
+ */
+namespace detail {
+
+[[nodiscard]] inline double Orientation(const Point2D &a, const Point2D &b, const Point2D &c) noexcept {
+    return (b - a).Cross(c - a);
+}
+
+// Точка p коллинеарна отрезку [a, b] — лежит ли она внутри его габарита
+[[nodiscard]] inline bool OnSegment(const Point2D &a, const Point2D &b, const Point2D &p) noexcept {
+    return std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x) && std::min(a.y, b.y) <= p.y &&
+           p.y <= std::max(a.y, b.y);
+}
+
+// Пересекаются ли замкнутые отрезки [p1, p2] и [q1, q2], включая касание и коллинеарное наложение
+[[nodiscard]] inline bool SegmentsIntersect(const Point2D &p1, const Point2D &p2, const Point2D &q1,
+                                            const Point2D &q2) noexcept {
+    const double d1 = Orientation(q1, q2, p1);
+    const double d2 = Orientation(q1, q2, p2);
+    const double d3 = Orientation(p1, p2, q1);
+    const double d4 = Orientation(p1, p2, q2);
+
+    if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) {
+        return true;
+    }
+    return (d1 == 0 && OnSegment(q1, q2, p1)) || (d2 == 0 && OnSegment(q1, q2, p2)) ||
+           (d3 == 0 && OnSegment(p1, p2, q1)) || (d4 == 0 && OnSegment(p1, p2, q2));
+}
+
+// Вершины контура фигуры; у Line контур незамкнут, у остальных — замкнут
+template <typename T>
+[[nodiscard]] std::vector<Point2D> Outline(const T &shape) {
+    auto vertices = shape.Vertices();
+    return {vertices.begin(), vertices.end()};
+}
+
+template <typename T>
+inline constexpr bool IS_CLOSED_OUTLINE = !std::is_same_v<T, Line>;
+
+template <typename Visit>
+void ForEachEdge(std::span<const Point2D> outline, bool closed, Visit &&visit) {
+    if (outline.size() < 2) {
+        return;
+    }
+    const size_t edges = closed ? outline.size() : outline.size() - 1;
+    for (size_t i = 0; i < edges; ++i) {
+        visit(outline[i], outline[(i + 1) % outline.size()]);
+    }
+}
+
+// Расстояние от точки до рёбер контура (а не только до его вершин)
+[[nodiscard]] inline double DistanceToOutline(const Point2D &p, std::span<const Point2D> outline, bool closed) {
+    if (outline.size() == 1) {
+        return p.DistanceTo(outline.front());
+    }
+    double min_distance = std::numeric_limits<double>::max();
+    ForEachEdge(outline, closed, [&](const Point2D &a, const Point2D &b) {
+        min_distance = std::min(min_distance, DistanceVisitor{p}(Line{a, b}));
+    });
+    return min_distance;
+}
+
+// Граница фигуры как последовательность контуров: у многоугольников с дырами их несколько
+struct Boundary {
+    std::vector<Point2D> points;
+    std::vector<size_t> ring_ends;  // Конец каждого контура в points
+    bool closed = true;
+
+    template <typename Visit>
+    void ForEachEdge(Visit &&visit) const {
+        size_t begin = 0;
+        for (size_t end : ring_ends) {
+            detail::ForEachEdge(std::span(points).subspan(begin, end - begin), closed, visit);
+            begin = end;
+        }
+    }
+
+    [[nodiscard]] double DistanceTo(const Point2D &p) const {
+        double min_distance = std::numeric_limits<double>::max();
+        size_t begin = 0;
+        for (size_t end : ring_ends) {
+            if (end > begin) {
+                min_distance =
+                    std::min(min_distance, DistanceToOutline(p, std::span(points).subspan(begin, end - begin), closed));
+            }
+            begin = end;
+        }
+        return min_distance;
+    }
+
+    // Проверка первой вершины каждого контура: у составной фигуры любая часть может лежать в другой
+    template <typename Predicate>
+    [[nodiscard]] bool AnyContourStart(Predicate &&predicate) const {
+        size_t begin = 0;
+        for (size_t end : ring_ends) {
+            if (end > begin && predicate(points[begin])) {
+                return true;
+            }
+            begin = end;
+        }
+        return false;
+    }
+};
+
+template <typename T>
+concept NotInstanced = !std::is_same_v<T, InstancedShape>;
+
+// Фигура в системе координат прототипа экземпляра: преобразование подобия сохраняет пересечения,
+// а расстояния меняет ровно в scale раз
+template <typename T>
+[[nodiscard]] PrototypeShape InPrototypeSpace(const InstancedShape &instance, const T &shape) {
+    const Transform2D to_prototype = instance.GetTransform().Inverse();
+    if constexpr (std::is_same_v<T, InstancedShape>) {
+        return Transformed(shape.Prototype(), shape.GetTransform().Then(to_prototype));
+    } else {
+        return Transformed(shape, to_prototype);
+    }
+}
+
+template <typename T>
+[[nodiscard]] Boundary ShapeBoundary(const T &shape) {
+    if constexpr (std::is_base_of_v<RingSet, T>) {
+        Boundary boundary{{shape.Vertices().begin(), shape.Vertices().end()}, {}, true};
+        size_t end = 0;
+        for (size_t r = 0; r < shape.RingCount(); ++r) {
+            end += shape.Ring(r).size();
+            boundary.ring_ends.push_back(end);
+        }
+        return boundary;
+    } else {
+        auto outline = Outline(shape);
+        const size_t size = outline.size();
+        return {std::move(outline), {size}, IS_CLOSED_OUTLINE<T>};
+    }
+}
+
+}  // namespace detail
+
+struct ShapesIntersectVisitor {
+    bool operator()(const Circle &c1, const Circle &c2) const {
+        return c1.center_p.DistanceTo(c2.center_p) <= c1.radius + c2.radius;
+    }
+
+    template <detail::NotInstanced T>
+    bool operator()(const Circle &circle, const T &shape) const {
+        if constexpr (detail::IS_CLOSED_OUTLINE<T>) {
+            if (PointInShapeVisitor{circle.center_p}(shape)) {
+                return true;
+            }
+        }
+        return detail::ShapeBoundary(shape).DistanceTo(circle.center_p) <= circle.radius;
+    }
+
+    template <detail::NotInstanced T>
+    bool operator()(const T &shape, const Circle &circle) const {
+        return (*this)(circle, shape);
+    }
+
+    template <typename T>
+    bool operator()(const InstancedShape &instance, const T &shape) const {
+        return std::visit(*this, instance.Prototype(), detail::InPrototypeSpace(instance, shape));
+    }
+
+    template <detail::NotInstanced T>
+    bool operator()(const T &shape, const InstancedShape &instance) const {
+        return (*this)(instance, shape);
+    }
+
+    template <typename T, typename U>
+    bool operator()(const T &s1, const U &s2) const {
+        const auto boundary1 = detail::ShapeBoundary(s1);
+        const auto boundary2 = detail::ShapeBoundary(s2);
+
+        bool crossing = false;
+        boundary1.ForEachEdge([&](const Point2D &a, const Point2D &b) {
+            boundary2.ForEachEdge([&](const Point2D &c, const Point2D &d) {
+                crossing = crossing || detail::SegmentsIntersect(a, b, c, d);
+            });
+        });
+        if (crossing) {
+            return true;
+        }
+
+        // Границы не пересекаются — значит, каждая часть фигуры либо целиком внутри другой, либо целиком вне
+        if constexpr (detail::IS_CLOSED_OUTLINE<U>) {
+            if (boundary1.AnyContourStart([&s2](const Point2D &p) { return PointInShapeVisitor{p}(s2); })) {
+                return true;
+            }
+        }
+        if constexpr (detail::IS_CLOSED_OUTLINE<T>) {
+            if (boundary2.AnyContourStart([&s1](const Point2D &p) { return PointInShapeVisitor{p}(s1); })) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/*
+ * Точное расстояние между двумя фигурами (0, если фигуры пересекаются)
+ */
+struct ExactDistanceVisitor {
+    double operator()(const Circle &c1, const Circle &c2) const {
+        return std::max(0.0, c1.center_p.DistanceTo(c2.center_p) - c1.radius - c2.radius);
+    }
+
+    template <detail::NotInstanced T>
+    double operator()(const Circle &circle, const T &shape) const {
+        if constexpr (detail::IS_CLOSED_OUTLINE<T>) {
+            if (PointInShapeVisitor{circle.center_p}(shape)) {
+                return 0.0;
+            }
+        }
+        return std::max(0.0, detail::ShapeBoundary(shape).DistanceTo(circle.center_p) - circle.radius);
+    }
+
+    template <detail::NotInstanced T>
+    double operator()(const T &shape, const Circle &circle) const {
+        return (*this)(circle, shape);
+    }
+
+    template <typename T>
+    double operator()(const InstancedShape &instance, const T &shape) const {
+        return instance.GetTransform().scale *
+               std::visit(*this, instance.Prototype(), detail::InPrototypeSpace(instance, shape));
+    }
+
+    template <detail::NotInstanced T>
+    double operator()(const T &shape, const InstancedShape &instance) const {
+        return (*this)(instance, shape);
+    }
+
+    template <typename T, typename U>
+    double operator()(const T &s1, const U &s2) const {
+        if (ShapesIntersectVisitor{}(s1, s2)) {
+            return 0.0;
+        }
+        // Контуры не пересекаются, поэтому минимум достигается на вершине одного из них
+        const auto boundary1 = detail::ShapeBoundary(s1);
+        const auto boundary2 = detail::ShapeBoundary(s2);
+        double min_distance = std::numeric_limits<double>::max();
+        for (const auto &p : boundary1.points) {
+            min_distance = std::min(min_distance, boundary2.DistanceTo(p));
+        }
+        for (const auto &p : boundary2.points) {
+            min_distance = std::min(min_distance, boundary1.DistanceTo(p));
+        }
+        return min_distance;
+    }
+};
+
 /*
  * Функции-помощники
  */
@@ -251,6 +538,21 @@ struct ShapeToShapeDistanceVisitor {
     return bb1.Overlaps(bb2);
 }
 
+[[nodiscard]] inline bool ShapesIntersect(const Shape &shape1, const Shape &shape2) {
+    return BoundingBoxesOverlap(shape1, shape2) && std::visit(ShapesIntersectVisitor{}, shape1, shape2);
+}
+
+[[nodiscard]] inline double ExactDistanceBetweenShapes(const Shape &shape1, const Shape &shape2) {
+    return std::visit(ExactDistanceVisitor{}, shape1, shape2);
+}
+
+// Евклидово расстояние между прямоугольниками (0, если они перекрываются)
+[[nodiscard]] inline double BoundingBoxDistance(const BoundingBox &a, const BoundingBox &b) noexcept {
+    const double dx = std::max({0.0, a.min_x - b.max_x, b.min_x - a.max_x});
+    const double dy = std::max({0.0, a.min_y - b.max_y, b.min_y - a.max_y});
+    return std::sqrt(dx * dx + dy * dy);
+}
+
 [[nodiscard]] inline std::optional<double> DistanceBetweenShapes(const Shape &shape1, const Shape &shape2) {
     return std::visit(ShapeToShapeDistanceVisitor{}, shape1, shape2);
 }
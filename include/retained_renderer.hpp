@@ -0,0 +1,87 @@
+#pragma once
+#include "geometry.hpp"
+#include "image.hpp"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace geometry::visualization {
+
+struct RenderOptions {
+    BoundingBox view{-6, -6, 15, 15};  // Видимая область мира, как у Draw
+    size_t width = 900, height = 900;
+    size_t line_width = 2;  // Толщина контура в пикселях
+    Rgb background{255, 255, 255};
+    size_t tile_size = 64;  // Сторона ячейки индекса фигур в пикселях
+    size_t threads = 0;     // 0 — по числу аппаратных потоков
+};
+
+// Что пришлось перерисовать за вызов Render
+struct RenderStats {
+    size_t regions = 0;  // Непересекающихся повреждённых прямоугольников
+    size_t shapes = 0;   // Растеризаций фигур (фигура на стыке регионов считается в каждом)
+    size_t pixels = 0;   // Пикселей, залитых фоном и нарисованных заново
+};
+
+/**
+    @brief Отрисовка с сохранением кадра: после правки перерисовывается только испорченная часть
+
+    Фигуры рисуются контурами цветами Draw в порядке идентификаторов. Каждая правка (Add, Update, Remove)
+    портит пиксельный прямоугольник старого и нового положения фигуры с учётом толщины линии. Прямоугольники
+    сливаются, пока не перестанут пересекаться, так что каждый пиксель перерисовывается не больше раза.
+    Render заливает каждый прямоугольник фоном и растеризует заново только фигуры, которые его задевают:
+    их ищет сетка ячеек tile_size × tile_size пикселей, где фигура лежит во всех ячейках своего прямоугольника.
+    Запись обрезается прямоугольником, а пиксели контура не зависят от обрезки, поэтому кадр совпадает
+    с полной перерисовкой. Прямоугольники не пересекаются и обрабатываются параллельно.
+*/
+class RetainedRenderer {
+public:
+    explicit RetainedRenderer(const RenderOptions &options = {});
+
+    // Возвращает идентификатор фигуры; идентификаторы удалённых фигур не переиспользуются
+    size_t Add(Shape shape);
+    void Update(size_t id, Shape shape);
+    void Remove(size_t id);
+
+    // Перерисовать область мира при следующем Render, например после смены цветовой схемы
+    void Invalidate(const BoundingBox &box);
+    void InvalidateAll();
+
+    RenderStats Render();
+
+    [[nodiscard]] const Image &Frame() const noexcept { return image_; }
+    [[nodiscard]] bool HasDamage() const noexcept { return !damage_.empty(); }
+    [[nodiscard]] const RenderOptions &Options() const noexcept { return options_; }
+
+private:
+    // Полуоткрытый прямоугольник пикселей [x0, x1) × [y0, y1)
+    struct PixelRect {
+        size_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+        [[nodiscard]] bool Empty() const noexcept { return x0 >= x1 || y0 >= y1; }
+        [[nodiscard]] size_t Area() const noexcept { return Empty() ? 0 : (x1 - x0) * (y1 - y0); }
+        [[nodiscard]] bool Overlaps(const PixelRect &other) const noexcept {
+            return x0 < other.x1 && other.x0 < x1 && y0 < other.y1 && other.y0 < y1;
+        }
+    };
+
+    [[nodiscard]] PixelRect ToPixels(const BoundingBox &box) const noexcept;
+    void Damage(PixelRect rect);
+    void Place(size_t id);
+    void Unplace(size_t id);
+    // Фигуры, задевающие прямоугольник, по возрастанию идентификатора
+    [[nodiscard]] std::vector<size_t> Candidates(const PixelRect &rect) const;
+    void Rasterize(const Shape &shape, const PixelRect &clip);
+
+    RenderOptions options_;
+    Image image_;
+
+    std::vector<std::optional<Shape>> shapes_;
+    std::vector<PixelRect> footprints_;  // Пиксели, которые фигура может закрасить; пустой — вне кадра
+    size_t tiles_x_ = 0, tiles_y_ = 0;
+    std::vector<std::vector<size_t>> tiles_;
+
+    std::vector<PixelRect> damage_;
+};
+
+}  // namespace geometry::visualization
@@ -0,0 +1,121 @@
+#pragma once
+#include "geometry.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace geometry::sampling {
+
+/**
+    @brief Счётчиковый генератор: число номер counter — хеш пары (seed, counter)
+
+    Это SplitMix64, у которого состояние вычисляется по номеру, а не хранится: значение с любым номером
+    получается за несколько умножений без предыдущих. Поэтому потоки могут брать любые номера в любом
+    порядке, а результат зависит только от seed и номера, но не от числа потоков и разбиения работы.
+*/
+class CounterRng {
+public:
+    constexpr explicit CounterRng(uint64_t seed) noexcept : key_(Mix(seed)) {}
+
+    [[nodiscard]] constexpr uint64_t Bits(uint64_t counter) const noexcept { return Mix(key_ + counter * GAMMA); }
+    // Равномерно в [0, 1) с шагом 2^-53
+    [[nodiscard]] constexpr double Uniform(uint64_t counter) const noexcept {
+        return static_cast<double>(Bits(counter) >> 11) * 0x1.0p-53;
+    }
+
+private:
+    static constexpr uint64_t GAMMA = 0x9E3779B97F4A7C15ull;
+
+    [[nodiscard]] static constexpr uint64_t Mix(uint64_t z) noexcept {
+        z += GAMMA;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t key_;
+};
+
+/**
+    @brief Таблица псевдонимов Уокера–Воуза: выбор i с вероятностью weights[i] / сумма за O(1)
+
+    Каждая из n ячеек хранит порог и запасной индекс: выбирается случайная ячейка, затем по порогу —
+    она сама или её псевдоним. Нулевые и отрицательные веса никогда не выбираются; если все веса нулевые,
+    выбор равномерный.
+*/
+class AliasTable {
+public:
+    AliasTable() = default;
+    explicit AliasTable(std::span<const double> weights);
+
+    // slot и coin — независимые равномерные числа из [0, 1)
+    [[nodiscard]] size_t Sample(double slot, double coin) const noexcept {
+        const size_t i = std::min(static_cast<size_t>(slot * static_cast<double>(threshold_.size())),
+                                  threshold_.size() - 1);
+        return coin < threshold_[i] ? i : alias_[i];
+    }
+    [[nodiscard]] size_t Size() const noexcept { return threshold_.size(); }
+
+private:
+    std::vector<double> threshold_;
+    std::vector<uint32_t> alias_;
+};
+
+enum class Region {
+    Interior,  // Равномерно по площади; у отрезка — по длине
+    Boundary,  // Равномерно по длине контура, включая контуры дыр
+};
+
+/**
+    @brief Равномерные точки внутри или на границе фигуры без отбраковки
+
+    При построении фигура сводится к примитивам, из которых точка берётся напрямую: треугольник —
+    барицентрически (отражение квадрата единичного размера), круг — радиусом R·sqrt(u), отрезок и окружность —
+    по параметру. Примитив выбирается таблицей псевдонимов с весами-площадями или длинами.
+    Простой многоугольник триангулируется отсечением ушей; кольца с дырами, самопересекающиеся
+    многоугольники и те, что не удалось триангулировать, режутся горизонтальными полосами на трапеции.
+    Правило заливки то же, что у PointInShapeVisitor: ненулевое число оборотов для колец с дырами,
+    чётность пересечений для Polygon (у пентаграммы центр снаружи). Экземпляр сэмплирует прототип
+    и применяет преобразование: подобие сохраняет равномерность.
+
+    Точка номер index использует номера генератора [4 * index, 4 * index + 4), поэтому Fill даёт
+    одинаковый результат при любом числе потоков, а пакеты с разными first не пересекаются.
+    Фигура нулевой площади сэмплируется по границе.
+*/
+class ShapeSampler {
+public:
+    explicit ShapeSampler(const Shape &shape, Region region = Region::Interior);
+
+    [[nodiscard]] Point2D Sample(const CounterRng &rng, uint64_t index) const noexcept;
+    // Точки first, first + 1, ... в xs и ys; размеры xs и ys должны совпадать
+    void Fill(const CounterRng &rng, uint64_t first, std::span<double> xs, std::span<double> ys,
+              size_t threads = 0) const;
+
+    // Площадь или длина, по которой идёт выбор
+    [[nodiscard]] double Measure() const noexcept { return measure_; }
+    [[nodiscard]] size_t PrimitiveCount() const noexcept { return origin_.size(); }
+
+private:
+    enum class Kind { Triangles, Segments, Disk, Circle };
+    enum class FillRule { NonZero, EvenOdd };
+
+    template <typename T>
+    void Build(const T &shape, Region region);
+    void AddTriangle(Point2D a, Point2D b, Point2D c);
+    void AddSegment(Point2D a, Point2D b);
+    void AddRingEdges(std::span<const Point2D> ring);
+    // Трапеции полос между соседними различными y вершин; rings — набор колец одной фигуры
+    void AddSlabs(std::span<const std::span<const Point2D>> rings, FillRule rule);
+    void Finish();
+
+    Kind kind_ = Kind::Triangles;
+    // Треугольник: origin + u * first + v * second; отрезок: origin + t * first; круг: центр origin, радиус first.x
+    std::vector<Point2D> origin_, first_, second_;
+    std::vector<double> weights_;
+    AliasTable table_;
+    Transform2D transform_;
+    double measure_ = 0.0;
+};
+
+}  // namespace geometry::sampling
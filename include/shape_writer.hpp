@@ -0,0 +1,37 @@
+#pragma once
+#include "geometry.hpp"
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace geometry::utils {
+
+/**
+    @brief Запись фигур в текстовом формате ParseShapes
+
+    Фигура — строка вида «circle 1.5 -2 0.25;». Числа пишутся std::to_chars в кратчайшем виде, который
+    читается обратно ровно в то же значение, поэтому ParseShapes восстанавливает фигуры без потерь.
+    Формат ParseShapes знает только отрезки, треугольники, прямоугольники, правильные многоугольники и
+    круги; остальные фигуры считаются ошибкой. Ошибка и фигура, которую разбор отбросил бы: нечисловые
+    координаты, неположительные радиус или стороны прямоугольника, меньше трёх сторон многоугольника.
+
+    Фигуры режутся на блоки, каждый блок пишется своим потоком в собственный буфер, затем буферы
+    параллельно копируются в общий. Все буферы принадлежат объекту и только растут, так что повторная
+    выгрузка сопоставимого объёма не выделяет память.
+*/
+class ShapeWriter {
+public:
+    explicit ShapeWriter(size_t threads = 0) : threads_(threads) {}
+
+    // Текст действителен до следующего вызова Write
+    [[nodiscard]] std::expected<std::string_view, std::string> Write(std::span<const Shape> shapes);
+
+private:
+    size_t threads_;
+    std::vector<std::string> chunks_;
+    std::string buffer_;
+};
+
+}  // namespace geometry::utils
@@ -0,0 +1,28 @@
+#pragma once
+#include "geometry.hpp"
+#include <optional>
+#include <span>
+
+namespace geometry::similarity {
+
+/*
+ * Меры сходства ломаных и контуров по их вершинам. Для пустого набора вершин расстояние — бесконечность.
+ * Вершины фигур передаются напрямую: HausdorffDistance(polygon.Vertices(), triangle.Vertices()).
+ */
+
+// max по a от расстояния до ближайшей вершины b
+double DirectedHausdorff(std::span<const Point2D> a, std::span<const Point2D> b);
+
+double HausdorffDistance(std::span<const Point2D> a, std::span<const Point2D> b);
+
+// Расстояние Хаусдорфа, если оно не больше threshold; иначе вычисление прерывается и возвращается nullopt
+std::optional<double> HausdorffDistanceWithin(std::span<const Point2D> a, std::span<const Point2D> b,
+                                              double threshold);
+
+double DiscreteFrechetDistance(std::span<const Point2D> a, std::span<const Point2D> b);
+
+// Дискретное расстояние Фреше, если оно не больше threshold; иначе nullopt без досчёта всей таблицы
+std::optional<double> DiscreteFrechetDistanceWithin(std::span<const Point2D> a, std::span<const Point2D> b,
+                                                    double threshold);
+
+}  // namespace geometry::similarity
@@ -0,0 +1,85 @@
+#pragma once
+#include "geometry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <vector>
+
+namespace geometry::index {
+
+/**
+    @brief Равномерная сетка над ограничивающими прямоугольниками
+
+    Ячейки хранятся в CSR-виде (смещения + общий массив индексов), поэтому построение — два линейных прохода
+    без аллокаций на ячейку. Объект, покрывающий несколько ячеек, при запросе сообщается ровно один раз:
+    только из ячейки, содержащей левый нижний угол пересечения его ячеек с ячейками запроса.
+    Структура неизменяема после построения, поэтому Query можно вызывать из нескольких потоков.
+*/
+class GridIndex {
+public:
+    GridIndex() = default;
+    // cell_size <= 0 — подобрать шаг автоматически по размерам и количеству прямоугольников
+    explicit GridIndex(std::span<const BoundingBox> boxes, double cell_size = 0.0);
+
+    template <typename Visit>
+    void Query(const BoundingBox &box, Visit &&visit) const {
+        if (boxes_.empty() || !box.Overlaps(bounds_)) {
+            return;
+        }
+        const auto [qx0, qy0, qx1, qy1] = CellRange(box);
+
+        for (size_t cy = qy0; cy <= qy1; ++cy) {
+            for (size_t cx = qx0; cx <= qx1; ++cx) {
+                const size_t cell = cy * nx_ + cx;
+                for (size_t k = offsets_[cell]; k < offsets_[cell + 1]; ++k) {
+                    const size_t item = items_[k];
+                    const BoundingBox &item_box = boxes_[item];
+                    if (!item_box.Overlaps(box)) {
+                        continue;
+                    }
+                    // Отсечение дубликатов по опорной ячейке
+                    const auto [ix0, iy0, ix1, iy1] = CellRange(item_box);
+                    if (cx == std::max(ix0, qx0) && cy == std::max(iy0, qy0)) {
+                        visit(item);
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::vector<size_t> Query(const BoundingBox &box) const;
+
+    [[nodiscard]] size_t Size() const noexcept { return boxes_.size(); }
+    [[nodiscard]] const BoundingBox &Box(size_t i) const noexcept { return boxes_[i]; }
+    [[nodiscard]] const BoundingBox &Bounds() const noexcept { return bounds_; }
+    [[nodiscard]] double CellSize() const noexcept { return cell_size_; }
+
+private:
+    struct CellRect {
+        size_t x0, y0, x1, y1;
+    };
+
+    [[nodiscard]] size_t CellX(double x) const noexcept {
+        const double c = std::floor((x - bounds_.min_x) / cell_size_);
+        return static_cast<size_t>(std::clamp(c, 0.0, static_cast<double>(nx_ - 1)));
+    }
+    [[nodiscard]] size_t CellY(double y) const noexcept {
+        const double c = std::floor((y - bounds_.min_y) / cell_size_);
+        return static_cast<size_t>(std::clamp(c, 0.0, static_cast<double>(ny_ - 1)));
+    }
+    [[nodiscard]] CellRect CellRange(const BoundingBox &box) const noexcept {
+        return {CellX(box.min_x), CellY(box.min_y), CellX(box.max_x), CellY(box.max_y)};
+    }
+
+    std::vector<BoundingBox> boxes_;
+    std::vector<size_t> offsets_;
+    std::vector<size_t> items_;
+    BoundingBox bounds_;
+    double cell_size_ = 1.0;
+    size_t nx_ = 1, ny_ = 1;
+};
+
+// Общий прямоугольник для набора прямоугольников
+[[nodiscard]] BoundingBox UnionBox(std::span<const BoundingBox> boxes);
+
+}  // namespace geometry::index
@@ -0,0 +1,46 @@
+#pragma once
+#include "geometry.hpp"
+#include <functional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace geometry::join {
+
+using IndexPair = std::pair<size_t, size_t>;
+
+enum class JoinStrategy {
+    Auto,             // Выбор по соотношению размеров наборов
+    IndexNestedLoop,  // Индекс по меньшему набору, параллельный обход большего
+    Partition,        // Общая сетка разбиения, плоское заметание внутри каждой ячейки
+};
+
+struct JoinOptions {
+    JoinStrategy strategy = JoinStrategy::Auto;
+    bool exact = false;  // Уточнять пары точной проверкой пересечения фигур, а не только их bounding box
+    size_t threads = 0;  // 0 — по числу аппаратных потоков
+};
+
+// Пары (i, j), где a[i] и b[j] пересекаются; результат упорядочен по (i, j)
+std::vector<IndexPair> SpatialJoin(std::span<const Shape> a, std::span<const Shape> b, const JoinOptions &options = {});
+
+// Приёмник пар: вызывается пачками из рабочих потоков, но никогда одновременно
+using PairSink = std::function<void(std::span<const IndexPair>)>;
+
+struct DistanceJoinOptions {
+    size_t threads = 0;        // 0 — по числу аппаратных потоков
+    size_t batch_size = 4096;  // Сколько пар поток копит перед передачей в приёмник
+};
+
+// Передаёт в sink все пары (i, j), где точное расстояние между a[i] и b[j] не больше distance; порядок не определён
+void DistanceJoin(std::span<const Shape> a, std::span<const Shape> b, double distance, const PairSink &sink,
+                  const DistanceJoinOptions &options = {});
+
+// То же, но собирает пары в вектор, упорядоченный по (i, j)
+std::vector<IndexPair> DistanceJoin(std::span<const Shape> a, std::span<const Shape> b, double distance,
+                                    const DistanceJoinOptions &options = {});
+
+// Стратегия, которую выберет JoinStrategy::Auto для наборов заданных размеров
+JoinStrategy ChooseJoinStrategy(size_t a_size, size_t b_size) noexcept;
+
+}  // namespace geometry::join
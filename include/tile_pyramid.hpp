@@ -0,0 +1,84 @@
+#pragma once
+#include "geometry.hpp"
+#include <compare>
+#include <cstdint>
+#include <expected>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace geometry::tiles {
+
+// Тайл (x, y) уровня zoom: мир делится на 2^zoom × 2^zoom квадратов, x растёт вправо, y — вверх
+struct TileKey {
+    uint32_t zoom = 0, x = 0, y = 0;
+
+    auto operator<=>(const TileKey &) const = default;
+};
+
+struct PyramidOptions {
+    uint32_t max_zoom = 6;
+    uint32_t extent = 4096;  // Сторона целочисленной решётки тайла
+    uint32_t buffer = 64;    // Запас вокруг тайла в единицах решётки: соседние тайлы перекрываются без швов
+    size_t threads = 0;      // 0 — по числу аппаратных потоков
+};
+
+// Фигура из тайла после декодирования; координаты в единицах решётки тайла
+struct TileFeature {
+    size_t id = 0;        // Индекс фигуры во входном наборе
+    bool closed = false;  // Кольца многоугольника или открытая ломаная
+    std::vector<std::vector<Point2D>> rings;
+};
+
+/**
+    @brief Пирамида тайлов для просмотра сцены с масштабированием
+
+    На каждом уровне фигуры упрощаются с допуском в одну клетку решётки тайла (мельче на этом уровне всё
+    равно не видно), затем обрезаются по каждому задетому тайлу с запасом buffer: отрезки — по Лиангу–Барски,
+    кольца — по Сазерленду–Ходжману. Тайл хранится компактным двоичным блоком (см. DecodeTile): числа —
+    varint, координаты — zigzag-разности соседних точек на решётке тайла. Пустые тайлы не хранятся.
+
+    Генерация параллельна по фигурам внутри уровня. Update перегенерирует только тайлы, которые задевают
+    старые или новые bounding box изменённых фигур, — остальные блоки остаются как были.
+*/
+class TilePyramid {
+public:
+    // world — область, которую покрывает тайл уровня 0; дополняется до квадрата от левого нижнего угла
+    explicit TilePyramid(const BoundingBox &world, const PyramidOptions &options = {});
+
+    void Build(std::span<const Shape> shapes);
+    // changed — индексы изменившихся фигур; при изменении их числа пирамида строится заново.
+    // Возвращает число перегенерированных тайлов
+    size_t Update(std::span<const Shape> shapes, std::span<const size_t> changed);
+
+    // Блок тайла; пустой, если в тайле ничего нет
+    [[nodiscard]] std::span<const uint8_t> Tile(const TileKey &key) const;
+    [[nodiscard]] const std::map<TileKey, std::vector<uint8_t>> &Tiles() const noexcept { return tiles_; }
+    [[nodiscard]] size_t TileCount() const noexcept { return tiles_.size(); }
+
+    [[nodiscard]] const BoundingBox &World() const noexcept { return world_; }
+    [[nodiscard]] BoundingBox TileBounds(const TileKey &key) const noexcept;
+    [[nodiscard]] const PyramidOptions &Options() const noexcept { return options_; }
+
+private:
+    struct TileRange {
+        uint32_t x0 = 1, y0 = 1, x1 = 0, y1 = 0;  // Пустой диапазон по умолчанию
+    };
+
+    // Тайлы уровня, которые задевает прямоугольник с учётом запаса
+    [[nodiscard]] TileRange RangeOf(const BoundingBox &box, uint32_t zoom) const noexcept;
+    [[nodiscard]] double TileSize(uint32_t zoom) const noexcept;
+    // Перегенерирует тайлы уровня, для которых dirty(x, y) истинно, из фигур candidates
+    template <typename Dirty>
+    void Regenerate(std::span<const Shape> shapes, uint32_t zoom, std::span<const size_t> candidates, Dirty dirty);
+
+    BoundingBox world_;
+    PyramidOptions options_;
+    std::vector<BoundingBox> boxes_;  // Bounding box фигур на момент последней генерации
+    std::map<TileKey, std::vector<uint8_t>> tiles_;
+};
+
+[[nodiscard]] std::expected<std::vector<TileFeature>, std::string> DecodeTile(std::span<const uint8_t> blob);
+
+}  // namespace geometry::tiles
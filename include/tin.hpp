@@ -0,0 +1,65 @@
+#pragma once
+#include "geometry.hpp"
+#include "point_location.hpp"
+#include "triangle_mesh.hpp"
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace geometry::triangulation {
+
+enum class InterpolationMethod {
+    Linear,           // Барицентрическая внутри треугольника
+    NaturalNeighbor,  // Координаты Сибсона: доли ячеек Вороного, «отнятые» точкой запроса
+};
+
+// Регулярная решётка узлов: columns x rows точек в центрах ячеек box, построчно от min_y
+struct RasterGrid {
+    BoundingBox box;
+    size_t columns = 0, rows = 0;
+
+    [[nodiscard]] Point2D Node(size_t column, size_t row) const noexcept;
+};
+
+/**
+    @brief Нерегулярная триангуляционная сеть (TIN): триангуляция Делоне образцов со значениями в вершинах
+
+    Треугольник под точкой ищется PointLocator, пакетные запросы обрабатываются блоками параллельно.
+    Вне триангуляции значение не определено: одиночный запрос возвращает nullopt, пакетный — NaN.
+*/
+class Tin {
+public:
+    // Значения совпадающих образцов усредняются
+    static std::expected<Tin, std::string> Build(std::span<const Point2D> points, std::span<const double> values);
+
+    [[nodiscard]] std::optional<double> Interpolate(const Point2D &p,
+                                                    InterpolationMethod method = InterpolationMethod::Linear) const;
+
+    [[nodiscard]] std::vector<double> Interpolate(std::span<const Point2D> points,
+                                                  InterpolationMethod method = InterpolationMethod::Linear,
+                                                  size_t threads = 0) const;
+
+    // Значения в узлах решётки, построчно
+    [[nodiscard]] std::vector<double> Interpolate(const RasterGrid &grid,
+                                                  InterpolationMethod method = InterpolationMethod::Linear,
+                                                  size_t threads = 0) const;
+
+    [[nodiscard]] const TriangleMesh &Mesh() const noexcept { return *mesh_; }
+    [[nodiscard]] std::span<const double> Values() const noexcept { return values_; }
+
+private:
+    Tin(std::unique_ptr<TriangleMesh> mesh, std::vector<double> values);
+
+    [[nodiscard]] double Linear(const Point2D &p, size_t triangle) const;
+    [[nodiscard]] double NaturalNeighbor(const Point2D &p, size_t triangle, std::vector<size_t> &scratch) const;
+
+    // Сетка в куче, чтобы адрес, на который ссылается локатор, не менялся при перемещении Tin
+    std::unique_ptr<TriangleMesh> mesh_;
+    std::vector<double> values_;
+    PointLocator locator_;
+};
+
+}  // namespace geometry::triangulation
@@ -0,0 +1,36 @@
+#pragma once
+#include "geometry.hpp"
+#include "triangulation.hpp"
+#include <array>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace geometry::triangulation {
+
+inline constexpr size_t NO_NEIGHBOR = std::numeric_limits<size_t>::max();
+
+/**
+    @brief Индексированная триангуляция со смежностью треугольников
+
+    Треугольники ориентированы против часовой стрелки. neighbors[t][k] — треугольник по другую сторону ребра
+    (triangles[t][k], triangles[t][(k + 1) % 3]) или NO_NEIGHBOR для граничного ребра.
+*/
+struct TriangleMesh {
+    std::vector<Point2D> vertices;
+    std::vector<std::array<size_t, 3>> triangles;
+    std::vector<std::array<size_t, 3>> neighbors;
+
+    [[nodiscard]] size_t Size() const noexcept { return triangles.size(); }
+    [[nodiscard]] Triangle GetTriangle(size_t t) const noexcept {
+        const auto &[a, b, c] = triangles[t];
+        return {vertices[a], vertices[b], vertices[c]};
+    }
+};
+
+// Сливает совпадающие вершины, отбрасывает вырожденные треугольники, ориентирует и связывает остальные
+TriangleMesh BuildMesh(std::span<const DelaunayTriangle> triangles);
+
+TriangleMesh BuildMesh(std::vector<Point2D> vertices, std::vector<std::array<size_t, 3>> triangles);
+
+}  // namespace geometry::triangulation
@@ -0,0 +1,109 @@
+#pragma once
+#include "geometry.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace geometry::index {
+
+/**
+    @brief Восьмиарное дерево ограничивающих прямоугольников с квантованными границами детей
+
+    Границы детей хранятся не числами double, а 7-битными координатами на решётке узла (его начало и шаг —
+    float). Восемь значений одной границы упакованы в uint64_t, так что перекрытие запроса со всеми детьми
+    проверяется одной SWAR-операцией на 64-битных словах. Узел занимает 88 байт на восемь детей — примерно
+    в четыре раза меньше двоичного дерева с прямоугольниками double.
+
+    Дерево строится снизу вверх по порядку Гильберта центров прямоугольников (packed R-tree): соседние по
+    кривой объекты попадают в один лист. Квантование консервативно, поэтому Query сообщает кандидатов:
+    прямоугольник может не доставать до запроса не больше чем на шаг решётки своего листа. Точную проверку
+    делает вызывающий код, как и после любого отбора по bounding box.
+    Структура неизменяема после построения, поэтому Query можно вызывать из нескольких потоков.
+*/
+class WideBvh {
+public:
+    static constexpr size_t WIDTH = 8;
+
+    WideBvh() = default;
+    explicit WideBvh(std::span<const BoundingBox> boxes);
+    explicit WideBvh(std::span<const Shape> shapes);
+
+    template <typename Visit>
+    void Query(const BoundingBox &box, Visit &&visit) const {
+        if (nodes_.empty() || !box.Overlaps(bounds_)) {
+            return;
+        }
+        std::array<uint32_t, MAX_STACK> stack;
+        size_t top = 0;
+        stack[top++] = root_;
+
+        while (top > 0) {
+            const Node &node = nodes_[stack[--top]];
+            for (uint64_t hits = node.Overlapping(box); hits != 0; hits &= hits - 1) {
+                const uint32_t child = node.children[static_cast<size_t>(std::countr_zero(hits)) / 8];
+                if (child & ITEM_BIT) {
+                    visit(static_cast<size_t>(child & ~ITEM_BIT));
+                } else {
+                    stack[top++] = child;
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::vector<size_t> Query(const BoundingBox &box) const;
+
+    [[nodiscard]] size_t Size() const noexcept { return size_; }
+    [[nodiscard]] size_t NodeCount() const noexcept { return nodes_.size(); }
+    [[nodiscard]] const BoundingBox &Bounds() const noexcept { return bounds_; }
+    // Объём узлов дерева в байтах (без самого объекта)
+    [[nodiscard]] size_t MemoryUsage() const noexcept { return nodes_.size() * sizeof(Node); }
+
+private:
+    // Старший бит ссылки на ребёнка отличает объект от узла, поэтому объектов не больше 2^31
+    static constexpr uint32_t ITEM_BIT = 0x80000000u;
+    static constexpr uint64_t LANES = 0x0101010101010101ull;
+    static constexpr uint64_t HIGH_BITS = 0x8080808080808080ull;
+    static constexpr double LEVELS = 127.0;
+    // Глубина дерева на 2^31 объектов не больше 11, в стеке не больше 7 детей на уровень и корень
+    static constexpr size_t MAX_STACK = 128;
+
+    struct Node {
+        float origin_x, origin_y;  // Начало решётки квантования
+        float step_x, step_y;      // Её шаг
+        // Восемь 7-битных дорожек в каждом слове, по одной на ребёнка
+        uint64_t lo_x, lo_y, hi_x, hi_y;
+        uint64_t present;  // 0x80 в дорожках существующих детей
+        std::array<uint32_t, WIDTH> children;
+
+        // В каждой дорожке старший бит: b >= a (значения дорожек не больше 127, займов между ними нет)
+        [[nodiscard]] static uint64_t GreaterEqual(uint64_t b, uint64_t a) noexcept {
+            return ((b | HIGH_BITS) - a) & HIGH_BITS;
+        }
+
+        // Маска дорожек детей, чьи квантованные границы перекрывают прямоугольник
+        [[nodiscard]] uint64_t Overlapping(const BoundingBox &box) const noexcept {
+            const double x0 = (box.min_x - origin_x) / step_x, x1 = (box.max_x - origin_x) / step_x;
+            const double y0 = (box.min_y - origin_y) / step_y, y1 = (box.max_y - origin_y) / step_y;
+            if (x1 < 0.0 || y1 < 0.0 || x0 > LEVELS || y0 > LEVELS) {
+                return 0;
+            }
+            // Значение запроса размножается во все восемь дорожек
+            const auto broadcast = [](double v) { return static_cast<uint64_t>(std::clamp(v, 0.0, LEVELS)) * LANES; };
+            const uint64_t q_lo_x = broadcast(std::floor(x0)), q_hi_x = broadcast(std::ceil(x1));
+            const uint64_t q_lo_y = broadcast(std::floor(y0)), q_hi_y = broadcast(std::ceil(y1));
+            return present & GreaterEqual(q_hi_x, lo_x) & GreaterEqual(hi_x, q_lo_x) & GreaterEqual(q_hi_y, lo_y) &
+                   GreaterEqual(hi_y, q_lo_y);
+        }
+    };
+
+    std::vector<Node> nodes_;
+    uint32_t root_ = 0;
+    size_t size_ = 0;
+    BoundingBox bounds_;
+};
+
+}  // namespace geometry::index
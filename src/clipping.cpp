@@ -0,0 +1,269 @@
+#include "clipping.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace geometry::clipping {
+
+namespace {
+
+// Отсечение полуплоскостью по одной стороне окна; inside и cross задают сторону
+template <typename Inside, typename Cross>
+void ClipAgainst(const std::vector<Point2D> &input, std::vector<Point2D> &output, Inside inside, Cross cross) {
+    output.clear();
+    if (input.empty()) {
+        return;
+    }
+    Point2D prev = input.back();
+    bool prev_inside = inside(prev);
+    for (const auto &p : input) {
+        const bool p_inside = inside(p);
+        if (p_inside != prev_inside) {
+            output.push_back(cross(prev, p));
+        }
+        if (p_inside) {
+            output.push_back(p);
+        }
+        prev = p;
+        prev_inside = p_inside;
+    }
+}
+
+}  // namespace
+
+/**
+    @brief Отсечение отрезка по Лиангу–Барски
+
+    Отрезок задаётся как start + t * (end - start), t ∈ [0, 1]. Каждая сторона окна сужает допустимый
+    интервал t; если он опустел, отрезок целиком снаружи.
+*/
+std::optional<Line> ClipLine(const Line &line, const BoundingBox &window) noexcept {
+    const double dx = line.end.x - line.start.x;
+    const double dy = line.end.y - line.start.y;
+    double t0 = 0.0, t1 = 1.0;
+
+    // p * t <= q для каждой из четырёх сторон
+    const double p[4] = {-dx, dx, -dy, dy};
+    const double q[4] = {line.start.x - window.min_x, window.max_x - line.start.x, line.start.y - window.min_y,
+                         window.max_y - line.start.y};
+    for (int k = 0; k < 4; ++k) {
+        if (p[k] == 0.0) {
+            if (q[k] < 0.0) {
+                return std::nullopt;
+            }
+            continue;
+        }
+        const double t = q[k] / p[k];
+        if (p[k] < 0.0) {
+            t0 = std::max(t0, t);
+        } else {
+            t1 = std::min(t1, t);
+        }
+        if (t0 > t1) {
+            return std::nullopt;
+        }
+    }
+    return Line{{line.start.x + t0 * dx, line.start.y + t0 * dy}, {line.start.x + t1 * dx, line.start.y + t1 * dy}};
+}
+
+/**
+    @brief Отсечение кольца по Сазерленду–Ходжману: четыре прохода, по одному на сторону окна
+
+    Невыпуклое кольцо, выходящее из окна несколько раз, получает рёбра вдоль границы окна, соединяющие
+    его куски. Для заливки это безразлично, поэтому такой результат подходит для отрисовки.
+*/
+std::vector<Point2D> ClipRing(std::span<const Point2D> ring, const BoundingBox &window) {
+    std::vector<Point2D> a(ring.begin(), ring.end());
+    std::vector<Point2D> b;
+    b.reserve(a.size() + 4);
+
+    auto at_x = [](const Point2D &p, const Point2D &q, double x) {
+        return Point2D{x, p.y + (q.y - p.y) * (x - p.x) / (q.x - p.x)};
+    };
+    auto at_y = [](const Point2D &p, const Point2D &q, double y) {
+        return Point2D{p.x + (q.x - p.x) * (y - p.y) / (q.y - p.y), y};
+    };
+
+    ClipAgainst(
+        a, b, [&](const Point2D &p) { return p.x >= window.min_x; },
+        [&](const Point2D &p, const Point2D &q) { return at_x(p, q, window.min_x); });
+    ClipAgainst(
+        b, a, [&](const Point2D &p) { return p.x <= window.max_x; },
+        [&](const Point2D &p, const Point2D &q) { return at_x(p, q, window.max_x); });
+    ClipAgainst(
+        a, b, [&](const Point2D &p) { return p.y >= window.min_y; },
+        [&](const Point2D &p, const Point2D &q) { return at_y(p, q, window.min_y); });
+    ClipAgainst(
+        b, a, [&](const Point2D &p) { return p.y <= window.max_y; },
+        [&](const Point2D &p, const Point2D &q) { return at_y(p, q, window.max_y); });
+    return a;
+}
+
+void LineSoA::Assign(std::span<const Line> lines) {
+    Resize(lines.size());
+    for (size_t i = 0; i < lines.size(); ++i) {
+        x0[i] = lines[i].start.x;
+        y0[i] = lines[i].start.y;
+        x1[i] = lines[i].end.x;
+        y1[i] = lines[i].end.y;
+    }
+}
+
+void LineSoA::Resize(size_t n) {
+    x0.resize(n);
+    y0.resize(n);
+    x1.resize(n);
+    y1.resize(n);
+}
+
+/**
+    @brief Лианг–Барски без ветвлений
+
+    Для каждой пары параллельных сторон считаются параметры входа и выхода, отрезок параллельный паре
+    получает (-inf, inf) или (inf, -inf) в зависимости от того, лежит ли он между ними. Условия записаны
+    как выборы между значениями, а не переходы, поэтому цикл по массивам векторизуется компилятором.
+*/
+size_t ClipLines(const LineSoA &in, const BoundingBox &window, LineSoA &out, std::span<uint8_t> visible) noexcept {
+    constexpr double INF = std::numeric_limits<double>::infinity();
+    constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+    // Блок считается в локальные массивы: они заведомо не пересекаются ни с in, ни с out, поэтому
+    // компилятору не нужны проверки перекрытия восьми массивов, на которых он отказывается от векторизации
+    constexpr size_t BLOCK = 256;
+    std::array<double, BLOCK> bx0, by0, bx1, by1;
+
+    const size_t n = in.Size();
+    const double min_x = window.min_x, min_y = window.min_y, max_x = window.max_x, max_y = window.max_y;
+    size_t count = 0;
+    for (size_t begin = 0; begin < n; begin += BLOCK) {
+        const size_t size = std::min(BLOCK, n - begin);
+        const double *x0 = in.x0.data() + begin, *y0 = in.y0.data() + begin;
+        const double *x1 = in.x1.data() + begin, *y1 = in.y1.data() + begin;
+
+        // Только double: смешение ширин (флаги uint8_t) тоже мешает векторизации
+        for (size_t i = 0; i < size; ++i) {
+            const double sx = x0[i], sy = y0[i];
+            const double dx = x1[i] - sx, dy = y1[i] - sy;
+
+            const double inv_x = 1.0 / (dx != 0.0 ? dx : 1.0);
+            const double ax = (min_x - sx) * inv_x, bx = (max_x - sx) * inv_x;
+            const double parallel_x = sx >= min_x && sx <= max_x ? -INF : INF;
+            const double enter_x = dx != 0.0 ? std::min(ax, bx) : parallel_x;
+            const double exit_x = dx != 0.0 ? std::max(ax, bx) : -parallel_x;
+
+            const double inv_y = 1.0 / (dy != 0.0 ? dy : 1.0);
+            const double ay = (min_y - sy) * inv_y, by = (max_y - sy) * inv_y;
+            const double parallel_y = sy >= min_y && sy <= max_y ? -INF : INF;
+            const double enter_y = dy != 0.0 ? std::min(ay, by) : parallel_y;
+            const double exit_y = dy != 0.0 ? std::max(ay, by) : -parallel_y;
+
+            const double t0 = std::max(std::max(0.0, enter_x), enter_y);
+            const double t1 = std::min(std::min(1.0, exit_x), exit_y);
+            const bool inside = t0 <= t1;
+
+            bx0[i] = inside ? sx + t0 * dx : NaN;
+            by0[i] = inside ? sy + t0 * dy : NaN;
+            bx1[i] = inside ? sx + t1 * dx : NaN;
+            by1[i] = inside ? sy + t1 * dy : NaN;
+        }
+
+        for (size_t i = 0; i < size; ++i) {
+            const bool inside = !std::isnan(bx0[i]);
+            visible[begin + i] = inside;
+            count += inside;
+        }
+        std::copy_n(bx0.begin(), size, out.x0.begin() + begin);
+        std::copy_n(by0.begin(), size, out.y0.begin() + begin);
+        std::copy_n(bx1.begin(), size, out.x1.begin() + begin);
+        std::copy_n(by1.begin(), size, out.y1.begin() + begin);
+    }
+    return count;
+}
+
+/**
+    @brief Проход Сазерленда–Ходжмана по одной стороне окна
+
+    Сначала векторно и без ветвлений считаются принадлежность каждой вершины полуплоскости и точка
+    пересечения каждого ребра (i - 1, i) с прямой стороны. Затем вершины сжимаются: пересечение и сама
+    вершина пишутся всегда, а курсор сдвигается на флаги «ребро пересекает сторону» и «вершина внутри».
+    Из ребра выходит не больше двух точек, поэтому выходного буфера размером 2n достаточно.
+*/
+template <bool ALONG_X, bool KEEP_GREATER>
+void RingClipper::ClipSide(double bound) {
+    const size_t n = src_x_.size();
+    if (n == 0) {
+        return;
+    }
+    inside_.resize(n);
+    cross_x_.resize(n);
+    cross_y_.resize(n);
+    dst_x_.resize(2 * n);
+    dst_y_.resize(2 * n);
+    const double *xs = src_x_.data(), *ys = src_y_.data();
+    double *inside = inside_.data();
+    double *cross_x = cross_x_.data(), *cross_y = cross_y_.data();
+
+    for (size_t i = 0; i < n; ++i) {
+        const double c = ALONG_X ? xs[i] : ys[i];
+        inside[i] = (KEEP_GREATER ? c >= bound : c <= bound) ? 1.0 : 0.0;
+    }
+    auto cross = [&](size_t from, size_t to) {
+        const double a = ALONG_X ? xs[from] : ys[from];
+        const double b = ALONG_X ? xs[to] : ys[to];
+        const double d = b - a;
+        const double t = (bound - a) / (d != 0.0 ? d : 1.0);
+        cross_x[to] = ALONG_X ? bound : xs[from] + t * (xs[to] - xs[from]);
+        cross_y[to] = ALONG_X ? ys[from] + t * (ys[to] - ys[from]) : bound;
+    };
+    cross(n - 1, 0);
+    for (size_t i = 1; i < n; ++i) {
+        cross(i - 1, i);
+    }
+
+    double *dst_x = dst_x_.data(), *dst_y = dst_y_.data();
+    size_t k = 0;
+    bool prev = inside[n - 1] != 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const bool cur = inside[i] != 0.0;
+        dst_x[k] = cross_x[i];
+        dst_y[k] = cross_y[i];
+        k += cur != prev;
+        dst_x[k] = xs[i];
+        dst_y[k] = ys[i];
+        k += cur;
+        prev = cur;
+    }
+    dst_x_.resize(k);
+    dst_y_.resize(k);
+    src_x_.swap(dst_x_);
+    src_y_.swap(dst_y_);
+}
+
+std::pair<std::span<const double>, std::span<const double>> RingClipper::Clip(std::span<const double> xs,
+                                                                             std::span<const double> ys,
+                                                                             const BoundingBox &window) {
+    src_x_.assign(xs.begin(), xs.end());
+    src_y_.assign(ys.begin(), ys.end());
+    ClipSide<true, true>(window.min_x);
+    ClipSide<true, false>(window.max_x);
+    ClipSide<false, true>(window.min_y);
+    ClipSide<false, false>(window.max_y);
+    return {src_x_, src_y_};
+}
+
+void RingClipper::ClipRings(std::span<const double> xs, std::span<const double> ys, std::span<const size_t> offsets,
+                            const BoundingBox &window, std::vector<double> &out_xs, std::vector<double> &out_ys,
+                            std::vector<size_t> &out_offsets) {
+    out_xs.clear();
+    out_ys.clear();
+    out_offsets.assign(1, 0);
+    for (size_t r = 0; r + 1 < offsets.size(); ++r) {
+        const size_t first = offsets[r], count = offsets[r + 1] - offsets[r];
+        const auto [cx, cy] = Clip(xs.subspan(first, count), ys.subspan(first, count), window);
+        out_xs.insert(out_xs.end(), cx.begin(), cx.end());
+        out_ys.insert(out_ys.end(), cy.begin(), cy.end());
+        out_offsets.push_back(out_xs.size());
+    }
+}
+
+}  // namespace geometry::clipping
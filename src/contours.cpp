@@ -0,0 +1,151 @@
+#include "contours.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace geometry::triangulation {
+
+namespace {
+
+struct ValueRange {
+    double min, max;
+};
+
+/**
+    @brief Изолинии одного уровня, сшитые по смежности треугольников
+
+    Вершина со значением не ниже уровня считается «выше», поэтому изолиния пересекает ровно два ребра
+    каждого треугольника со смешанными вершинами и никогда не проходит через вершину. У такого треугольника
+    одно ребро входное (снизу вверх в порядке обхода) и одно выходное; выходное ребро у соседа по нему
+    оказывается входным, так что цепочка продолжается переходом к соседу без поиска совпадающих концов.
+*/
+class LevelTracer {
+public:
+    LevelTracer(const TriangleMesh &mesh, std::span<const double> values, std::span<const ValueRange> ranges,
+                double level)
+        : mesh_(mesh), values_(values), ranges_(ranges), level_(level), visited_(mesh.Size(), false) {}
+
+    void Trace(std::vector<Contour> &out) {
+        for (size_t t = 0; t < mesh_.Size(); ++t) {
+            if (visited_[t] || !Crossed(t)) {
+                continue;
+            }
+            Contour contour{.level = level_};
+            // Вперёд до границы или до возврата в исходный треугольник
+            const size_t end = Follow(t, contour.points, true);
+            contour.closed = end == t;
+            if (!contour.closed) {
+                // Незамкнутая цепочка: дописываем часть, лежащую до исходного треугольника
+                std::vector<Point2D> backward;
+                Follow(t, backward, false);
+                std::ranges::reverse(backward);
+                backward.pop_back();  // Входная точка исходного треугольника уже есть в прямой части
+                backward.insert(backward.end(), contour.points.begin(), contour.points.end());
+                contour.points = std::move(backward);
+            }
+            out.push_back(std::move(contour));
+        }
+    }
+
+private:
+    [[nodiscard]] bool Above(size_t vertex) const noexcept { return values_[vertex] >= level_; }
+
+    [[nodiscard]] bool Crossed(size_t t) const noexcept {
+        return ranges_[t].min < level_ && ranges_[t].max >= level_;
+    }
+
+    // Ребро k треугольника t, на котором «выше» сменяется «ниже» (exit) или наоборот
+    [[nodiscard]] size_t CrossedEdge(size_t t, bool exit) const noexcept {
+        const auto &tri = mesh_.triangles[t];
+        for (size_t k = 0; k < 3; ++k) {
+            const bool from = Above(tri[k]), to = Above(tri[(k + 1) % 3]);
+            if (from != to && from == exit) {
+                return k;
+            }
+        }
+        return 0;
+    }
+
+    // Точка пересечения уровня с ребром; вершины упорядочены, чтобы соседи получили одну и ту же точку
+    [[nodiscard]] Point2D EdgePoint(size_t t, size_t k) const noexcept {
+        size_t a = mesh_.triangles[t][k], b = mesh_.triangles[t][(k + 1) % 3];
+        if (a > b) {
+            std::swap(a, b);
+        }
+        const double ratio = (level_ - values_[a]) / (values_[b] - values_[a]);
+        return mesh_.vertices[a] + (mesh_.vertices[b] - mesh_.vertices[a]) * ratio;
+    }
+
+    /**
+        Обходит цепочку от треугольника start через выходные (forward) или входные рёбра, дописывая точки
+        пересечения. Возвращает start, если цепочка замкнулась, иначе последний треугольник перед границей.
+    */
+    size_t Follow(size_t start, std::vector<Point2D> &points, bool forward) {
+        size_t t = start;
+        if (forward) {
+            points.push_back(EdgePoint(t, CrossedEdge(t, false)));
+        }
+        while (true) {
+            visited_[t] = true;
+            const size_t k = CrossedEdge(t, forward);
+            points.push_back(EdgePoint(t, k));
+            const size_t next = mesh_.neighbors[t][k];
+            if (next == NO_NEIGHBOR) {
+                return t;
+            }
+            if (next == start) {
+                points.pop_back();
+                return start;
+            }
+            t = next;
+        }
+    }
+
+    const TriangleMesh &mesh_;
+    std::span<const double> values_;
+    std::span<const ValueRange> ranges_;
+    double level_;
+    std::vector<bool> visited_;
+};
+
+}  // namespace
+
+std::optional<Polygon> Contour::AsPolygon() const {
+    if (!closed || points.size() < 3) {
+        return std::nullopt;
+    }
+    return Polygon(points);
+}
+
+/**
+    @brief Изолинии на нескольких уровнях, уровни обрабатываются параллельно
+
+    Диапазон значений каждого треугольника считается один раз, так что проход по уровню сводится к
+    сравнению двух чисел на треугольник вне пересекаемой полосы.
+*/
+std::vector<Contour> ExtractContours(const TriangleMesh &mesh, std::span<const double> values,
+                                     std::span<const double> levels, size_t threads) {
+    std::vector<ValueRange> ranges;
+    ranges.reserve(mesh.Size());
+    for (const auto &[a, b, c] : mesh.triangles) {
+        ranges.push_back({std::min({values[a], values[b], values[c]}), std::max({values[a], values[b], values[c]})});
+    }
+
+    std::vector<std::vector<Contour>> per_level(levels.size());
+    parallel::ParallelFor(
+        levels.size(), 1,
+        [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                LevelTracer(mesh, values, ranges, levels[i]).Trace(per_level[i]);
+            }
+        },
+        threads);
+
+    std::vector<Contour> result;
+    for (auto &contours : per_level) {
+        std::ranges::move(contours, std::back_inserter(result));
+    }
+    return result;
+}
+
+}  // namespace geometry::triangulation
@@ -0,0 +1,321 @@
+#include "convex_decomposition.hpp"
+#include "queries.hpp"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace geometry::decomposition {
+
+namespace {
+
+struct EdgeHash {
+    [[nodiscard]] size_t operator()(const std::pair<size_t, size_t> &edge) const noexcept {
+        return std::hash<size_t>{}(edge.first * 0x9e3779b97f4a7c15ULL ^ edge.second);
+    }
+};
+
+double DoubledArea(std::span<const Point2D> ring) noexcept {
+    double area = 0.0;
+    for (size_t i = 0; i < ring.size(); ++i) {
+        area += ring[i].Cross(ring[(i + 1) % ring.size()]);
+    }
+    return area;
+}
+
+// Знак поворота с допуском относительно длин рёбер: 1 — влево, -1 — вправо, 0 — коллинеарно
+int Turn(const Point2D &a, const Point2D &b, const Point2D &c) noexcept {
+    const double cross = (b - a).Cross(c - b);
+    const double scale = 1e-12 * (b - a).Length() * (c - b).Length();
+    return cross > scale ? 1 : (cross < -scale ? -1 : 0);
+}
+
+// Точка внутри треугольника abc (против часовой стрелки) или на его границе
+bool InTriangle(const Point2D &a, const Point2D &b, const Point2D &c, const Point2D &p) noexcept {
+    return queries::detail::Orientation(a, b, p) >= 0 && queries::detail::Orientation(b, c, p) >= 0 &&
+           queries::detail::Orientation(c, a, p) >= 0;
+}
+
+BoundingBox RingBox(std::span<const Point2D> ring) noexcept {
+    BoundingBox box{ring.front().x, ring.front().y, ring.front().x, ring.front().y};
+    for (const auto &p : ring) {
+        box.min_x = std::min(box.min_x, p.x);
+        box.min_y = std::min(box.min_y, p.y);
+        box.max_x = std::max(box.max_x, p.x);
+        box.max_y = std::max(box.max_y, p.y);
+    }
+    return box;
+}
+
+// Проекция выпуклого многоугольника на ось
+std::pair<double, double> Project(std::span<const Point2D> polygon, const Point2D &axis) noexcept {
+    double min = std::numeric_limits<double>::max(), max = std::numeric_limits<double>::lowest();
+    for (const auto &p : polygon) {
+        const double d = p.Dot(axis);
+        min = std::min(min, d);
+        max = std::max(max, d);
+    }
+    return {min, max};
+}
+
+// Есть ли среди нормалей рёбер a ось, разделяющая a и b
+bool HasSeparatingAxis(std::span<const Point2D> a, std::span<const Point2D> b) noexcept {
+    for (size_t i = 0; i < a.size(); ++i) {
+        const Point2D edge = a[(i + 1) % a.size()] - a[i];
+        const Point2D axis{-edge.y, edge.x};
+        const auto [min_a, max_a] = Project(a, axis);
+        const auto [min_b, max_b] = Project(b, axis);
+        if (max_a < min_b || max_b < min_a) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+/**
+    @brief Триангуляция отсечением ушей за O(n^2)
+
+    Ухо — выпуклая вершина, в треугольнике которой нет других вершин многоугольника. Коллинеарные вершины
+    удаляются без треугольника; если за полный оборот не нашлось ни уха, ни такой вершины,
+    многоугольник не простой.
+*/
+std::expected<std::vector<std::array<size_t, 3>>, std::string> TriangulateSimplePolygon(std::span<const Point2D> ring) {
+    if (ring.size() < 3) {
+        return std::unexpected("A polygon requires at least three vertices.");
+    }
+    const double area = DoubledArea(ring);
+    if (area == 0.0) {
+        return std::unexpected("Polygon has zero area.");
+    }
+
+    std::vector<size_t> remaining(ring.size());
+    std::iota(remaining.begin(), remaining.end(), 0);
+    if (area < 0) {
+        std::ranges::reverse(remaining);
+    }
+
+    std::vector<std::array<size_t, 3>> triangles;
+    triangles.reserve(ring.size() - 2);
+    size_t i = 0, stalled = 0;
+    while (remaining.size() > 3) {
+        const size_t n = remaining.size();
+        const size_t prev = remaining[(i + n - 1) % n], cur = remaining[i % n], next = remaining[(i + 1) % n];
+        const Point2D &a = ring[prev], &b = ring[cur], &c = ring[next];
+        const int turn = Turn(a, b, c);
+
+        bool clip = turn == 0;
+        if (turn > 0) {
+            clip = std::ranges::none_of(remaining, [&](size_t v) {
+                return v != prev && v != cur && v != next && ring[v] != a && ring[v] != b && ring[v] != c &&
+                       InTriangle(a, b, c, ring[v]);
+            });
+            if (clip) {
+                triangles.push_back({prev, cur, next});
+            }
+        }
+
+        if (clip) {
+            remaining.erase(remaining.begin() + static_cast<std::ptrdiff_t>(i % n));
+            stalled = 0;
+        } else if (++stalled > 2 * n) {
+            return std::unexpected("Polygon is not simple.");
+        } else {
+            ++i;
+        }
+        i %= remaining.size();
+    }
+    if (Turn(ring[remaining[0]], ring[remaining[1]], ring[remaining[2]]) > 0) {
+        triangles.push_back({remaining[0], remaining[1], remaining[2]});
+    }
+    return triangles;
+}
+
+/**
+    @brief Алгоритм Хертеля–Мельхорна: триангуляция и жадное удаление лишних диагоналей
+
+    Двойственный граф триангуляции простого многоугольника — дерево, поэтому по каждой диагонали смежны
+    две разные части. Диагональ убирается, если после слияния частей её концы остаются выпуклыми;
+    остальные вершины частей при слиянии не меняются.
+*/
+std::expected<std::vector<ConvexPart>, std::string> ConvexDecomposition(std::span<const Point2D> ring) {
+    auto triangles = TriangulateSimplePolygon(ring);
+    if (!triangles) {
+        return std::unexpected(triangles.error());
+    }
+
+    std::vector<std::vector<size_t>> parts;
+    parts.reserve(triangles->size());
+    std::vector<size_t> owner(triangles->size());
+    std::unordered_map<std::pair<size_t, size_t>, size_t, EdgeHash> half_edges;
+    for (size_t t = 0; t < triangles->size(); ++t) {
+        const auto &tri = (*triangles)[t];
+        parts.push_back({tri.begin(), tri.end()});
+        owner[t] = t;
+        for (size_t k = 0; k < 3; ++k) {
+            half_edges.emplace(std::pair{tri[k], tri[(k + 1) % 3]}, t);
+        }
+    }
+
+    auto find = [&owner](size_t t) {
+        while (owner[t] != t) {
+            owner[t] = owner[owner[t]];
+            t = owner[t];
+        }
+        return t;
+    };
+    // Поворот контура так, чтобы он начинался с вершины from
+    auto rotate_to = [](std::vector<size_t> ring_ids, size_t from) {
+        std::ranges::rotate(ring_ids, std::ranges::find(ring_ids, from));
+        return ring_ids;
+    };
+
+    for (size_t t = 0; t < triangles->size(); ++t) {
+        const auto &tri = (*triangles)[t];
+        for (size_t k = 0; k < 3; ++k) {
+            const size_t u = tri[k], v = tri[(k + 1) % 3];
+            const auto twin = half_edges.find({v, u});
+            // Каждая диагональ рассматривается один раз — со стороны треугольника с меньшим номером
+            if (twin == half_edges.end() || twin->second < t) {
+                continue;
+            }
+            const size_t p1 = find(t), p2 = find(twin->second);
+
+            // В p1 ребро идёт u -> v, в p2 — v -> u: склеиваем [v .. u] из p1 и (u .. v) из p2
+            std::vector<size_t> merged = rotate_to(parts[p1], v);
+            const auto second = rotate_to(parts[p2], u);
+            merged.insert(merged.end(), second.begin() + 1, second.end() - 1);
+
+            const size_t m = merged.size();
+            const size_t iu = static_cast<size_t>(std::ranges::find(merged, u) - merged.begin());
+            auto convex_at = [&](size_t at) {
+                return Turn(ring[merged[(at + m - 1) % m]], ring[merged[at]], ring[merged[(at + 1) % m]]) >= 0;
+            };
+            if (convex_at(0) && convex_at(iu)) {
+                parts[p1] = std::move(merged);
+                parts[p2].clear();
+                owner[p2] = p1;
+            }
+        }
+    }
+
+    std::vector<ConvexPart> result;
+    for (const auto &part : parts) {
+        if (part.empty()) {
+            continue;
+        }
+        ConvexPart convex;
+        convex.points.reserve(part.size());
+        for (size_t v : part) {
+            convex.points.push_back(ring[v]);
+        }
+        convex.box = RingBox(convex.points);
+        result.push_back(std::move(convex));
+    }
+    return result;
+}
+
+bool ConvexPartsIntersect(std::span<const Point2D> a, std::span<const Point2D> b) noexcept {
+    if (a.empty() || b.empty()) {
+        return false;
+    }
+    return !HasSeparatingAxis(a, b) && !HasSeparatingAxis(b, a);
+}
+
+double ConvexPartsDistance(std::span<const Point2D> a, std::span<const Point2D> b) {
+    if (ConvexPartsIntersect(a, b)) {
+        return 0.0;
+    }
+    // Ближайшая пара точек выпуклых многоугольников всегда включает вершину одного из них
+    double distance = std::numeric_limits<double>::max();
+    for (const auto &p : a) {
+        distance = std::min(distance, queries::detail::DistanceToOutline(p, b, true));
+    }
+    for (const auto &p : b) {
+        distance = std::min(distance, queries::detail::DistanceToOutline(p, a, true));
+    }
+    return distance;
+}
+
+size_t ConvexDecompositionCache::RingHash::operator()(const std::vector<Point2D> &ring) const noexcept {
+    size_t seed = ring.size();
+    for (const auto &p : ring) {
+        seed ^= std::hash<Point2D>{}(p) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
+
+std::shared_ptr<const ConvexDecompositionCache::Parts> ConvexDecompositionCache::Get(const Polygon &polygon) {
+    const auto vertices = polygon.Vertices();
+    std::vector<Point2D> key(vertices.begin(), vertices.end());
+    {
+        std::scoped_lock lock(mutex_);
+        if (auto it = entries_.find(key); it != entries_.end()) {
+            return it->second;
+        }
+    }
+
+    auto decomposition = ConvexDecomposition(key);
+    auto parts = std::make_shared<const Parts>(decomposition ? std::move(*decomposition) : Parts{});
+
+    std::scoped_lock lock(mutex_);
+    if (entries_.size() >= capacity_) {
+        entries_.clear();
+    }
+    entries_.emplace(std::move(key), parts);
+    return parts;
+}
+
+size_t ConvexDecompositionCache::Size() const {
+    std::scoped_lock lock(mutex_);
+    return entries_.size();
+}
+
+void ConvexDecompositionCache::Clear() {
+    std::scoped_lock lock(mutex_);
+    entries_.clear();
+}
+
+/**
+    @brief Пересечение многоугольников: пересекаются ли какие-нибудь их выпуклые части
+
+    Пары частей отсекаются по bounding box до проверки SAT. Для многоугольников без разбиения
+    используется общая проверка пересечения фигур.
+*/
+bool PolygonsIntersect(const Polygon &a, const Polygon &b, ConvexDecompositionCache &cache) {
+    if (!a.BoundBox().Overlaps(b.BoundBox())) {
+        return false;
+    }
+    const auto parts_a = cache.Get(a);
+    const auto parts_b = cache.Get(b);
+    if (parts_a->empty() || parts_b->empty()) {
+        return queries::ShapesIntersectVisitor{}(a, b);
+    }
+    for (const auto &pa : *parts_a) {
+        for (const auto &pb : *parts_b) {
+            if (pa.box.Overlaps(pb.box) && ConvexPartsIntersect(pa.points, pb.points)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+double PolygonsDistance(const Polygon &a, const Polygon &b, ConvexDecompositionCache &cache) {
+    const auto parts_a = cache.Get(a);
+    const auto parts_b = cache.Get(b);
+    if (parts_a->empty() || parts_b->empty()) {
+        return queries::ExactDistanceVisitor{}(a, b);
+    }
+    double distance = std::numeric_limits<double>::max();
+    for (const auto &pa : *parts_a) {
+        for (const auto &pb : *parts_b) {
+            if (queries::BoundingBoxDistance(pa.box, pb.box) < distance) {
+                distance = std::min(distance, ConvexPartsDistance(pa.points, pb.points));
+            }
+        }
+    }
+    return distance;
+}
+
+}  // namespace geometry::decomposition
@@ -1,9 +1,69 @@
 #include "convex_hull.hpp"
 #include <algorithm>
+#include <bit>
 #include <stdexcept>
 
 namespace geometry::convex_hull {
 
+namespace {
+
+/**
+    @brief Индекс максимума циклически унимодальной последовательности из n элементов
+
+    greater(i, j) сравнивает элементы i и j. Двоичный поиск по цепочке [a, b] сохраняет в ней максимум,
+    глядя, поднимаются ли рёбра в её начале и середине (алгоритм Сандэя). Коллинеарные вершины дают
+    плато равных значений, и у минимума тоже; поэтому ответом признаётся только вершина, не меньшая
+    соседей и строго большая хотя бы одного из них. Если поиск так и не нашёл её, максимум ищется перебором.
+*/
+template <typename Greater>
+size_t CyclicArgMax(size_t n, Greater greater) {
+    auto up = [&](size_t i) { return greater((i + 1) % n, i % n); };
+    auto is_peak = [&](size_t i) {
+        const size_t prev = (i + n - 1) % n, next = (i + 1) % n;
+        return !greater(prev, i) && !greater(next, i) && (greater(i, prev) || greater(i, next));
+    };
+
+    if (is_peak(0)) {
+        return 0;
+    }
+    size_t a = 0, b = n;
+    bool up_a = up(0);
+    const size_t max_iterations = 2 * static_cast<size_t>(std::bit_width(n)) + 4;
+    for (size_t iteration = 0; b - a > 1 && iteration < max_iterations; ++iteration) {
+        const size_t c = (a + b) / 2;
+        const bool up_c = up(c);
+        if (is_peak(c)) {
+            return c;
+        }
+        if (up_a) {
+            if (!up_c || greater(a, c)) {
+                b = c;
+            } else {
+                a = c;
+            }
+        } else {
+            if (up_c) {
+                a = c;
+                up_a = true;
+            } else if (greater(c, a)) {
+                b = c;
+            } else {
+                a = c;
+            }
+        }
+    }
+
+    size_t best = 0;
+    for (size_t i = 1; i < n; ++i) {
+        if (greater(i, best)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
 double CrossProduct(Point2D p1, Point2D middle, Point2D p2) {
     auto new_p1 = p1 - middle;
     auto new_p2 = p2 - middle;
@@ -44,4 +104,107 @@ std::expected<std::vector<Point2D>, std::string> GrahamScan(std::span<Point2D> p
     return std::vector{hull.Extract()};
 }
 
-}  // namespace geometry::convex_hull
\ No newline at end of file
+/**
+    @brief Принадлежность точки веером треугольников из первой вершины: двоичный поиск сектора и одна проверка ребра
+*/
+bool ConvexPolygon::Contains(const Point2D &p) const noexcept {
+    const size_t n = vertices_.size();
+    if (n < 3) {
+        return false;
+    }
+    const Point2D &origin = vertices_[0];
+    if (CrossProduct(vertices_[1], origin, p) < 0 || CrossProduct(vertices_[n - 1], origin, p) > 0) {
+        return false;
+    }
+
+    // Последняя вершина k, для которой p не правее луча origin -> v_k
+    size_t lo = 1, hi = n - 1;
+    while (hi - lo > 1) {
+        const size_t mid = (lo + hi) / 2;
+        if (CrossProduct(vertices_[mid], origin, p) >= 0) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return CrossProduct(vertices_[lo + 1], vertices_[lo], p) >= 0;
+}
+
+size_t ConvexPolygon::ExtremeVertex(const Point2D &direction) const noexcept {
+    if (vertices_.empty()) {
+        return 0;
+    }
+    return CyclicArgMax(vertices_.size(), [&](size_t i, size_t j) {
+        return direction.Dot(vertices_[i]) > direction.Dot(vertices_[j]);
+    });
+}
+
+/**
+    @brief Касательные из внешней точки
+
+    Для точки снаружи вершины упорядочены по углу, под которым их видно из p, и этот порядок циклически
+    унимодален: крайние вершины — точки касания. Точка внутри или на границе касательных не имеет.
+*/
+std::optional<std::pair<size_t, size_t>> ConvexPolygon::Tangents(const Point2D &p) const noexcept {
+    const size_t n = vertices_.size();
+    if (n < 3 || Contains(p)) {
+        return std::nullopt;
+    }
+    // v_i правее v_j, если смотреть из p
+    auto righter = [&](size_t i, size_t j) { return (vertices_[i] - p).Cross(vertices_[j] - p) > 0; };
+    const size_t right = CyclicArgMax(n, righter);
+    const size_t left = CyclicArgMax(n, [&](size_t i, size_t j) { return righter(j, i); });
+    return std::pair{right, left};
+}
+
+/**
+    @brief Пересечение с прямой: крайние вершины по нормали к прямой и двоичный поиск смены знака на двух цепочках
+
+    Расстояние до прямой со знаком монотонно на цепочках между минимумом и максимумом, поэтому каждая
+    из двух точек пересечения находится своим двоичным поиском.
+*/
+std::optional<std::pair<Point2D, Point2D>> ConvexPolygon::IntersectLine(const Point2D &a,
+                                                                        const Point2D &b) const noexcept {
+    const size_t n = vertices_.size();
+    const Point2D direction = b - a;
+    if (n < 3 || (direction.x == 0.0 && direction.y == 0.0)) {
+        return std::nullopt;
+    }
+    const Point2D normal{-direction.y, direction.x};
+    auto side = [&](size_t i) { return direction.Cross(vertices_[i % n] - a); };
+
+    const size_t top = ExtremeVertex(normal);
+    const size_t bottom = ExtremeVertex({-normal.x, -normal.y});
+    if (side(top) < 0 || side(bottom) > 0) {
+        return std::nullopt;
+    }
+
+    // Первая вершина цепочки [from, to], на которой знак side сменился, и точка пересечения на ребре перед ней
+    auto crossing = [&](size_t from, size_t to, bool rising) {
+        if (to < from) {
+            to += n;
+        }
+        const bool from_passed = rising ? side(from) >= 0 : side(from) <= 0;
+        if (from_passed) {
+            return vertices_[from % n];
+        }
+        size_t lo = from, hi = to;
+        while (hi - lo > 1) {
+            const size_t mid = (lo + hi) / 2;
+            const bool passed = rising ? side(mid) >= 0 : side(mid) <= 0;
+            (passed ? hi : lo) = mid;
+        }
+        const double s0 = side(lo), s1 = side(hi);
+        const Point2D &p0 = vertices_[lo % n], &p1 = vertices_[hi % n];
+        return p0 + (p1 - p0) * (s0 / (s0 - s1));
+    };
+
+    Point2D first = crossing(bottom, top, true);
+    Point2D second = crossing(top, bottom, false);
+    if (direction.Dot(second - first) < 0) {
+        std::swap(first, second);
+    }
+    return std::pair{first, second};
+}
+
+}  // namespace geometry::convex_hull
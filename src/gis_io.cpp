@@ -0,0 +1,1157 @@
+#include "gis_io.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace geometry::io {
+
+namespace {
+
+// Вершины копируются в пул из WKB одним блоком
+static_assert(sizeof(Point2D) == 2 * sizeof(double) && std::is_trivially_copyable_v<Point2D>);
+
+constexpr uint8_t NATIVE_BYTE_ORDER = std::endian::native == std::endian::little ? 1 : 0;
+// Предел вложенности коллекций и массивов, чтобы враждебный ввод не исчерпал стек
+constexpr size_t MAX_DEPTH = 64;
+constexpr size_t MAX_NUMBER = 32;
+
+constexpr std::array<std::string_view, 8> TYPE_NAMES = {
+    "", "Point", "LineString", "Polygon", "MultiPoint", "MultiLineString", "MultiPolygon", "GeometryCollection",
+};
+
+std::string_view TypeName(GeometryType type) noexcept { return TYPE_NAMES[static_cast<size_t>(type)]; }
+
+// Регистр сравнивается без учёта регистра, как принято в WKT
+bool NameEquals(std::string_view word, std::string_view name) noexcept {
+    return word.size() == name.size() && std::ranges::equal(word, name, [](char a, char b) {
+               return std::toupper(static_cast<unsigned char>(a)) == std::toupper(static_cast<unsigned char>(b));
+           });
+}
+
+std::optional<GeometryType> FindType(std::string_view word, bool ignore_case) noexcept {
+    for (size_t code = 1; code < TYPE_NAMES.size(); ++code) {
+        if (ignore_case ? NameEquals(word, TYPE_NAMES[code]) : word == TYPE_NAMES[code]) {
+            return static_cast<GeometryType>(code);
+        }
+    }
+    return std::nullopt;
+}
+
+bool IsPolygonal(GeometryType type) noexcept {
+    return type == GeometryType::Polygon || type == GeometryType::MultiPolygon;
+}
+
+// Кольцо в источнике может быть не замкнуто повтором первой точки
+bool NeedsClosing(std::span<const Point2D> ring) noexcept { return !ring.empty() && !(ring.front() == ring.back()); }
+
+std::vector<Point2D> OpenRing(std::span<const Point2D> ring) {
+    const size_t size = ring.size() > 1 && ring.front() == ring.back() ? ring.size() - 1 : ring.size();
+    return {ring.begin(), ring.begin() + static_cast<ptrdiff_t>(size)};
+}
+
+// Пул вершин, переиспользуемый от геометрии к геометрии
+class Arena {
+public:
+    void Clear() {
+        points.clear();
+        paths.assign(1, 0);
+        parts.assign(1, 0);
+    }
+    void EndPath() { paths.push_back(points.size()); }
+    // Многоугольник без колец (пустой Polygon в WKB) части не образует
+    void EndPart() {
+        if (paths.size() - 1 > parts.back()) {
+            parts.push_back(paths.size() - 1);
+        }
+    }
+    void AddPath(std::span<const Point2D> path) {
+        points.insert(points.end(), path.begin(), path.end());
+        EndPath();
+    }
+    [[nodiscard]] GeometryView View(GeometryType type) const noexcept { return {type, points, paths, parts}; }
+
+    std::vector<Point2D> points;
+    std::vector<size_t> paths{0};
+    std::vector<size_t> parts{0};
+};
+
+/**
+    @brief Разбор потока WKB
+
+    Порядок байтов задаётся в заголовке каждой геометрии, включая элементы Multi*, поэтому флаг
+    перестановки меняется при каждом заголовке. Пустая точка по соглашению записывается парой NaN.
+*/
+class WkbReader {
+public:
+    WkbReader(std::span<const uint8_t> data, const GeometryVisitor &visit) : data_(data), visit_(visit) {}
+
+    std::expected<size_t, std::string> Run() {
+        while (position_ < data_.size()) {
+            if (!Geometry(0)) {
+                return std::unexpected(std::move(error_));
+            }
+        }
+        return count_;
+    }
+
+private:
+    bool Fail(std::string message) {
+        error_ = std::move(message);
+        return false;
+    }
+
+    bool Need(size_t bytes) {
+        return data_.size() - position_ >= bytes || Fail(std::format("Truncated WKB at byte {}.", position_));
+    }
+
+    bool Uint32(uint32_t &value) {
+        if (!Need(sizeof(value))) {
+            return false;
+        }
+        std::memcpy(&value, data_.data() + position_, sizeof(value));
+        value = swap_ ? std::byteswap(value) : value;
+        position_ += sizeof(value);
+        return true;
+    }
+
+    bool Header(GeometryType &type) {
+        if (!Need(1)) {
+            return false;
+        }
+        const uint8_t order = data_[position_];
+        if (order > 1) {
+            return Fail(std::format("Invalid WKB byte order {} at byte {}.", order, position_));
+        }
+        swap_ = order != NATIVE_BYTE_ORDER;
+        ++position_;
+        uint32_t code = 0;
+        if (!Uint32(code)) {
+            return false;
+        }
+        if (code < 1 || code >= TYPE_NAMES.size()) {
+            return Fail(std::format("Unsupported WKB geometry type {}.", code));
+        }
+        type = static_cast<GeometryType>(code);
+        return true;
+    }
+
+    // Заголовок элемента Multi*: тип обязан совпадать с ожидаемым
+    bool Child(GeometryType expected) {
+        GeometryType type{};
+        if (!Header(type)) {
+            return false;
+        }
+        return type == expected || Fail(std::format("WKB {} contains a {}.", TypeName(expected), TypeName(type)));
+    }
+
+    bool Points(size_t count) {
+        if ((data_.size() - position_) / sizeof(Point2D) < count) {
+            return Fail(std::format("Truncated WKB at byte {}.", position_));
+        }
+        const size_t first = arena_.points.size();
+        arena_.points.resize(first + count);
+        Point2D *out = arena_.points.data() + first;
+        std::memcpy(out, data_.data() + position_, count * sizeof(Point2D));
+        if (swap_) {
+            for (size_t i = 0; i < count; ++i) {
+                out[i].x = std::bit_cast<double>(std::byteswap(std::bit_cast<uint64_t>(out[i].x)));
+                out[i].y = std::bit_cast<double>(std::byteswap(std::bit_cast<uint64_t>(out[i].y)));
+            }
+        }
+        position_ += count * sizeof(Point2D);
+        return true;
+    }
+
+    bool SinglePoint() {
+        if (!Points(1)) {
+            return false;
+        }
+        if (const Point2D &p = arena_.points.back(); std::isnan(p.x) && std::isnan(p.y)) {
+            arena_.points.pop_back();
+        }
+        return true;
+    }
+
+    bool Path() {
+        uint32_t count = 0;
+        if (!Uint32(count) || !Points(count)) {
+            return false;
+        }
+        arena_.EndPath();
+        return true;
+    }
+
+    bool Rings() {
+        uint32_t count = 0;
+        if (!Uint32(count)) {
+            return false;
+        }
+        for (uint32_t r = 0; r < count; ++r) {
+            if (!Path()) {
+                return false;
+            }
+        }
+        arena_.EndPart();
+        return true;
+    }
+
+    // Элементы Multi*: число, затем каждый элемент со своим заголовком
+    bool Elements(GeometryType element, bool (WkbReader::*body)()) {
+        uint32_t count = 0;
+        if (!Uint32(count)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            if (!Child(element) || !(this->*body)()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Body(GeometryType type) {
+        switch (type) {
+        case GeometryType::Point:
+            if (!SinglePoint()) {
+                return false;
+            }
+            arena_.EndPath();
+            return true;
+        case GeometryType::LineString:
+            return Path();
+        case GeometryType::Polygon:
+            return Rings();
+        case GeometryType::MultiPoint:
+            if (!Elements(GeometryType::Point, &WkbReader::SinglePoint)) {
+                return false;
+            }
+            arena_.EndPath();
+            return true;
+        case GeometryType::MultiLineString:
+            return Elements(GeometryType::LineString, &WkbReader::Path);
+        case GeometryType::MultiPolygon:
+            return Elements(GeometryType::Polygon, &WkbReader::Rings);
+        case GeometryType::GeometryCollection:
+            break;
+        }
+        return false;
+    }
+
+    bool Geometry(size_t depth) {
+        GeometryType type{};
+        if (!Header(type)) {
+            return false;
+        }
+        if (type == GeometryType::GeometryCollection) {
+            if (depth >= MAX_DEPTH) {
+                return Fail("WKB geometry collections are nested too deeply.");
+            }
+            uint32_t count = 0;
+            if (!Uint32(count)) {
+                return false;
+            }
+            for (uint32_t i = 0; i < count; ++i) {
+                if (!Geometry(depth + 1)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        arena_.Clear();
+        if (!Body(type)) {
+            return false;
+        }
+        visit_(arena_.View(type));
+        ++count_;
+        return true;
+    }
+
+    std::span<const uint8_t> data_;
+    const GeometryVisitor &visit_;
+    Arena arena_;
+    size_t position_ = 0;
+    size_t count_ = 0;
+    bool swap_ = false;
+    std::string error_;
+};
+
+// Общие для текстовых форматов операции над позицией в тексте
+class TextCursor {
+protected:
+    TextCursor(std::string_view text, std::string_view format) : text_(text), format_(format) {}
+
+    bool Fail(std::string message) {
+        error_ = std::move(message);
+        return false;
+    }
+
+    void SkipSpace() noexcept {
+        while (position_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[position_]))) {
+            ++position_;
+        }
+    }
+
+    [[nodiscard]] char Peek() noexcept {
+        SkipSpace();
+        return position_ < text_.size() ? text_[position_] : '\0';
+    }
+
+    bool TryChar(char c) noexcept {
+        if (Peek() != c || position_ == text_.size()) {
+            return false;
+        }
+        ++position_;
+        return true;
+    }
+
+    bool Expect(char c) {
+        return TryChar(c) || Fail(std::format("Expected '{}' at offset {} of {}.", c, position_, format_));
+    }
+
+    bool Number(double &value) {
+        SkipSpace();
+        const auto [end, error] = std::from_chars(text_.data() + position_, text_.data() + text_.size(), value);
+        if (error != std::errc{}) {
+            return Fail(std::format("Expected a number at offset {} of {}.", position_, format_));
+        }
+        position_ = static_cast<size_t>(end - text_.data());
+        return true;
+    }
+
+    std::string_view text_;
+    std::string_view format_;
+    size_t position_ = 0;
+    std::string error_;
+};
+
+/**
+    @brief Разбор WKT
+
+    MULTIPOINT принимается в обеих распространённых записях: с точками в скобках и без них.
+*/
+class WktReader : TextCursor {
+public:
+    WktReader(std::string_view text, const GeometryVisitor &visit) : TextCursor(text, "WKT"), visit_(visit) {}
+
+    std::expected<size_t, std::string> Run() {
+        while (true) {
+            while (TryChar(';')) {
+            }
+            if (position_ == text_.size()) {
+                return count_;
+            }
+            if (!Geometry(0)) {
+                return std::unexpected(std::move(error_));
+            }
+        }
+    }
+
+private:
+    std::string_view Word() noexcept {
+        SkipSpace();
+        const size_t start = position_;
+        while (position_ < text_.size() && std::isalpha(static_cast<unsigned char>(text_[position_]))) {
+            ++position_;
+        }
+        return text_.substr(start, position_ - start);
+    }
+
+    bool Coordinate() {
+        double x = 0, y = 0;
+        if (!Number(x) || !Number(y)) {
+            return false;
+        }
+        arena_.points.emplace_back(x, y);
+        return true;
+    }
+
+    // Список через запятую в скобках
+    template <typename Item>
+    bool List(Item item) {
+        if (!Expect('(')) {
+            return false;
+        }
+        do {
+            if (!item()) {
+                return false;
+            }
+        } while (TryChar(','));
+        return Expect(')');
+    }
+
+    bool Path() {
+        if (!List([this] { return Coordinate(); })) {
+            return false;
+        }
+        arena_.EndPath();
+        return true;
+    }
+
+    bool Rings() {
+        if (!List([this] { return Path(); })) {
+            return false;
+        }
+        arena_.EndPart();
+        return true;
+    }
+
+    bool Body(GeometryType type) {
+        switch (type) {
+        case GeometryType::Point:
+            if (!Expect('(') || !Coordinate() || !Expect(')')) {
+                return false;
+            }
+            arena_.EndPath();
+            return true;
+        case GeometryType::LineString:
+            return Path();
+        case GeometryType::Polygon:
+            return Rings();
+        case GeometryType::MultiPoint:
+            if (!List([this] { return Peek() == '(' ? List([this] { return Coordinate(); }) : Coordinate(); })) {
+                return false;
+            }
+            arena_.EndPath();
+            return true;
+        case GeometryType::MultiLineString:
+            return List([this] { return Path(); });
+        case GeometryType::MultiPolygon:
+            return List([this] { return Rings(); });
+        case GeometryType::GeometryCollection:
+            break;
+        }
+        return false;
+    }
+
+    bool Geometry(size_t depth) {
+        const size_t start = position_;
+        const std::string_view name = Word();
+        const auto type = FindType(name, true);
+        if (!type) {
+            return Fail(name.empty() ? std::format("Expected a geometry name at offset {} of WKT.", start)
+                                     : std::format("Unsupported WKT geometry type {}.", name));
+        }
+
+        const size_t after_name = position_;
+        const std::string_view tag = Word();
+        if (NameEquals(tag, "Z") || NameEquals(tag, "M") || NameEquals(tag, "ZM")) {
+            return Fail("WKT coordinates with Z or M are not supported.");
+        }
+        const bool empty = NameEquals(tag, "EMPTY");
+        if (!empty) {
+            position_ = after_name;
+        }
+
+        if (*type == GeometryType::GeometryCollection) {
+            if (empty) {
+                return true;
+            }
+            if (depth >= MAX_DEPTH) {
+                return Fail("WKT geometry collections are nested too deeply.");
+            }
+            return List([this, depth] { return Geometry(depth + 1); });
+        }
+        arena_.Clear();
+        if (!empty && !Body(*type)) {
+            return false;
+        }
+        visit_(arena_.View(*type));
+        ++count_;
+        return true;
+    }
+
+    const GeometryVisitor &visit_;
+    Arena arena_;
+    size_t count_ = 0;
+};
+
+/**
+    @brief Разбор GeoJSON
+
+    Объект с полем coordinates — геометрия, поля geometry, geometries и features обходятся рекурсивно,
+    остальные (properties, bbox, id и прочие) пропускаются без разбора содержимого. Порядок полей
+    произвольный. Координаты разбираются в пул сразу, а их глубина вложенности сверяется с типом, когда
+    объект закрыт: тип может идти и после coordinates. Высота позиции — 0, линии — 1, многоугольника — 2,
+    мультимногоугольника — 3; третья и следующие координаты позиции отбрасываются.
+*/
+class GeoJsonReader : TextCursor {
+public:
+    GeoJsonReader(std::string_view text, const GeometryVisitor &visit)
+        : TextCursor(text, "GeoJSON"), visit_(visit) {}
+
+    std::expected<size_t, std::string> Run() {
+        if (!Object(0)) {
+            return std::unexpected(std::move(error_));
+        }
+        if (Peek() != '\0') {
+            return std::unexpected(std::format("Unexpected data at offset {} of GeoJSON.", position_));
+        }
+        return count_;
+    }
+
+private:
+    // Высота пустого массива: он совместим с любой глубиной и не добавляет вершин
+    static constexpr int EMPTY = -1;
+
+    // Содержимое строки без раскрытия escape-последовательностей: ключи и типы GeoJSON их не содержат
+    bool String(std::string_view &value) {
+        if (!Expect('"')) {
+            return false;
+        }
+        const size_t start = position_;
+        while (position_ < text_.size() && text_[position_] != '"') {
+            position_ += text_[position_] == '\\' ? 2 : 1;
+        }
+        if (position_ >= text_.size()) {
+            return Fail("Unterminated string in GeoJSON.");
+        }
+        value = text_.substr(start, position_ - start);
+        ++position_;
+        return true;
+    }
+
+    template <typename Item>
+    bool Sequence(char open, char close, Item item) {
+        if (!Expect(open)) {
+            return false;
+        }
+        if (TryChar(close)) {
+            return true;
+        }
+        do {
+            if (!item()) {
+                return false;
+            }
+        } while (TryChar(','));
+        return Expect(close);
+    }
+
+    bool SkipValue(size_t depth) {
+        if (depth >= MAX_DEPTH) {
+            return Fail("GeoJSON is nested too deeply.");
+        }
+        std::string_view ignored;
+        switch (Peek()) {
+        case '{':
+            return Sequence('{', '}', [&] { return String(ignored) && Expect(':') && SkipValue(depth + 1); });
+        case '[':
+            return Sequence('[', ']', [&] { return SkipValue(depth + 1); });
+        case '"':
+            return String(ignored);
+        default: {
+            // Число, true, false или null
+            const size_t start = position_;
+            while (position_ < text_.size() &&
+                   (std::isalnum(static_cast<unsigned char>(text_[position_])) || text_[position_] == '-' ||
+                    text_[position_] == '+' || text_[position_] == '.')) {
+                ++position_;
+            }
+            return position_ > start || Fail(std::format("Unexpected character at offset {} of GeoJSON.", start));
+        }
+        }
+    }
+
+    bool Position() {
+        double x = 0, y = 0, ignored = 0;
+        if (!Number(x) || !Expect(',') || !Number(y)) {
+            return false;
+        }
+        while (TryChar(',')) {
+            if (!Number(ignored)) {
+                return false;
+            }
+        }
+        if (!Expect(']')) {
+            return false;
+        }
+        arena_.points.emplace_back(x, y);
+        return true;
+    }
+
+    bool Coordinates(int &height, size_t depth) {
+        if (depth >= MAX_DEPTH) {
+            return Fail("GeoJSON is nested too deeply.");
+        }
+        if (!Expect('[')) {
+            return false;
+        }
+        if (Peek() != '[' && Peek() != ']') {
+            height = 0;
+            return Position();
+        }
+        height = EMPTY;
+        if (TryChar(']')) {
+            return true;
+        }
+        do {
+            int child = EMPTY;
+            if (!Coordinates(child, depth + 1)) {
+                return false;
+            }
+            if (child == EMPTY) {
+                continue;
+            }
+            if (height != EMPTY && height != child + 1) {
+                return Fail(std::format("GeoJSON coordinate arrays of mixed depth at offset {}.", position_));
+            }
+            height = child + 1;
+            if (child == 1) {
+                arena_.EndPath();
+            } else if (child == 2) {
+                arena_.EndPart();
+            }
+        } while (TryChar(','));
+        return Expect(']');
+    }
+
+    // Геометрия, вложенные объекты или массив объектов
+    bool Nested(size_t depth) {
+        switch (Peek()) {
+        case '{':
+            return Object(depth + 1);
+        case '[':
+            return Sequence('[', ']', [&] { return Object(depth + 1); });
+        default:
+            return SkipValue(depth + 1);
+        }
+    }
+
+    bool Object(size_t depth) {
+        if (depth >= MAX_DEPTH) {
+            return Fail("GeoJSON is nested too deeply.");
+        }
+        std::string_view type_name;
+        bool has_coordinates = false;
+        int height = EMPTY;
+        size_t generation = 0;
+        const bool parsed = Sequence('{', '}', [&] {
+            std::string_view key;
+            if (!String(key) || !Expect(':')) {
+                return false;
+            }
+            if (key == "type") {
+                return String(type_name);
+            }
+            if (key == "coordinates") {
+                arena_.Clear();
+                has_coordinates = true;
+                generation = ++generation_;
+                return Coordinates(height, depth + 1);
+            }
+            if (key == "geometry" || key == "geometries" || key == "features") {
+                return Nested(depth);
+            }
+            return SkipValue(depth + 1);
+        });
+        if (!parsed || !has_coordinates) {
+            return parsed;
+        }
+        if (generation != generation_) {
+            return Fail("GeoJSON geometry contains another geometry.");
+        }
+
+        const auto type = FindType(type_name, false);
+        if (!type || *type == GeometryType::GeometryCollection) {
+            return Fail(std::format("Unsupported GeoJSON geometry type {}.", type_name));
+        }
+        static constexpr std::array<int, 7> HEIGHTS = {0, 0, 1, 2, 1, 2, 3};
+        if (height != EMPTY) {
+            if (height != HEIGHTS[static_cast<size_t>(*type)]) {
+                return Fail(std::format("GeoJSON {} coordinates have the wrong nesting depth.", type_name));
+            }
+            if (height <= 1) {
+                arena_.EndPath();
+            } else if (*type == GeometryType::Polygon) {
+                arena_.EndPart();
+            }
+        }
+        visit_(arena_.View(*type));
+        ++count_;
+        return true;
+    }
+
+    const GeometryVisitor &visit_;
+    Arena arena_;
+    size_t count_ = 0;
+    size_t generation_ = 0;
+};
+
+// WKB всегда пишется в порядке little-endian
+class WkbWriter {
+public:
+    explicit WkbWriter(std::vector<uint8_t> &out) noexcept : out_(out) {}
+
+    void Header(GeometryType type) {
+        out_.push_back(1);
+        Uint32(static_cast<uint32_t>(type));
+    }
+
+    void Uint32(uint32_t value) {
+        if constexpr (std::endian::native == std::endian::big) {
+            value = std::byteswap(value);
+        }
+        Append(&value, sizeof(value));
+    }
+
+    void Coordinate(const Point2D &p) {
+        if constexpr (std::endian::native == std::endian::big) {
+            for (double value : {p.x, p.y}) {
+                Uint64(std::byteswap(std::bit_cast<uint64_t>(value)));
+            }
+        } else {
+            Append(&p, sizeof(p));
+        }
+    }
+
+    void Path(std::span<const Point2D> path, bool close) {
+        Uint32(static_cast<uint32_t>(path.size() + (close ? 1 : 0)));
+        if constexpr (std::endian::native == std::endian::little) {
+            Append(path.data(), path.size_bytes());
+        } else {
+            for (const auto &p : path) {
+                Coordinate(p);
+            }
+        }
+        if (close) {
+            Coordinate(path.front());
+        }
+    }
+
+    void Rings(const GeometryView &view, size_t part) {
+        const size_t first = view.parts[part], last = view.parts[part + 1];
+        Uint32(static_cast<uint32_t>(last - first));
+        for (size_t r = first; r < last; ++r) {
+            Path(view.Path(r), NeedsClosing(view.Path(r)));
+        }
+    }
+
+private:
+    void Uint64(uint64_t value) { Append(&value, sizeof(value)); }
+
+    void Append(const void *data, size_t bytes) {
+        const size_t size = out_.size();
+        out_.resize(size + bytes);
+        std::memcpy(out_.data() + size, data, bytes);
+    }
+
+    std::vector<uint8_t> &out_;
+};
+
+/**
+    @brief Координаты в WKT или GeoJSON
+
+    Оба формата — вложенные списки; различаются скобки, разделители и запись вершины: «x y» в WKT
+    против «[x,y]» в GeoJSON. Отдельная точка в WKT, как и в GeoJSON, берётся в скобки.
+*/
+class CoordinateWriter {
+public:
+    CoordinateWriter(std::string &out, bool json) noexcept : out_(out), json_(json) {}
+
+    void Geometry(const GeometryView &view) {
+        switch (view.type) {
+        case GeometryType::Point:
+            Point(view.points.front());
+            break;
+        case GeometryType::LineString:
+            Path(view.Path(0), false);
+            break;
+        case GeometryType::Polygon:
+            Rings(view, 0);
+            break;
+        case GeometryType::MultiPoint:
+            List(view.points.size(), [&](size_t i) { Point(view.points[i]); });
+            break;
+        case GeometryType::MultiLineString:
+            List(view.PathCount(), [&](size_t i) { Path(view.Path(i), false); });
+            break;
+        case GeometryType::MultiPolygon: {
+            // Пустой многоугольник в списке WKT записать нельзя, он пропускается
+            std::vector<size_t> filled;
+            for (size_t j = 0; j < view.PartCount(); ++j) {
+                if (view.parts[j] < view.parts[j + 1]) {
+                    filled.push_back(j);
+                }
+            }
+            List(filled.size(), [&](size_t k) { Rings(view, filled[k]); });
+            break;
+        }
+        case GeometryType::GeometryCollection:
+            break;
+        }
+    }
+
+private:
+    void Number(double value) {
+        // В JSON нет NaN и бесконечностей
+        if (json_ && !std::isfinite(value)) {
+            out_ += "null";
+            return;
+        }
+        char buffer[MAX_NUMBER];
+        out_.append(buffer, std::to_chars(buffer, buffer + MAX_NUMBER, value).ptr);
+    }
+
+    void Vertex(const Point2D &p) {
+        if (json_) {
+            out_ += '[';
+        }
+        Number(p.x);
+        out_ += json_ ? ',' : ' ';
+        Number(p.y);
+        if (json_) {
+            out_ += ']';
+        }
+    }
+
+    void Point(const Point2D &p) {
+        if (json_) {
+            Vertex(p);
+            return;
+        }
+        out_ += '(';
+        Vertex(p);
+        out_ += ')';
+    }
+
+    template <typename Item>
+    void List(size_t count, Item item) {
+        out_ += json_ ? '[' : '(';
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0) {
+                out_ += json_ ? "," : ", ";
+            }
+            item(i);
+        }
+        out_ += json_ ? ']' : ')';
+    }
+
+    void Path(std::span<const Point2D> path, bool close) {
+        List(path.size() + (close ? 1 : 0), [&](size_t i) { Vertex(i < path.size() ? path[i] : path.front()); });
+    }
+
+    void Rings(const GeometryView &view, size_t part) {
+        const size_t first = view.parts[part];
+        List(view.parts[part + 1] - first, [&](size_t r) {
+            const auto ring = view.Path(first + r);
+            Path(ring, NeedsClosing(ring));
+        });
+    }
+
+    std::string &out_;
+    bool json_;
+};
+
+// Пустая геометрия: без вершин либо, у многоугольников, без колец
+bool IsEmpty(const GeometryView &view) noexcept {
+    return IsPolygonal(view.type) ? view.PartCount() == 0 || view.parts.front() == view.parts.back()
+                                  : view.points.empty();
+}
+
+// Фигура в виде геометрии формата обмена
+template <typename T>
+GeometryType AddShape(const T &shape, Arena &arena) {
+    if constexpr (std::is_same_v<T, Line>) {
+        arena.AddPath(shape.Vertices());
+        return GeometryType::LineString;
+    } else if constexpr (std::is_same_v<T, InstancedShape>) {
+        return std::visit([&arena](const auto &s) { return AddShape(s, arena); },
+                          Transformed(shape.Prototype(), shape.GetTransform()));
+    } else if constexpr (std::is_same_v<T, MultiPolygon>) {
+        for (size_t part = 0; part < shape.PartCount(); ++part) {
+            const auto [first, last] = shape.PartRings(part);
+            for (size_t r = first; r < last; ++r) {
+                arena.AddPath(shape.Ring(r));
+            }
+            arena.EndPart();
+        }
+        return GeometryType::MultiPolygon;
+    } else if constexpr (std::is_base_of_v<RingSet, T>) {
+        for (size_t r = 0; r < shape.RingCount(); ++r) {
+            arena.AddPath(shape.Ring(r));
+        }
+        arena.EndPart();
+        return GeometryType::Polygon;
+    } else if constexpr (std::is_same_v<T, Circle>) {
+        arena.AddPath(shape.Vertices(CIRCLE_VERTICES));
+        arena.EndPart();
+        return GeometryType::Polygon;
+    } else {
+        const auto vertices = shape.Vertices();
+        arena.AddPath(vertices);
+        arena.EndPart();
+        return GeometryType::Polygon;
+    }
+}
+
+// Каждая геометрия набора, включая завершающий MultiPoint с точками
+template <typename Write>
+void ForEachGeometry(std::span<const Shape> shapes, std::span<const Point2D> points, Write write) {
+    Arena arena;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        arena.Clear();
+        const GeometryType type = std::visit([&arena](const auto &s) { return AddShape(s, arena); }, shapes[i]);
+        write(arena.View(type), i);
+    }
+    if (!points.empty()) {
+        const std::array<size_t, 2> paths = {0, points.size()};
+        write(GeometryView{GeometryType::MultiPoint, points, paths, {}}, shapes.size());
+    }
+}
+
+template <typename Read, typename Input>
+std::expected<Geometries, std::string> Decode(Read read, Input input) {
+    Geometries result;
+    if (auto count = read(input, [&result](const GeometryView &view) { AppendShapes(view, result); }); !count) {
+        return std::unexpected(std::move(count.error()));
+    }
+    return result;
+}
+
+}  // namespace
+
+std::expected<size_t, std::string> ReadWkb(std::span<const uint8_t> data, const GeometryVisitor &visit) {
+    return WkbReader(data, visit).Run();
+}
+
+std::expected<size_t, std::string> ReadWkt(std::string_view text, const GeometryVisitor &visit) {
+    return WktReader(text, visit).Run();
+}
+
+std::expected<size_t, std::string> ReadGeoJson(std::string_view text, const GeometryVisitor &visit) {
+    return GeoJsonReader(text, visit).Run();
+}
+
+void AppendShapes(const GeometryView &view, Geometries &out) {
+    switch (view.type) {
+    case GeometryType::Point:
+    case GeometryType::MultiPoint:
+        out.points.insert(out.points.end(), view.points.begin(), view.points.end());
+        break;
+    case GeometryType::LineString:
+    case GeometryType::MultiLineString:
+        for (size_t i = 0; i < view.PathCount(); ++i) {
+            const auto path = view.Path(i);
+            for (size_t k = 0; k + 1 < path.size(); ++k) {
+                out.shapes.emplace_back(Line(path[k], path[k + 1]));
+            }
+        }
+        break;
+    case GeometryType::Polygon:
+    case GeometryType::MultiPolygon: {
+        std::vector<PolygonWithHoles> polygons;
+        for (size_t j = 0; j < view.PartCount(); ++j) {
+            if (view.parts[j] == view.parts[j + 1]) {
+                continue;
+            }
+            auto outer = OpenRing(view.Path(view.parts[j]));
+            if (outer.size() < 3) {
+                continue;
+            }
+            std::vector<std::vector<Point2D>> holes;
+            for (size_t r = view.parts[j] + 1; r < view.parts[j + 1]; ++r) {
+                if (auto hole = OpenRing(view.Path(r)); hole.size() >= 3) {
+                    holes.push_back(std::move(hole));
+                }
+            }
+            if (view.type == GeometryType::MultiPolygon) {
+                polygons.emplace_back(outer, holes);
+            } else if (holes.empty()) {
+                out.shapes.emplace_back(Polygon(std::move(outer)));
+            } else {
+                out.shapes.emplace_back(PolygonWithHoles(outer, holes));
+            }
+        }
+        if (!polygons.empty()) {
+            out.shapes.emplace_back(MultiPolygon(polygons));
+        }
+        break;
+    }
+    case GeometryType::GeometryCollection:
+        break;
+    }
+}
+
+std::expected<Geometries, std::string> DecodeWkb(std::span<const uint8_t> data) { return Decode(ReadWkb, data); }
+
+std::expected<Geometries, std::string> DecodeWkt(std::string_view text) { return Decode(ReadWkt, text); }
+
+std::expected<Geometries, std::string> DecodeGeoJson(std::string_view text) { return Decode(ReadGeoJson, text); }
+
+void WriteWkb(const GeometryView &view, std::vector<uint8_t> &out) {
+    WkbWriter w(out);
+    w.Header(view.type);
+    switch (view.type) {
+    case GeometryType::Point:
+        w.Coordinate(view.points.empty() ? Point2D(std::numeric_limits<double>::quiet_NaN(),
+                                                   std::numeric_limits<double>::quiet_NaN())
+                                         : view.points.front());
+        break;
+    case GeometryType::LineString:
+        w.Path(IsEmpty(view) ? std::span<const Point2D>{} : view.Path(0), false);
+        break;
+    case GeometryType::Polygon:
+        if (IsEmpty(view)) {
+            w.Uint32(0);
+        } else {
+            w.Rings(view, 0);
+        }
+        break;
+    case GeometryType::MultiPoint:
+        w.Uint32(static_cast<uint32_t>(view.points.size()));
+        for (const auto &p : view.points) {
+            w.Header(GeometryType::Point);
+            w.Coordinate(p);
+        }
+        break;
+    case GeometryType::MultiLineString:
+        w.Uint32(static_cast<uint32_t>(view.PathCount()));
+        for (size_t i = 0; i < view.PathCount(); ++i) {
+            w.Header(GeometryType::LineString);
+            w.Path(view.Path(i), false);
+        }
+        break;
+    case GeometryType::MultiPolygon:
+        w.Uint32(static_cast<uint32_t>(view.PartCount()));
+        for (size_t j = 0; j < view.PartCount(); ++j) {
+            w.Header(GeometryType::Polygon);
+            w.Rings(view, j);
+        }
+        break;
+    case GeometryType::GeometryCollection:
+        w.Uint32(0);
+        break;
+    }
+}
+
+void WriteWkt(const GeometryView &view, std::string &out) {
+    for (char c : TypeName(view.type)) {
+        out += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    if (IsEmpty(view)) {
+        out += " EMPTY";
+        return;
+    }
+    out += ' ';
+    CoordinateWriter(out, false).Geometry(view);
+}
+
+void WriteGeoJson(const GeometryView &view, std::string &out) {
+    out += R"({"type":")";
+    out += TypeName(view.type);
+    out += R"(","coordinates":)";
+    if (IsEmpty(view)) {
+        out += "[]";
+    } else {
+        CoordinateWriter(out, true).Geometry(view);
+    }
+    out += '}';
+}
+
+std::vector<uint8_t> EncodeWkb(std::span<const Shape> shapes, std::span<const Point2D> points) {
+    std::vector<uint8_t> out;
+    ForEachGeometry(shapes, points, [&out](const GeometryView &view, size_t) { WriteWkb(view, out); });
+    return out;
+}
+
+std::string EncodeWkt(std::span<const Shape> shapes, std::span<const Point2D> points) {
+    std::string out;
+    ForEachGeometry(shapes, points, [&out](const GeometryView &view, size_t) {
+        WriteWkt(view, out);
+        out += '\n';
+    });
+    return out;
+}
+
+std::string EncodeGeoJson(std::span<const Shape> shapes, std::span<const Point2D> points) {
+    std::string out = R"({"type":"FeatureCollection","features":[)";
+    ForEachGeometry(shapes, points, [&](const GeometryView &view, size_t index) {
+        out += index == 0 ? "\n" : ",\n";
+        out += R"({"type":"Feature","properties":)";
+        out += index < shapes.size() ? R"({"index":)" + std::to_string(index) + "}" : "{}";
+        out += R"(,"geometry":)";
+        WriteGeoJson(view, out);
+        out += '}';
+    });
+    out += "\n]}\n";
+    return out;
+}
+
+std::expected<MappedFile, std::string> MappedFile::Open(const std::string &path) {
+#ifdef __linux__
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::unexpected("Cannot open " + path + " for reading.");
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return std::unexpected("Cannot read " + path + ".");
+    }
+    const auto size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+        ::close(fd);
+        return MappedFile(nullptr, 0);
+    }
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return std::unexpected("Cannot map " + path + " into memory.");
+    }
+    // Декодеры читают файл один раз от начала до конца
+    madvise(data, size, MADV_SEQUENTIAL);
+    return MappedFile(static_cast<const uint8_t *>(data), size);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return std::unexpected("Cannot open " + path + " for reading.");
+    }
+    const auto size = static_cast<size_t>(file.tellg());
+    auto *data = size == 0 ? nullptr : new uint8_t[size];
+    file.seekg(0);
+    if (size > 0 && !file.read(reinterpret_cast<char *>(data), static_cast<std::streamsize>(size))) {
+        delete[] data;
+        return std::unexpected("Cannot read " + path + ".");
+    }
+    return MappedFile(data, size);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    MappedFile released(std::move(other));
+    std::swap(data_, released.data_);
+    std::swap(size_, released.size_);
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    if (data_ == nullptr) {
+        return;
+    }
+#ifdef __linux__
+    munmap(const_cast<uint8_t *>(data_), size_);
+#else
+    delete[] data_;
+#endif
+}
+
+}  // namespace geometry::io
@@ -0,0 +1,214 @@
+#include "heatmap.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+namespace geometry::visualization {
+
+namespace {
+
+// Меньше этого точек на блок распараллеливание не окупается
+constexpr size_t MIN_POINTS_PER_BLOCK = 1 << 14;
+constexpr size_t ROW_GRAIN = 16;
+
+// Опорные цвета viridis через равные промежутки
+constexpr std::array<Rgb, 9> VIRIDIS{{{68, 1, 84},
+                                      {71, 44, 122},
+                                      {59, 81, 139},
+                                      {44, 113, 142},
+                                      {33, 144, 141},
+                                      {39, 173, 129},
+                                      {92, 200, 99},
+                                      {170, 220, 50},
+                                      {253, 231, 37}}};
+
+Rgb Viridis(double t) noexcept {
+    const double pos = std::clamp(t, 0.0, 1.0) * static_cast<double>(VIRIDIS.size() - 1);
+    const size_t i = std::min(static_cast<size_t>(pos), VIRIDIS.size() - 2);
+    const double f = pos - static_cast<double>(i);
+    auto mix = [f](uint8_t a, uint8_t b) {
+        return static_cast<uint8_t>(std::lround(a + f * (static_cast<double>(b) - a)));
+    };
+    return {mix(VIRIDIS[i].r, VIRIDIS[i + 1].r), mix(VIRIDIS[i].g, VIRIDIS[i + 1].g),
+            mix(VIRIDIS[i].b, VIRIDIS[i + 1].b)};
+}
+
+BoundingBox BoundsOf(std::span<const Point2D> points) noexcept {
+    if (points.empty()) {
+        return {0, 0, 1, 1};
+    }
+    BoundingBox box{points[0].x, points[0].y, points[0].x, points[0].y};
+    for (const auto &p : points) {
+        box = {std::min(box.min_x, p.x), std::min(box.min_y, p.y), std::max(box.max_x, p.x),
+               std::max(box.max_y, p.y)};
+    }
+    // Все точки на одной прямой: расширяем, чтобы у сетки был ненулевой шаг
+    if (box.Width() == 0) {
+        box = {box.min_x - 0.5, box.min_y, box.max_x + 0.5, box.max_y};
+    }
+    if (box.Height() == 0) {
+        box = {box.min_x, box.min_y - 0.5, box.max_x, box.max_y + 0.5};
+    }
+    return box;
+}
+
+}  // namespace
+
+double DensityGrid::Total() const noexcept { return std::accumulate(values.begin(), values.end(), 0.0); }
+
+double DensityGrid::Max() const noexcept { return values.empty() ? 0.0 : std::ranges::max(values); }
+
+DensityGrid BinPoints(std::span<const Point2D> points, const HeatmapOptions &options) {
+    DensityGrid grid;
+    grid.extent = options.extent.value_or(BoundsOf(points));
+    grid.width = std::max<size_t>(options.width, 1);
+    grid.height = std::max<size_t>(options.height, 1);
+    const size_t cells = grid.width * grid.height;
+    grid.values.assign(cells, 0.0);
+
+    const size_t threads = parallel::ResolveThreadCount(options.threads);
+    const size_t grain = std::max(MIN_POINTS_PER_BLOCK, (points.size() + threads - 1) / threads);
+    const size_t workers = std::clamp<size_t>((points.size() + grain - 1) / grain, 1, threads);
+
+    // Счётчики целые: сумма целых не зависит от порядка, и результат не зависит от числа потоков
+    std::vector<uint32_t> bins(workers * cells, 0);
+    std::vector<size_t> outside(workers, 0);
+    const BoundingBox &e = grid.extent;
+    const double sx = static_cast<double>(grid.width) / e.Width();
+    const double sy = static_cast<double>(grid.height) / e.Height();
+
+    parallel::ParallelFor(
+        points.size(), grain,
+        [&](size_t begin, size_t end, size_t worker) {
+            uint32_t *local = bins.data() + worker * cells;
+            for (size_t i = begin; i < end; ++i) {
+                const Point2D &p = points[i];
+                // Сравнения записаны так, чтобы NaN тоже считался снаружи
+                if (!(p.x >= e.min_x && p.x <= e.max_x && p.y >= e.min_y && p.y <= e.max_y)) {
+                    ++outside[worker];
+                    continue;
+                }
+                const size_t cx = std::min(static_cast<size_t>((p.x - e.min_x) * sx), grid.width - 1);
+                const size_t cy = std::min(static_cast<size_t>((p.y - e.min_y) * sy), grid.height - 1);
+                ++local[cy * grid.width + cx];
+            }
+        },
+        workers);
+
+    parallel::ParallelFor(
+        cells, std::max<size_t>(cells / (4 * threads), 1024),
+        [&](size_t begin, size_t end, size_t) {
+            for (size_t w = 0; w < workers; ++w) {
+                const uint32_t *local = bins.data() + w * cells;
+                for (size_t c = begin; c < end; ++c) {
+                    grid.values[c] += local[c];
+                }
+            }
+        },
+        threads);
+    grid.outside = std::accumulate(outside.begin(), outside.end(), size_t{0});
+    return grid;
+}
+
+DensityGrid BinShapes(std::span<const Shape> shapes, ShapePoints source, const HeatmapOptions &options) {
+    std::vector<Point2D> points;
+    if (source == ShapePoints::Centers) {
+        points.resize(shapes.size(), Point2D{0, 0});
+        parallel::ParallelFor(
+            shapes.size(), MIN_POINTS_PER_BLOCK,
+            [&](size_t begin, size_t end, size_t) {
+                for (size_t i = begin; i < end; ++i) {
+                    points[i] = std::visit([](const auto &s) -> Point2D { return s.Center(); }, shapes[i]);
+                }
+            },
+            options.threads);
+    } else {
+        for (const auto &shape : shapes) {
+            std::visit(
+                [&points](const auto &s) {
+                    const auto vertices = s.Vertices();
+                    points.insert(points.end(), vertices.begin(), vertices.end());
+                },
+                shape);
+        }
+    }
+    return BinPoints(points, options);
+}
+
+void GaussianBlur(DensityGrid &grid, double sigma, size_t threads) {
+    if (sigma <= 0.0 || grid.values.empty()) {
+        return;
+    }
+    const auto radius = static_cast<ptrdiff_t>(std::ceil(3.0 * sigma));
+    std::vector<double> kernel(static_cast<size_t>(2 * radius + 1));
+    for (ptrdiff_t k = -radius; k <= radius; ++k) {
+        kernel[static_cast<size_t>(k + radius)] = std::exp(-static_cast<double>(k * k) / (2.0 * sigma * sigma));
+    }
+    const double norm = std::accumulate(kernel.begin(), kernel.end(), 0.0);
+    for (double &w : kernel) {
+        w /= norm;
+    }
+
+    const auto width = static_cast<ptrdiff_t>(grid.width), height = static_cast<ptrdiff_t>(grid.height);
+    std::vector<double> rows(grid.values.size(), 0.0);
+
+    // Горизонтальный проход: grid.values -> rows
+    parallel::ParallelFor(
+        grid.height, ROW_GRAIN,
+        [&](size_t begin, size_t end, size_t) {
+            for (auto y = static_cast<ptrdiff_t>(begin); y < static_cast<ptrdiff_t>(end); ++y) {
+                const double *src = grid.values.data() + y * width;
+                double *dst = rows.data() + y * width;
+                for (ptrdiff_t x = 0; x < width; ++x) {
+                    double sum = 0.0;
+                    for (ptrdiff_t k = std::max(-radius, -x); k <= std::min(radius, width - 1 - x); ++k) {
+                        sum += kernel[static_cast<size_t>(k + radius)] * src[x + k];
+                    }
+                    dst[x] = sum;
+                }
+            }
+        },
+        threads);
+
+    // Вертикальный проход: rows -> grid.values; строка результата складывается из целых строк источника
+    parallel::ParallelFor(
+        grid.height, ROW_GRAIN,
+        [&](size_t begin, size_t end, size_t) {
+            for (auto y = static_cast<ptrdiff_t>(begin); y < static_cast<ptrdiff_t>(end); ++y) {
+                double *dst = grid.values.data() + y * width;
+                std::fill_n(dst, width, 0.0);
+                for (ptrdiff_t k = std::max(-radius, -y); k <= std::min(radius, height - 1 - y); ++k) {
+                    const double w = kernel[static_cast<size_t>(k + radius)];
+                    const double *src = rows.data() + (y + k) * width;
+                    for (ptrdiff_t x = 0; x < width; ++x) {
+                        dst[x] += w * src[x];
+                    }
+                }
+            }
+        },
+        threads);
+}
+
+Image Colorize(const DensityGrid &grid, bool log_scale) {
+    Image image{grid.width, grid.height, std::vector<Rgb>(grid.width * grid.height)};
+    const double max = grid.Max();
+    const double scale = max <= 0.0 ? 0.0 : 1.0 / (log_scale ? std::log1p(max) : max);
+    for (size_t y = 0; y < grid.height; ++y) {
+        for (size_t x = 0; x < grid.width; ++x) {
+            const double v = std::max(grid.At(x, y), 0.0);
+            image.At(x, grid.height - 1 - y) = Viridis((log_scale ? std::log1p(v) : v) * scale);
+        }
+    }
+    return image;
+}
+
+Image RenderHeatmap(std::span<const Point2D> points, const HeatmapOptions &options) {
+    auto grid = BinPoints(points, options);
+    GaussianBlur(grid, options.bandwidth, options.threads);
+    return Colorize(grid, options.log_scale);
+}
+
+}  // namespace geometry::visualization
@@ -0,0 +1,128 @@
+#include "image.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+namespace geometry::visualization {
+
+namespace {
+
+// Наибольшая длина несжатого блока deflate
+constexpr size_t STORED_BLOCK = 65535;
+
+constexpr std::array<uint32_t, 256> CRC_TABLE = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t n = 0; n < 256; ++n) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[n] = c;
+    }
+    return table;
+}();
+
+uint32_t Crc32(const uint8_t *data, size_t size) noexcept {
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        c = CRC_TABLE[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+uint32_t Adler32(const std::vector<uint8_t> &data) noexcept {
+    constexpr uint32_t MOD = 65521;
+    // 5552 — наибольшая длина, на которой суммы гарантированно не переполняют 32 бита
+    constexpr size_t CHUNK = 5552;
+    uint32_t a = 1, b = 0;
+    for (size_t begin = 0; begin < data.size(); begin += CHUNK) {
+        const size_t end = std::min(begin + CHUNK, data.size());
+        for (size_t i = begin; i < end; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= MOD;
+        b %= MOD;
+    }
+    return (b << 16) | a;
+}
+
+void PutBigEndian(std::vector<uint8_t> &out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v >> 24));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+void PutChunk(std::vector<uint8_t> &out, const char (&type)[5], const std::vector<uint8_t> &data) {
+    PutBigEndian(out, static_cast<uint32_t>(data.size()));
+    const size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    PutBigEndian(out, Crc32(out.data() + start, out.size() - start));
+}
+
+}  // namespace
+
+/**
+    @brief Кодирует кадр в PNG
+
+    Каждая строка получает байт фильтра 0 (без фильтра), весь поток пикселей упаковывается в zlib-поток
+    из несжатых блоков deflate. Файл получается размером примерно 3 * width * height байт, зато кодирование —
+    одно копирование памяти, а любой просмотрщик PNG его читает.
+*/
+std::vector<uint8_t> EncodePng(const Image &image) {
+    std::vector<uint8_t> raw;
+    raw.reserve(image.height * (1 + 3 * image.width));
+    for (size_t y = 0; y < image.height; ++y) {
+        raw.push_back(0);
+        for (size_t x = 0; x < image.width; ++x) {
+            const Rgb &p = image.At(x, y);
+            raw.insert(raw.end(), {p.r, p.g, p.b});
+        }
+    }
+
+    std::vector<uint8_t> zlib{0x78, 0x01};
+    zlib.reserve(raw.size() + raw.size() / STORED_BLOCK * 5 + 16);
+    size_t begin = 0;
+    do {
+        const size_t size = std::min(STORED_BLOCK, raw.size() - begin);
+        const bool last = begin + size == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(size));
+        zlib.push_back(static_cast<uint8_t>(size >> 8));
+        zlib.push_back(static_cast<uint8_t>(~size));
+        zlib.push_back(static_cast<uint8_t>(~size >> 8));
+        zlib.insert(zlib.end(), raw.begin() + static_cast<ptrdiff_t>(begin),
+                    raw.begin() + static_cast<ptrdiff_t>(begin + size));
+        begin += size;
+    } while (begin < raw.size());
+    PutBigEndian(zlib, Adler32(raw));
+
+    std::vector<uint8_t> header;
+    PutBigEndian(header, static_cast<uint32_t>(image.width));
+    PutBigEndian(header, static_cast<uint32_t>(image.height));
+    // 8 бит на канал, RGB, стандартные сжатие и фильтрация, без чересстрочности
+    header.insert(header.end(), {8, 2, 0, 0, 0});
+
+    std::vector<uint8_t> png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    PutChunk(png, "IHDR", header);
+    PutChunk(png, "IDAT", zlib);
+    PutChunk(png, "IEND", {});
+    return png;
+}
+
+std::expected<void, std::string> SavePng(const Image &image, std::string_view filename) {
+    const auto png = EncodePng(image);
+    std::ofstream file{std::string(filename), std::ios::binary};
+    if (!file) {
+        return std::unexpected("Cannot open " + std::string(filename) + " for writing.");
+    }
+    file.write(reinterpret_cast<const char *>(png.data()), static_cast<std::streamsize>(png.size()));
+    if (!file) {
+        return std::unexpected("Failed to write " + std::string(filename) + ".");
+    }
+    return {};
+}
+
+}  // namespace geometry::visualization
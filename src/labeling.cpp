@@ -0,0 +1,185 @@
+#include "labeling.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <queue>
+#include <type_traits>
+
+namespace geometry::labeling {
+
+namespace {
+
+constexpr double DEFAULT_RELATIVE_PRECISION = 1e-3;
+constexpr size_t LABEL_GRAIN = 16;
+
+using Rings = std::span<const std::span<const Point2D>>;
+
+// Расстояние до границы со знаком: положительное внутри (чётно-нечётное правило по всем контурам,
+// так что дыры и отдельные части многоугольника учитываются без знания их ролей)
+double SignedDistance(const Point2D &p, Rings rings) noexcept {
+    bool inside = false;
+    double min_sq = std::numeric_limits<double>::infinity();
+
+    for (const auto ring : rings) {
+        for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+            const Point2D &a = ring[i], &b = ring[j];
+            if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x) {
+                inside = !inside;
+            }
+
+            const Point2D edge = b - a;
+            const double length_sq = edge.Dot(edge);
+            const double t = length_sq > 0 ? std::clamp((p - a).Dot(edge) / length_sq, 0.0, 1.0) : 0.0;
+            const Point2D d = p - (a + edge * t);
+            min_sq = std::min(min_sq, d.Dot(d));
+        }
+    }
+    return (inside ? 1.0 : -1.0) * std::sqrt(min_sq);
+}
+
+// Центр масс контура; для вырожденного контура — его первая вершина
+Point2D Centroid(std::span<const Point2D> ring) noexcept {
+    double area = 0.0;
+    Point2D sum{0, 0};
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        const double cross = ring[j].Cross(ring[i]);
+        area += cross;
+        sum = sum + (ring[j] + ring[i]) * cross;
+    }
+    return area != 0.0 ? sum / (3.0 * area) : ring.front();
+}
+
+struct Cell {
+    Point2D center;
+    double half;      // Половина стороны ячейки
+    double distance;  // Расстояние от центра до границы со знаком
+    double bound;     // Верхняя оценка расстояния для любой точки ячейки
+
+    Cell(const Point2D &c, double h, Rings rings)
+        : center(c), half(h), distance(SignedDistance(c, rings)), bound(distance + h * std::numbers::sqrt2) {}
+
+    [[nodiscard]] bool operator<(const Cell &other) const noexcept { return bound < other.bound; }
+};
+
+/**
+    @brief Полюс недоступности подразделением ячеек с приоритетом по верхней оценке (polylabel)
+
+    Ни одна точка ячейки не может быть дальше от границы, чем её центр плюс половина диагонали.
+    Ячейки обходятся в порядке убывания этой оценки и делятся на четыре, пока оценка превосходит лучший
+    найденный центр больше чем на precision; остальные отбрасываются без деления.
+    Первый контур задаёт стартового кандидата — центр масс.
+*/
+Point2D Polylabel(Rings rings, double precision) {
+    const auto ring = rings.front();
+    BoundingBox box{ring.front().x, ring.front().y, ring.front().x, ring.front().y};
+    for (const auto r : rings) {
+        for (const auto &p : r) {
+            box.min_x = std::min(box.min_x, p.x);
+            box.min_y = std::min(box.min_y, p.y);
+            box.max_x = std::max(box.max_x, p.x);
+            box.max_y = std::max(box.max_y, p.y);
+        }
+    }
+    const double cell_size = std::min(box.Width(), box.Height());
+    if (cell_size <= 0.0) {
+        return ring.front();
+    }
+    if (precision <= 0.0) {
+        precision = std::max(box.Width(), box.Height()) * DEFAULT_RELATIVE_PRECISION;
+    }
+
+    std::priority_queue<Cell> queue;
+    const double half = cell_size / 2;
+    for (double x = box.min_x; x < box.max_x; x += cell_size) {
+        for (double y = box.min_y; y < box.max_y; y += cell_size) {
+            queue.emplace(Point2D{x + half, y + half}, half, rings);
+        }
+    }
+
+    // Стартовые кандидаты: центр масс (хорош для выпуклых фигур) и центр bounding box
+    Cell best(Centroid(ring), 0.0, rings);
+    if (const Cell center(box.Center(), 0.0, rings); center.distance > best.distance) {
+        best = center;
+    }
+
+    while (!queue.empty()) {
+        const Cell cell = queue.top();
+        queue.pop();
+        if (cell.distance > best.distance) {
+            best = cell;
+        }
+        if (cell.bound - best.distance <= precision) {
+            continue;
+        }
+        const double h = cell.half / 2;
+        for (const Point2D offset : {Point2D{-h, -h}, Point2D{h, -h}, Point2D{-h, h}, Point2D{h, h}}) {
+            queue.emplace(cell.center + offset, h, rings);
+        }
+    }
+    return best.center;
+}
+
+}  // namespace
+
+Point2D PoleOfInaccessibility(std::span<const Point2D> ring, double precision) {
+    if (ring.empty()) {
+        return {0, 0};
+    }
+    const std::span<const Point2D> rings[] = {ring};
+    return Polylabel(rings, precision);
+}
+
+Point2D PoleOfInaccessibility(const RingSet &rings, double precision) {
+    std::vector<std::span<const Point2D>> spans;
+    for (size_t r = 0; r < rings.RingCount(); ++r) {
+        if (!rings.Ring(r).empty()) {
+            spans.push_back(rings.Ring(r));
+        }
+    }
+    if (spans.empty()) {
+        return {0, 0};
+    }
+    return Polylabel(spans, precision);
+}
+
+namespace {
+
+template <typename T>
+Point2D LabelPointOf(const T &s, double precision) {
+    if constexpr (std::is_same_v<T, Polygon>) {
+        return PoleOfInaccessibility(s.Vertices(), precision);
+    } else if constexpr (std::is_base_of_v<RingSet, T>) {
+        return PoleOfInaccessibility(s, precision);
+    } else if constexpr (std::is_same_v<T, InstancedShape>) {
+        // Точность задана в мировых координатах, а полюс ищется в координатах прототипа
+        const auto &transform = s.GetTransform();
+        return transform.Apply(std::visit(
+            [&](const auto &prototype) { return LabelPointOf(prototype, precision / transform.scale); },
+            s.Prototype()));
+    } else {
+        return s.Center();
+    }
+}
+
+}  // namespace
+
+Point2D LabelPoint(const Shape &shape, double precision) {
+    return std::visit([precision](const auto &s) { return LabelPointOf(s, precision); }, shape);
+}
+
+std::vector<Point2D> LabelPoints(std::span<const Shape> shapes, double precision, size_t threads) {
+    std::vector<Point2D> points(shapes.size());
+    parallel::ParallelFor(
+        shapes.size(), LABEL_GRAIN,
+        [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                points[i] = LabelPoint(shapes[i], precision);
+            }
+        },
+        threads);
+    return points;
+}
+
+}  // namespace geometry::labeling
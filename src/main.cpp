@@ -1,6 +1,7 @@
 #include "convex_hull.hpp"
 #include "geometry.hpp"
 #include "intersections.hpp"
+#include "point_set.hpp"
 #include "queries.hpp"
 #include "shape_utils.hpp"
 #include "triangulation.hpp"
@@ -13,6 +14,9 @@
 
 using namespace geometry;
 
+// Точки ближе этого расстояния считаем одной вершиной
+constexpr double WELD_TOLERANCE = 1e-9;
+
 namespace rng = std::ranges;
 namespace views = std::ranges::views;
 
@@ -200,6 +204,10 @@ int main() {
 
     std::println("\nCollected {} points from all shapes", points.size());
 
+    // Сливаем совпадающие вершины соседних фигур, чтобы не раздувать сортировку и не плодить вырожденные треугольники
+    points = point_set::WeldVertices(points, WELD_TOLERANCE).points;
+    std::println("{} unique points after welding", points.size());
+
     //
     // Находим выпуклую оболочку, добавляем её в shapes и рисуем итоговый вариант
     //
@@ -222,6 +230,7 @@ int main() {
     //
     {
         std::vector<Point2D> points = {{0, 0}, {10, 0}, {5, 8}, {15, 5}, {2, 12}};
+        points = point_set::WeldVertices(points, WELD_TOLERANCE).points;
         auto triangulation_result = triangulation::DelaunayTriangulation(points);
 
         if (triangulation_result.has_value()) {
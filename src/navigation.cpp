@@ -0,0 +1,571 @@
+#include "navigation.hpp"
+#include "parallel.hpp"
+#include "queries.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <numbers>
+#include <queue>
+#include <set>
+#include <unordered_map>
+
+namespace geometry::navigation {
+
+namespace {
+
+constexpr double EPS = 1e-9;
+constexpr size_t NONE = std::numeric_limits<size_t>::max();
+constexpr double INF = std::numeric_limits<double>::infinity();
+// Число сторон многоугольника, описанного вокруг окружности-препятствия
+constexpr size_t CIRCLE_SIDES = 32;
+constexpr size_t MAX_CACHED_ENDPOINTS = 4096;
+
+double Orient(const Point2D &a, const Point2D &b, const Point2D &c) noexcept { return (b - a).Cross(c - a); }
+
+// Знак с допуском, пропорциональным масштабу входных векторов
+int Sign(double value, double scale) noexcept {
+    const double tolerance = EPS * scale;
+    return value > tolerance ? 1 : (value < -tolerance ? -1 : 0);
+}
+
+// Отрезки пересекаются во внутренних точках обоих, а не касаются
+bool CrossesProperly(const Point2D &a, const Point2D &b, const Point2D &c, const Point2D &d) noexcept {
+    const double scale = (b - a).Length() * std::max((d - c).Length(), EPS);
+    return Sign(Orient(a, b, c), scale) * Sign(Orient(a, b, d), scale) < 0 &&
+           Sign(Orient(c, d, a), scale) * Sign(Orient(c, d, b), scale) < 0;
+}
+
+// Полярный угол в [-pi, pi): луч вдоль -x у всех точек получает один и тот же угол
+double Angle(const Point2D &d) noexcept {
+    const double angle = std::atan2(d.y, d.x);
+    return angle == std::numbers::pi ? -angle : angle;
+}
+
+bool InsideRing(const Point2D &p, std::span<const Point2D> ring) noexcept {
+    bool inside = false;
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        const Point2D &v1 = ring[j];
+        const Point2D &v2 = ring[i];
+        if (((v1.y > p.y) != (v2.y > p.y)) && (p.x < (v2.x - v1.x) * (p.y - v1.y) / (v2.y - v1.y) + v1.x)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+// Контуры препятствия; у экземпляра это контуры прототипа, переведённые в мировые координаты
+template <typename T>
+std::vector<std::vector<Point2D>> OutlinesOf(const T &s) {
+    if constexpr (std::is_same_v<T, Circle>) {
+        const double radius = s.radius / std::cos(std::numbers::pi / CIRCLE_SIDES);
+        return {Circle{s.center_p, radius}.Vertices(CIRCLE_SIDES)};
+    } else if constexpr (std::is_same_v<T, PolygonWithHoles>) {
+        // Дыры недостижимы снаружи, препятствием служит внешний контур целиком
+        return {{s.Outer().begin(), s.Outer().end()}};
+    } else if constexpr (std::is_same_v<T, MultiPolygon>) {
+        std::vector<std::vector<Point2D>> outlines;
+        for (size_t part = 0; part < s.PartCount(); ++part) {
+            const auto outer = s.Ring(s.PartRings(part).first);
+            outlines.emplace_back(outer.begin(), outer.end());
+        }
+        return outlines;
+    } else if constexpr (std::is_same_v<T, InstancedShape>) {
+        auto outlines = std::visit([](const auto &prototype) { return OutlinesOf(prototype); }, s.Prototype());
+        for (auto &outline : outlines) {
+            for (auto &p : outline) {
+                p = s.GetTransform().Apply(p);
+            }
+        }
+        return outlines;
+    } else {
+        auto vertices = s.Vertices();
+        return {{vertices.begin(), vertices.end()}};
+    }
+}
+
+}  // namespace
+
+std::vector<std::vector<Point2D>> ObstacleOutlines(const Shape &shape) {
+    return std::visit([](const auto &s) { return OutlinesOf(s); }, shape);
+}
+
+struct VisibilityGraph::EndpointCache {
+    std::mutex mutex;
+    std::unordered_map<Point2D, std::vector<Neighbor>> entries;
+};
+
+VisibilityGraph::VisibilityGraph(std::span<const Shape> obstacles, size_t threads)
+    : cache_(std::make_unique<EndpointCache>()) {
+    std::vector<BoundingBox> segment_boxes;
+    std::vector<BoundingBox> ring_boxes;
+
+    for (const auto &shape : obstacles) {
+        for (auto outline : ObstacleOutlines(shape)) {
+            // Совпадающие соседние вершины дают нулевые рёбра и ломают проверку выпуклости
+            outline.erase(std::unique(outline.begin(), outline.end()), outline.end());
+            while (outline.size() > 1 && outline.front() == outline.back()) {
+                outline.pop_back();
+            }
+            if (outline.empty()) {
+                continue;
+            }
+            const bool closed = outline.size() >= 3 && !std::holds_alternative<Line>(shape);
+            const size_t n = outline.size();
+
+            if (closed) {
+                double doubled_area = 0.0;
+                for (size_t i = 0; i < n; ++i) {
+                    doubled_area += outline[i].Cross(outline[(i + 1) % n]);
+                }
+                const int orientation = doubled_area > 0 ? 1 : -1;
+
+                for (size_t i = 0; i < n; ++i) {
+                    const Point2D &prev = outline[(i + n - 1) % n];
+                    const Point2D &cur = outline[i];
+                    const Point2D &next = outline[(i + 1) % n];
+                    const double scale = (cur - prev).Length() * (next - cur).Length();
+                    // Путь может огибать только выпуклые вершины
+                    if (Sign((cur - prev).Cross(next - cur), scale) == orientation) {
+                        vertices_.push_back(cur);
+                        vertex_prev_.push_back(prev);
+                        vertex_next_.push_back(next);
+                    }
+                }
+            } else {
+                // У концов ломаной один сосед — он же и предыдущий, и следующий
+                for (size_t i = 0; i < n; ++i) {
+                    vertices_.push_back(outline[i]);
+                    vertex_prev_.push_back(outline[i > 0 ? i - 1 : std::min<size_t>(1, n - 1)]);
+                    vertex_next_.push_back(outline[i + 1 < n ? i + 1 : (i > 0 ? i - 1 : 0)]);
+                }
+            }
+
+            const size_t edges = closed ? n : n - 1;
+            for (size_t i = 0; i < edges; ++i) {
+                const Segment segment{outline[i], outline[(i + 1) % n]};
+                segments_.push_back(segment);
+                segment_boxes.push_back(Line{segment.a, segment.b}.BoundBox());
+            }
+            if (n == 1) {
+                segments_.push_back({outline[0], outline[0]});
+                segment_boxes.push_back(Line{outline[0], outline[0]}.BoundBox());
+            }
+
+            const BoundingBox box = Polygon{outline}.BoundBox();
+            ring_boxes.push_back(box);
+            rings_.push_back({std::move(outline), box, closed});
+        }
+    }
+
+    // Развёртка в ScanVisible держит рёбра упорядоченными по расстоянию вдоль луча, а рёбра наложенных
+    // препятствий, пересекаясь, меняли бы этот порядок между событиями — поэтому они режутся в точках пересечения
+    {
+        const index::GridIndex crossing_index(segment_boxes);
+        std::vector<std::vector<std::pair<double, Point2D>>> cuts(segments_.size());
+        for (size_t i = 0; i < segments_.size(); ++i) {
+            crossing_index.Query(segment_boxes[i], [&](size_t j) {
+                const auto &[a, b] = segments_[i];
+                const auto &[c, d] = segments_[j];
+                if (j <= i || !CrossesProperly(a, b, c, d)) {
+                    return;
+                }
+                const double t = Orient(c, d, a) / (Orient(c, d, a) - Orient(c, d, b));
+                const double u = Orient(a, b, c) / (Orient(a, b, c) - Orient(a, b, d));
+                // Обе половины получают одну и ту же точку, чтобы концы совпадали точно
+                const Point2D cross = a + (b - a) * t;
+                cuts[i].emplace_back(t, cross);
+                cuts[j].emplace_back(u, cross);
+            });
+        }
+
+        std::vector<Segment> pieces;
+        segment_boxes.clear();
+        for (size_t i = 0; i < segments_.size(); ++i) {
+            std::ranges::sort(cuts[i], {}, &std::pair<double, Point2D>::first);
+            Point2D from = segments_[i].a;
+            for (const auto &[t, cross] : cuts[i]) {
+                pieces.push_back({from, cross});
+                from = cross;
+            }
+            pieces.push_back({from, segments_[i].b});
+        }
+        segments_ = std::move(pieces);
+        for (const auto &[a, b] : segments_) {
+            segment_boxes.push_back(Line{a, b}.BoundBox());
+        }
+    }
+
+    segment_index_ = index::GridIndex(segment_boxes);
+    ring_index_ = index::GridIndex(ring_boxes);
+
+    // Каждая вершина обходит остальные по углу независимо, поэтому построение распараллеливается по вершинам
+    std::vector<std::vector<Neighbor>> adjacency(vertices_.size());
+    parallel::ParallelFor(
+        vertices_.size(), 8,
+        [&](size_t begin, size_t end, size_t) {
+            for (size_t v = begin; v < end; ++v) {
+                adjacency[v] = ScanVisible(vertices_[v], v);
+            }
+        },
+        threads);
+
+    offsets_.reserve(vertices_.size() + 1);
+    offsets_.push_back(0);
+    for (const auto &list : adjacency) {
+        neighbors_.insert(neighbors_.end(), list.begin(), list.end());
+        offsets_.push_back(neighbors_.size());
+    }
+}
+
+VisibilityGraph::~VisibilityGraph() = default;
+VisibilityGraph::VisibilityGraph(VisibilityGraph &&) noexcept = default;
+VisibilityGraph &VisibilityGraph::operator=(VisibilityGraph &&) noexcept = default;
+
+bool VisibilityGraph::IsTangent(size_t vertex, const Point2D &toward) const {
+    const Point2D &v = vertices_[vertex];
+    const double scale = (toward - v).Length();
+    const int s1 = Sign(Orient(v, toward, vertex_prev_[vertex]), scale * (vertex_prev_[vertex] - v).Length());
+    const int s2 = Sign(Orient(v, toward, vertex_next_[vertex]), scale * (vertex_next_[vertex] - v).Length());
+    // Соседи по контуру по разные стороны прямой — отрезок уходит внутрь препятствия или огибать вершину незачем
+    return s1 * s2 >= 0;
+}
+
+bool VisibilityGraph::StrictlyInside(const Point2D &p) const {
+    bool inside = false;
+    ring_index_.Query({p.x, p.y, p.x, p.y}, [&](size_t r) {
+        const Ring &ring = rings_[r];
+        if (inside || !ring.closed || !InsideRing(p, ring.points)) {
+            return;
+        }
+        const double tolerance = EPS * std::max({1.0, ring.box.Width(), ring.box.Height()});
+        inside = queries::detail::DistanceToOutline(p, ring.points, true) > tolerance;
+    });
+    return inside;
+}
+
+bool VisibilityGraph::IsFree(const Point2D &p) const { return !StrictlyInside(p); }
+
+bool VisibilityGraph::IsVisible(const Point2D &a, const Point2D &b) const {
+    const Point2D ab = b - a;
+    const double ab_len_sq = ab.Dot(ab);
+    if (ab_len_sq == 0.0) {
+        return IsFree(a);
+    }
+
+    // Параметры точек на [a, b], где отрезок касается границ; между ними проверяем внутренность препятствий
+    std::vector<double> cuts{0.0, 1.0};
+    bool blocked = false;
+
+    segment_index_.Query(Line{a, b}.BoundBox(), [&](size_t s) {
+        if (blocked) {
+            return;
+        }
+        const auto &[c, d] = segments_[s];
+        if (CrossesProperly(a, b, c, d)) {
+            blocked = true;
+            return;
+        }
+        const double scale = std::sqrt(ab_len_sq) * std::max((d - c).Length(), EPS);
+        for (const Point2D &p : {c, d}) {
+            if (Sign(Orient(a, b, p), scale) == 0) {
+                const double t = (p - a).Dot(ab) / ab_len_sq;
+                if (t > 0.0 && t < 1.0) {
+                    cuts.push_back(t);
+                }
+            }
+        }
+    });
+    if (blocked) {
+        return false;
+    }
+
+    std::ranges::sort(cuts);
+    for (size_t i = 1; i < cuts.size(); ++i) {
+        if (cuts[i] - cuts[i - 1] > EPS && StrictlyInside(a + ab * ((cuts[i - 1] + cuts[i]) / 2.0))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<VisibilityGraph::Neighbor> VisibilityGraph::ScanVisible(const Point2D &p, size_t self) const {
+    struct Candidate {
+        size_t vertex;
+        double angle;
+        double distance_sq;
+    };
+    // Конец ребра или точечного препятствия — отрезок, проходящий через него, только касается границы
+    struct Mark {
+        Point2D point;
+        double angle;
+        double length;
+    };
+    enum class EventKind { Remove, Candidate, Insert };
+    struct Event {
+        double angle;
+        EventKind kind;
+        size_t item;
+    };
+
+    std::vector<Candidate> candidates;
+    for (size_t v = 0; v < vertices_.size(); ++v) {
+        const Point2D &w = vertices_[v];
+        if (v == self || w == p || !IsTangent(v, p) || (self != NONE && !IsTangent(self, w))) {
+            continue;
+        }
+        const Point2D d = w - p;
+        candidates.push_back({v, Angle(d), d.Dot(d)});
+    }
+    // Из внутренности препятствия видно только её саму
+    if (candidates.empty() || StrictlyInside(p)) {
+        return {};
+    }
+
+    // p касается чужих рёбер (соседние препятствия, конец пути на границе): окрестность p не разделена
+    // рёбрами на внутренность и свободное место, и видимость каждой вершины проверяется напрямую
+    bool degenerate = false;
+    const double reach = EPS * std::max({1.0, std::abs(p.x), std::abs(p.y)});
+    segment_index_.Query({p.x - reach, p.y - reach, p.x + reach, p.y + reach}, [&](size_t s) {
+        const auto &[a, b] = segments_[s];
+        const auto own = [&](const Point2D &q) { return q == vertex_prev_[self] || q == vertex_next_[self]; };
+        if (self != NONE && ((a == p && own(b)) || (b == p && own(a)))) {
+            return;
+        }
+        const std::array<Point2D, 2> edge{a, b};
+        degenerate = degenerate || queries::detail::DistanceToOutline(p, edge, false) <= reach;
+    });
+
+    // Рёбра ориентируются против часовой стрелки вокруг p: ребро пересекает лучи с углами между
+    // углами концов a и b и активно на этом интервале. Рёбра, пересекающие начальный луч вдоль -x,
+    // активны с начала обхода
+    std::vector<Segment> edges;
+    std::vector<Mark> marks;
+    std::vector<Event> events;
+    std::vector<size_t> initial;
+    for (const auto &[c, d] : segments_) {
+        const double length = (d - c).Length();
+        for (const Point2D &q : {c, d}) {
+            if (q != p) {
+                marks.push_back({q, Angle(q - p), length});
+            }
+        }
+        const double orientation = Orient(p, c, d);
+        if (orientation == 0.0) {
+            continue;
+        }
+        const Segment edge = orientation > 0 ? Segment{c, d} : Segment{d, c};
+        const double from = Angle(edge.a - p);
+        const double to = Angle(edge.b - p);
+        // Угловой интервал ребра короче pi; иное означает, что ребро почти проходит через p и не может его заслонить
+        const bool wraps = from > to;
+        if ((wraps && from - to <= std::numbers::pi) || (!wraps && (to - from >= std::numbers::pi || from == to))) {
+            continue;
+        }
+        if (wraps) {
+            initial.push_back(edges.size());
+        }
+        events.push_back({from, EventKind::Insert, edges.size()});
+        events.push_back({to, EventKind::Remove, edges.size()});
+        edges.push_back(edge);
+    }
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        events.push_back({candidates[i].angle, EventKind::Candidate, i});
+    }
+    // На одном угле сначала уходят закончившиеся рёбра, затем проверяются вершины, затем входят новые рёбра
+    std::ranges::sort(events, [](const Event &l, const Event &r) {
+        return l.angle < r.angle || (l.angle == r.angle && l.kind < r.kind);
+    });
+    std::ranges::sort(marks, {}, &Mark::angle);
+
+    // Активные рёбра упорядочены по расстоянию от p вдоль текущего луча. Между событиями рёбра не
+    // пересекаются (конструктор режет их в точках пересечения), поэтому порядок остаётся верным
+    Point2D ray{-1.0, 0.0};
+    const auto along = [&](size_t e) {
+        const auto &[a, b] = edges[e];
+        return (a - p).Cross(b - a) / ray.Cross(b - a);
+    };
+    const auto closer = [&](size_t l, size_t r) {
+        const double dl = along(l);
+        const double dr = along(r);
+        if (std::abs(dl - dr) > EPS * std::max(dl, dr)) {
+            return dl < dr;
+        }
+        // Рёбра выходят из одной точки луча: ближе то, что сразу за лучом лежит со стороны p от другого
+        const auto &[c, d] = edges[r];
+        const int side = Sign(Orient(c, d, edges[l].b), (d - c).Length() * (edges[l].b - c).Length());
+        return side != 0 && side == Sign(Orient(c, d, p), 0.0);
+    };
+    std::multiset<size_t, decltype(closer)> active(closer);
+    std::vector<std::multiset<size_t, decltype(closer)>::iterator> position(edges.size(), active.end());
+    for (size_t e : initial) {
+        position[e] = active.insert(e);
+    }
+
+    // Граница касается открытого отрезка (p, w) — между касаниями он может уйти во внутренность препятствия
+    const auto touches = [&](const Point2D &w, double angle) {
+        const Point2D pw = w - p;
+        const double pw_len_sq = pw.Dot(pw);
+        auto on_ray = [&](const Mark &mark) {
+            return Sign(Orient(p, w, mark.point), std::sqrt(pw_len_sq) * std::max(mark.length, EPS)) == 0 &&
+                   (mark.point - p).Dot(pw) > 0;
+        };
+        auto between = [&](const Mark &mark) {
+            const double t = (mark.point - p).Dot(pw) / pw_len_sq;
+            return mark.point != w && t > 0.0 && t < 1.0;
+        };
+        const auto start = std::ranges::lower_bound(marks, angle, {}, &Mark::angle);
+        for (auto it = start; it != marks.end() && on_ray(*it); ++it) {
+            if (between(*it)) {
+                return true;
+            }
+        }
+        for (auto it = start; it != marks.begin() && on_ray(*std::prev(it)); --it) {
+            if (between(*std::prev(it))) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<Neighbor> visible;
+    for (const auto &[angle, kind, item] : events) {
+        if (kind == EventKind::Remove) {
+            active.erase(position[item]);
+            position[item] = active.end();
+            continue;
+        }
+        if (kind == EventKind::Insert) {
+            ray = edges[item].a - p;
+            position[item] = active.insert(item);
+            continue;
+        }
+
+        const Candidate &candidate = candidates[item];
+        const Point2D &w = vertices_[candidate.vertex];
+        ray = w - p;
+        // Ближайшее ребро на луче дальше w — отрезок до w не пересекает ни одного ребра
+        bool is_visible = true;
+        bool exact = degenerate;
+        if (!exact && !active.empty() && along(*active.begin()) < 1.0) {
+            const auto &[a, b] = edges[*active.begin()];
+            is_visible = false;
+            exact = !CrossesProperly(p, w, a, b);
+        }
+        // Без пересечений и касаний отрезок целиком лежит снаружи препятствий: у p он свободен, а вершины
+        // касательны к своим контурам
+        if (exact || (is_visible && touches(w, angle))) {
+            is_visible = IsVisible(p, w);
+        }
+        if (is_visible) {
+            visible.push_back({candidate.vertex, std::sqrt(candidate.distance_sq)});
+        }
+    }
+    return visible;
+}
+
+std::vector<VisibilityGraph::Neighbor> VisibilityGraph::EndpointNeighbors(const Point2D &p) const {
+    {
+        std::scoped_lock lock(cache_->mutex);
+        if (auto it = cache_->entries.find(p); it != cache_->entries.end()) {
+            return it->second;
+        }
+    }
+
+    auto neighbors = ScanVisible(p, NONE);
+
+    std::scoped_lock lock(cache_->mutex);
+    if (cache_->entries.size() >= MAX_CACHED_ENDPOINTS) {
+        cache_->entries.clear();
+    }
+    cache_->entries.emplace(p, neighbors);
+    return neighbors;
+}
+
+/**
+    @brief Кратчайший путь от start до goal, A* с евклидовой эвристикой по графу видимости
+*/
+std::expected<Path, std::string> VisibilityGraph::ShortestPath(const Point2D &start, const Point2D &goal) const {
+    if (!IsFree(start)) {
+        return std::unexpected("Start point is inside an obstacle.");
+    }
+    if (!IsFree(goal)) {
+        return std::unexpected("Goal point is inside an obstacle.");
+    }
+    if (IsVisible(start, goal)) {
+        return Path{{start, goal}, start.DistanceTo(goal)};
+    }
+
+    const auto from_start = EndpointNeighbors(start);
+    const auto to_goal = EndpointNeighbors(goal);
+
+    const size_t n = vertices_.size();
+    const size_t start_node = n;
+    const size_t goal_node = n + 1;
+    auto position = [&](size_t node) {
+        return node == start_node ? start : (node == goal_node ? goal : vertices_[node]);
+    };
+
+    std::vector<double> goal_link(n, INF);
+    for (const auto &[vertex, weight] : to_goal) {
+        goal_link[vertex] = weight;
+    }
+
+    std::vector<double> cost(n + 2, INF);
+    std::vector<size_t> parent(n + 2, NONE);
+    std::vector<bool> done(n + 2, false);
+
+    using QueueItem = std::pair<double, size_t>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> open;
+    cost[start_node] = 0.0;
+    open.emplace(start.DistanceTo(goal), start_node);
+
+    auto relax = [&](size_t from, size_t to, double weight) {
+        const double candidate = cost[from] + weight;
+        if (candidate < cost[to]) {
+            cost[to] = candidate;
+            parent[to] = from;
+            open.emplace(candidate + position(to).DistanceTo(goal), to);
+        }
+    };
+
+    while (!open.empty()) {
+        const size_t node = open.top().second;
+        open.pop();
+        if (done[node]) {
+            continue;
+        }
+        done[node] = true;
+        if (node == goal_node) {
+            break;
+        }
+
+        if (node == start_node) {
+            for (const auto &[vertex, weight] : from_start) {
+                relax(node, vertex, weight);
+            }
+            continue;
+        }
+        for (size_t k = offsets_[node]; k < offsets_[node + 1]; ++k) {
+            relax(node, neighbors_[k].vertex, neighbors_[k].weight);
+        }
+        if (goal_link[node] < INF) {
+            relax(node, goal_node, goal_link[node]);
+        }
+    }
+
+    if (cost[goal_node] == INF) {
+        return std::unexpected("Goal is unreachable.");
+    }
+
+    Path path;
+    path.length = cost[goal_node];
+    for (size_t node = goal_node; node != NONE; node = parent[node]) {
+        path.points.push_back(position(node));
+    }
+    std::ranges::reverse(path.points);
+    return path;
+}
+
+}  // namespace geometry::navigation
@@ -0,0 +1,300 @@
+#include "navmesh.hpp"
+#include "point_set.hpp"
+#include "queries.hpp"
+#include "triangulation.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <queue>
+
+namespace geometry::navigation {
+
+namespace {
+
+constexpr double WELD_TOLERANCE = 1e-9;
+constexpr size_t DEFAULT_EDGE_DIVISIONS = 32;
+constexpr size_t NONE = std::numeric_limits<size_t>::max();
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+struct Portal {
+    Point2D left, right;
+};
+
+bool InsideRegion(const BoundingBox &region, const Point2D &p) noexcept {
+    return p.x >= region.min_x && p.x <= region.max_x && p.y >= region.min_y && p.y <= region.max_y;
+}
+
+// Добавляет точки ребра [a, b) с шагом не больше max_length
+void AppendSubdivided(const Point2D &a, const Point2D &b, double max_length, std::vector<Point2D> &out) {
+    const auto pieces = std::max<size_t>(1, static_cast<size_t>(std::ceil(a.DistanceTo(b) / max_length)));
+    for (size_t i = 0; i < pieces; ++i) {
+        out.push_back(a + (b - a) * (static_cast<double>(i) / static_cast<double>(pieces)));
+    }
+}
+
+// Собственное пересечение внутренностей отрезков (касание концами не считается)
+bool ProperlyCross(const Point2D &p1, const Point2D &p2, const Point2D &q1, const Point2D &q2) noexcept {
+    const double scale = 1e-12 * (p2 - p1).Length() * (q2 - q1).Length();
+    auto side = [scale](double v) { return v > scale ? 1 : (v < -scale ? -1 : 0); };
+    const int d1 = side(queries::detail::Orientation(q1, q2, p1));
+    const int d2 = side(queries::detail::Orientation(q1, q2, p2));
+    const int d3 = side(queries::detail::Orientation(p1, p2, q1));
+    const int d4 = side(queries::detail::Orientation(p1, p2, q2));
+    return d1 * d2 < 0 && d3 * d4 < 0;
+}
+
+bool ContainsPoint(const Triangle &t, const Point2D &p) noexcept {
+    // Треугольники сетки ориентированы против часовой стрелки
+    return (t.b - t.a).Cross(p - t.a) >= 0 && (t.c - t.b).Cross(p - t.b) >= 0 && (t.a - t.c).Cross(p - t.c) >= 0;
+}
+
+/**
+    @brief Спрямление коридора порталов (simple stupid funnel algorithm)
+
+    Воронка с вершиной apex сужается левой и правой границами порталов; когда одна граница перехлёстывает
+    другую, её вершина становится новой точкой пути и обход продолжается от неё.
+*/
+std::vector<Point2D> PullString(const std::vector<Portal> &portals) {
+    std::vector<Point2D> path{portals.front().left};
+    Point2D apex = portals.front().left;
+    Point2D left = apex, right = apex;
+    size_t apex_index = 0, left_index = 0, right_index = 0;
+
+    auto cross = [](const Point2D &o, const Point2D &a, const Point2D &b) { return (a - o).Cross(b - o); };
+
+    for (size_t i = 1; i < portals.size(); ++i) {
+        const Point2D &new_left = portals[i].left;
+        const Point2D &new_right = portals[i].right;
+
+        // Правая граница: новая точка не правее текущей
+        if (cross(apex, right, new_right) >= 0) {
+            if (apex == right || cross(apex, left, new_right) < 0) {
+                right = new_right;
+                right_index = i;
+            } else {
+                path.push_back(left);
+                apex = left;
+                apex_index = left_index;
+                right = left = apex;
+                right_index = left_index = apex_index;
+                i = apex_index;
+                continue;
+            }
+        }
+
+        // Левая граница: новая точка не левее текущей
+        if (cross(apex, left, new_left) <= 0) {
+            if (apex == left || cross(apex, right, new_left) > 0) {
+                left = new_left;
+                left_index = i;
+            } else {
+                path.push_back(right);
+                apex = right;
+                apex_index = right_index;
+                right = left = apex;
+                right_index = left_index = apex_index;
+                i = apex_index;
+                continue;
+            }
+        }
+    }
+
+    if (path.back() != portals.back().left) {
+        path.push_back(portals.back().left);
+    }
+    return path;
+}
+
+}  // namespace
+
+std::expected<NavMesh, std::string> NavMesh::Build(const BoundingBox &region, std::span<const Shape> obstacles,
+                                                   const NavMeshOptions &options) {
+    if (!(region.Width() > 0.0 && region.Height() > 0.0)) {
+        return std::unexpected("Navigation region must have positive area.");
+    }
+    const double max_length = options.max_edge_length > 0.0
+                                  ? options.max_edge_length
+                                  : std::max(region.Width(), region.Height()) / DEFAULT_EDGE_DIVISIONS;
+
+    std::vector<Point2D> points;
+    const std::array<Point2D, 4> corners = {Point2D{region.min_x, region.min_y}, Point2D{region.max_x, region.min_y},
+                                            Point2D{region.max_x, region.max_y}, Point2D{region.min_x, region.max_y}};
+    for (size_t i = 0; i < corners.size(); ++i) {
+        AppendSubdivided(corners[i], corners[(i + 1) % corners.size()], max_length, points);
+    }
+
+    // Препятствия как многоугольники и их рёбра для отсева треугольников
+    std::vector<Polygon> solids;
+    std::vector<Line> walls;
+    for (const auto &shape : obstacles) {
+        for (const auto &outline : ObstacleOutlines(shape)) {
+            const bool closed = outline.size() >= 3 && !std::holds_alternative<Line>(shape);
+            const size_t edges = closed ? outline.size() : outline.size() - 1;
+
+            std::vector<Point2D> subdivided;
+            for (size_t i = 0; i < edges; ++i) {
+                const Point2D &a = outline[i];
+                const Point2D &b = outline[(i + 1) % outline.size()];
+                walls.emplace_back(a, b);
+                AppendSubdivided(a, b, max_length, subdivided);
+            }
+            if (!closed) {
+                subdivided.push_back(outline.back());
+            }
+            std::ranges::copy_if(subdivided, std::back_inserter(points),
+                                 [&region](const Point2D &p) { return InsideRegion(region, p); });
+            if (closed) {
+                solids.emplace_back(outline);
+            }
+        }
+    }
+
+    points = point_set::WeldVertices(points, WELD_TOLERANCE).points;
+    auto triangulation = triangulation::DelaunayTriangulation(points);
+    if (!triangulation) {
+        return std::unexpected(triangulation.error());
+    }
+    const auto full = triangulation::BuildMesh(*triangulation);
+
+    std::vector<BoundingBox> solid_boxes, wall_boxes;
+    for (const auto &solid : solids) {
+        solid_boxes.push_back(solid.BoundBox());
+    }
+    for (const auto &wall : walls) {
+        wall_boxes.push_back(wall.BoundBox());
+    }
+    const index::GridIndex solid_index(solid_boxes);
+    const index::GridIndex wall_index(wall_boxes);
+
+    auto is_free = [&](size_t t) {
+        const Triangle tri = full.GetTriangle(t);
+        const Point2D center = tri.Center();
+        if (!InsideRegion(region, center)) {
+            return false;
+        }
+
+        bool blocked = false;
+        solid_index.Query({center.x, center.y, center.x, center.y}, [&](size_t s) {
+            blocked = blocked || queries::PointInShapeVisitor{center}(solids[s]);
+        });
+        const auto vertices = tri.Vertices();
+        wall_index.Query(tri.BoundBox(), [&](size_t w) {
+            for (size_t k = 0; k < 3 && !blocked; ++k) {
+                blocked = ProperlyCross(vertices[k], vertices[(k + 1) % 3], walls[w].start, walls[w].end);
+            }
+        });
+        return !blocked;
+    };
+
+    std::vector<std::array<size_t, 3>> kept;
+    for (size_t t = 0; t < full.Size(); ++t) {
+        if (is_free(t)) {
+            kept.push_back(full.triangles[t]);
+        }
+    }
+    if (kept.empty()) {
+        return std::unexpected("No free space left for the navigation mesh.");
+    }
+
+    NavMesh navmesh;
+    navmesh.mesh_ = triangulation::BuildMesh(full.vertices, std::move(kept));
+
+    std::vector<BoundingBox> triangle_boxes;
+    triangle_boxes.reserve(navmesh.mesh_.Size());
+    for (size_t t = 0; t < navmesh.mesh_.Size(); ++t) {
+        triangle_boxes.push_back(navmesh.mesh_.GetTriangle(t).BoundBox());
+    }
+    navmesh.triangle_index_ = index::GridIndex(triangle_boxes);
+    return navmesh;
+}
+
+std::optional<size_t> NavMesh::Locate(const Point2D &p) const {
+    std::optional<size_t> found;
+    triangle_index_.Query({p.x, p.y, p.x, p.y}, [&](size_t t) {
+        if (!found && ContainsPoint(mesh_.GetTriangle(t), p)) {
+            found = t;
+        }
+    });
+    return found;
+}
+
+std::expected<Path, std::string> NavMesh::FindPath(const Point2D &start, const Point2D &goal) const {
+    const auto start_triangle = Locate(start);
+    if (!start_triangle) {
+        return std::unexpected("Start point is outside the navigation mesh.");
+    }
+    const auto goal_triangle = Locate(goal);
+    if (!goal_triangle) {
+        return std::unexpected("Goal point is outside the navigation mesh.");
+    }
+
+    // A* по треугольникам: треугольник проходится через его центр, стартовый и целевой — через сами точки
+    const size_t n = mesh_.Size();
+    std::vector<Point2D> position(n);
+    std::vector<double> cost(n, INF);
+    std::vector<size_t> parent(n, NONE);
+    std::vector<bool> done(n, false);
+
+    using QueueItem = std::pair<double, size_t>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> open;
+    position[*start_triangle] = start;
+    cost[*start_triangle] = 0.0;
+    open.emplace(start.DistanceTo(goal), *start_triangle);
+
+    while (!open.empty()) {
+        const size_t t = open.top().second;
+        open.pop();
+        if (done[t]) {
+            continue;
+        }
+        done[t] = true;
+        if (t == *goal_triangle) {
+            break;
+        }
+        for (size_t neighbor : mesh_.neighbors[t]) {
+            if (neighbor == NONE || done[neighbor]) {
+                continue;
+            }
+            const Point2D via = neighbor == *goal_triangle ? goal : mesh_.GetTriangle(neighbor).Center();
+            const double candidate = cost[t] + position[t].DistanceTo(via);
+            if (candidate < cost[neighbor]) {
+                position[neighbor] = via;
+                cost[neighbor] = candidate;
+                parent[neighbor] = t;
+                open.emplace(candidate + via.DistanceTo(goal), neighbor);
+            }
+        }
+    }
+
+    if (!done[*goal_triangle]) {
+        return std::unexpected("Goal is unreachable.");
+    }
+
+    // Коридор треугольников от старта к цели и порталы между ними
+    std::vector<size_t> corridor;
+    for (size_t t = *goal_triangle; t != NONE; t = parent[t]) {
+        corridor.push_back(t);
+    }
+    std::ranges::reverse(corridor);
+
+    std::vector<Portal> portals{{start, start}};
+    for (size_t i = 0; i + 1 < corridor.size(); ++i) {
+        const auto &tri = mesh_.triangles[corridor[i]];
+        const auto &adjacent = mesh_.neighbors[corridor[i]];
+        const size_t k = std::ranges::find(adjacent, corridor[i + 1]) - adjacent.begin();
+        // Изнутри треугольника против часовой стрелки конец ребра лежит слева, начало — справа
+        portals.push_back({mesh_.vertices[tri[(k + 1) % 3]], mesh_.vertices[tri[k]]});
+    }
+    portals.push_back({goal, goal});
+
+    Path path;
+    path.points = PullString(portals);
+    for (size_t i = 1; i < path.points.size(); ++i) {
+        path.length += path.points[i - 1].DistanceTo(path.points[i]);
+    }
+    return path;
+}
+
+}  // namespace geometry::navigation
@@ -0,0 +1,230 @@
+#include "numa.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace geometry::numa {
+
+namespace {
+
+constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20;
+// Узел, за которым уже закреплён поток, чтобы повторное закрепление не стоило системного вызова
+thread_local size_t pinned_node = static_cast<size_t>(-1);
+
+constexpr const char *NODE_ROOT = "/sys/devices/system/node";
+
+std::string NodeDirectory(size_t id) { return std::string(NODE_ROOT) + "/node" + std::to_string(id); }
+
+// Разбор списка вида "0-3,8,10-11"
+std::vector<size_t> ParseCpuList(const std::string &list) {
+    std::vector<size_t> cpus;
+    std::istringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        const size_t dash = range.find('-');
+        const size_t first = std::stoul(range.substr(0, dash));
+        const size_t last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+        for (size_t cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+// Номера узлов в сети по возрастанию; узел с индексом i в этом API — узел ядра OnlineNodes()[i],
+// так что пропуски в нумерации ядра (например, «0,2») индексы не разрывают
+const std::vector<size_t> &OnlineNodes() {
+    static const std::vector<size_t> nodes = [] {
+        std::ifstream file(std::string(NODE_ROOT) + "/online");
+        std::string list;
+        std::vector<size_t> ids;
+        if (file && std::getline(file, list)) {
+            ids = ParseCpuList(list);
+        }
+        return ids.empty() ? std::vector<size_t>{0} : ids;
+    }();
+    return nodes;
+}
+
+#ifdef __linux__
+size_t RoundUp(size_t bytes, size_t granularity) { return (bytes + granularity - 1) / granularity * granularity; }
+
+size_t PageSize() {
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+// Размер отображения: кратен большой странице, если она запрошена, иначе обычной
+size_t MappedSize(size_t bytes, const MemoryOptions &options) {
+    return RoundUp(std::max<size_t>(bytes, 1), options.huge_pages == HugePages::None ? PageSize() : HUGE_PAGE_SIZE);
+}
+
+// mbind напрямую через системный вызов: libnuma ради двух констант не нужна; nodes — индексы узлов
+bool Bind(void *pointer, size_t bytes, int mode, const std::vector<size_t> &nodes) {
+    constexpr size_t BITS = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask;
+    for (size_t node : nodes) {
+        const size_t id = OnlineNodes()[node];
+        mask.resize(std::max(mask.size(), id / BITS + 1), 0);
+        mask[id / BITS] |= 1ul << (id % BITS);
+    }
+    return syscall(SYS_mbind, pointer, bytes, mode, mask.data(), mask.size() * BITS + 1, 0) == 0;
+}
+
+// Каждый кусок NodeSlice трогается потоком, закреплённым за своим узлом
+void TouchPerNode(void *pointer, size_t bytes) {
+    auto *bytes_begin = static_cast<volatile char *>(pointer);
+    const size_t pages = bytes / PageSize();
+    std::vector<std::jthread> touchers;
+    for (size_t node = 0; node < NodeCount(); ++node) {
+        touchers.emplace_back([=] {
+            PinCurrentThreadToNode(node);
+            const auto [begin, end] = NodeSlice(pages, node);
+            for (size_t page = begin; page < end; ++page) {
+                bytes_begin[page * PageSize()] = 0;
+            }
+        });
+    }
+}
+#endif
+
+}  // namespace
+
+size_t NodeCount() { return OnlineNodes().size(); }
+
+std::vector<size_t> NodeCpus(size_t node) {
+    if (node >= NodeCount()) {
+        return {};
+    }
+    std::ifstream file(NodeDirectory(OnlineNodes()[node]) + "/cpulist");
+    std::string list;
+    if (file && std::getline(file, list)) {
+        return ParseCpuList(list);
+    }
+    // Топологии нет — единственный узел владеет всеми процессорами
+    if (node != 0) {
+        return {};
+    }
+    std::vector<size_t> cpus(std::max(1u, std::thread::hardware_concurrency()));
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        cpus[i] = i;
+    }
+    return cpus;
+}
+
+size_t CurrentNode() {
+#ifdef __linux__
+    unsigned cpu = 0, id = 0;
+    if (syscall(SYS_getcpu, &cpu, &id, nullptr) == 0) {
+        const auto &nodes = OnlineNodes();
+        if (const auto it = std::ranges::find(nodes, id); it != nodes.end()) {
+            return static_cast<size_t>(it - nodes.begin());
+        }
+    }
+#endif
+    return 0;
+}
+
+bool PinCurrentThreadToNode(size_t node) {
+    if (node >= NodeCount()) {
+        return false;
+    }
+    if (pinned_node == node) {
+        return true;
+    }
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (size_t cpu : NodeCpus(node)) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    if (CPU_COUNT(&set) == 0 || sched_setaffinity(0, sizeof(set), &set) != 0) {
+        return false;
+    }
+    pinned_node = node;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+    @brief Отображение анонимных страниц с политикой размещения и большими страницами
+
+    Явные большие страницы берутся из пула hugetlbfs; если он пуст или не настроен, область отображается
+    обычными страницами с пометкой MADV_HUGEPAGE, чтобы ядро собрало большие страницы само. Политика узлов
+    задаётся до первого обращения к памяти, поэтому действует на все её страницы.
+*/
+void *AllocatePages(size_t bytes, const MemoryOptions &options) {
+#ifdef __linux__
+    const size_t size = MappedSize(bytes, options);
+    void *pointer = MAP_FAILED;
+    if (options.huge_pages == HugePages::Explicit) {
+        pointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+    if (pointer == MAP_FAILED) {
+        pointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (pointer == MAP_FAILED) {
+            return nullptr;
+        }
+        if (options.huge_pages != HugePages::None) {
+            madvise(pointer, size, MADV_HUGEPAGE);
+        }
+    }
+
+    // Ошибка mbind не фатальна: память остаётся рабочей, просто без нужного размещения
+    switch (options.placement) {
+    case Placement::Default:
+        break;
+    case Placement::FirstTouch:
+        TouchPerNode(pointer, size);
+        break;
+    case Placement::Node:
+        if (options.node < NodeCount()) {
+            Bind(pointer, size, MPOL_BIND, {options.node});
+        }
+        break;
+    case Placement::Interleave: {
+        std::vector<size_t> nodes(NodeCount());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            nodes[i] = i;
+        }
+        Bind(pointer, size, MPOL_INTERLEAVE, nodes);
+        break;
+    }
+    }
+    return pointer;
+#else
+    (void)options;
+    return ::operator new(bytes, std::align_val_t{HUGE_PAGE_SIZE}, std::nothrow);
+#endif
+}
+
+void FreePages(void *pointer, size_t bytes, const MemoryOptions &options) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+#ifdef __linux__
+    munmap(pointer, MappedSize(bytes, options));
+#else
+    (void)bytes;
+    (void)options;
+    ::operator delete(pointer, std::align_val_t{HUGE_PAGE_SIZE});
+#endif
+}
+
+}  // namespace geometry::numa
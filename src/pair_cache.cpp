@@ -0,0 +1,315 @@
+#include "pair_cache.hpp"
+#include "parallel.hpp"
+#include "queries.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace geometry::collision {
+
+namespace {
+
+// Фигура, покрывающая больше ячеек, не раскладывается по сетке, а проверяется со всеми напрямую
+constexpr int64_t MAX_CELLS_PER_SHAPE = 64;
+// Рёбра скольких вершин фигуры перебираются при поиске разделяющей оси
+constexpr size_t MAX_AXIS_VERTICES = 64;
+// Сколько вершин фигуры пробуется в роли общей точки
+constexpr size_t MAX_CONTACT_CANDIDATES = 16;
+constexpr size_t NARROW_GRAIN = 64;
+
+struct Interval {
+    double min, max;
+};
+
+template <typename T>
+Interval ProjectOf(const T &s, const Point2D &axis) {
+    if constexpr (std::is_same_v<T, Circle>) {
+        const double center = s.center_p.Dot(axis);
+        const double radius = s.radius * axis.Length();
+        return {center - radius, center + radius};
+    } else if constexpr (std::is_same_v<T, InstancedShape>) {
+        // Проекция образа на ось — это проекция прототипа на ось, повёрнутую обратно, со сдвигом и масштабом
+        const auto &t = s.GetTransform();
+        const Point2D local{axis.x * t.cos_angle + axis.y * t.sin_angle, -axis.x * t.sin_angle + axis.y * t.cos_angle};
+        const auto inner = std::visit([&local](const auto &p) { return ProjectOf(p, local); }, s.Prototype());
+        const double shift = t.offset.Dot(axis);
+        return {shift + t.scale * inner.min, shift + t.scale * inner.max};
+    } else {
+        Interval interval{std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest()};
+        for (const auto &p : s.Vertices()) {
+            const double d = p.Dot(axis);
+            interval = {std::min(interval.min, d), std::max(interval.max, d)};
+        }
+        return interval;
+    }
+}
+
+Interval Project(const Shape &shape, const Point2D &axis) {
+    return std::visit([&axis](const auto &s) { return ProjectOf(s, axis); }, shape);
+}
+
+bool Separates(const Shape &a, const Shape &b, const Point2D &axis) {
+    const Interval ia = Project(a, axis);
+    const Interval ib = Project(b, axis);
+    return ia.max < ib.min || ib.max < ia.min;
+}
+
+bool Inside(const Shape &shape, const Point2D &p) { return std::visit(queries::PointInShapeVisitor{p}, shape); }
+
+std::vector<Point2D> VerticesOf(const Shape &shape) {
+    return std::visit(
+        [](const auto &s) {
+            const auto vertices = s.Vertices();
+            return std::vector<Point2D>(vertices.begin(), vertices.end());
+        },
+        shape);
+}
+
+// Ось, на которой проекции фигур не перекрываются: направление между центрами или нормаль ребра (SAT)
+std::optional<Point2D> FindSeparatingAxis(const Shape &a, const Shape &b) {
+    const Point2D between = queries::GetBoundBox(b).Center() - queries::GetBoundBox(a).Center();
+    if (between.Length() > 0 && Separates(a, b, between.Normalize())) {
+        return between.Normalize();
+    }
+    for (const Shape *shape : {&a, &b}) {
+        const auto vertices = VerticesOf(*shape);
+        if (vertices.size() < 2 || vertices.size() > MAX_AXIS_VERTICES) {
+            continue;
+        }
+        for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+            const Point2D edge = vertices[i] - vertices[j];
+            const Point2D normal = Point2D{-edge.y, edge.x}.Normalize();
+            if (normal.Length() > 0 && Separates(a, b, normal)) {
+                return normal;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+// Точка, лежащая в обеих фигурах: центр одной из них или её вершина
+std::optional<Point2D> FindContact(const Shape &a, const Shape &b) {
+    for (const Shape *shape : {&a, &b}) {
+        const Point2D center = std::visit([](const auto &s) -> Point2D { return s.Center(); }, *shape);
+        if (Inside(a, center) && Inside(b, center)) {
+            return center;
+        }
+    }
+    for (const Shape *shape : {&a, &b}) {
+        const auto vertices = VerticesOf(*shape);
+        const size_t stride = std::max<size_t>(1, vertices.size() / MAX_CONTACT_CANDIDATES);
+        for (size_t i = 0; i < vertices.size(); i += stride) {
+            if (Inside(a, vertices[i]) && Inside(b, vertices[i])) {
+                return vertices[i];
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+}  // namespace
+
+PairCache::PairCache(const PairCacheOptions &options) : options_(options) {}
+
+void PairCache::Clear() {
+    cell_size_ = 0.0;
+    boxes_.clear();
+    spans_.clear();
+    oversized_.clear();
+    cells_.clear();
+    seen_.clear();
+    pairs_.clear();
+    partners_.clear();
+}
+
+PairCache::CellSpan PairCache::CellsOf(const BoundingBox &box) const noexcept {
+    auto cell = [this](double v) { return static_cast<int64_t>(std::floor(v / cell_size_)); };
+    return {cell(box.min_x), cell(box.min_y), cell(box.max_x), cell(box.max_y)};
+}
+
+void PairCache::Place(size_t shape, const BoundingBox &box) {
+    boxes_[shape] = box;
+    const CellSpan span = CellsOf(box);
+    if ((span.x1 - span.x0 + 1) * (span.y1 - span.y0 + 1) > MAX_CELLS_PER_SHAPE) {
+        spans_[shape] = {};
+        oversized_.push_back(shape);
+        return;
+    }
+    spans_[shape] = span;
+    for (int64_t y = span.y0; y <= span.y1; ++y) {
+        for (int64_t x = span.x0; x <= span.x1; ++x) {
+            cells_[CellKey(x, y)].push_back(shape);
+        }
+    }
+}
+
+void PairCache::Unplace(size_t shape) {
+    const CellSpan span = spans_[shape];
+    if (span.x1 < span.x0) {
+        std::erase(oversized_, shape);
+        return;
+    }
+    for (int64_t y = span.y0; y <= span.y1; ++y) {
+        for (int64_t x = span.x0; x <= span.x1; ++x) {
+            const auto it = cells_.find(CellKey(x, y));
+            std::erase(it->second, shape);
+            if (it->second.empty()) {
+                cells_.erase(it);
+            }
+        }
+    }
+}
+
+std::vector<size_t> PairCache::Candidates(size_t shape) {
+    const BoundingBox &box = boxes_[shape];
+    std::vector<size_t> found;
+    ++stamp_;
+    seen_[shape] = stamp_;
+    auto consider = [&](size_t other) {
+        if (seen_[other] != stamp_) {
+            seen_[other] = stamp_;
+            if (boxes_[other].Overlaps(box)) {
+                found.push_back(other);
+            }
+        }
+    };
+
+    const CellSpan span = spans_[shape];
+    if (span.x1 < span.x0) {
+        // Большая фигура: перебор всех bounding box дешевле обхода множества ячеек
+        for (size_t other = 0; other < boxes_.size(); ++other) {
+            consider(other);
+        }
+        return found;
+    }
+    for (int64_t y = span.y0; y <= span.y1; ++y) {
+        for (int64_t x = span.x0; x <= span.x1; ++x) {
+            if (const auto it = cells_.find(CellKey(x, y)); it != cells_.end()) {
+                std::ranges::for_each(it->second, consider);
+            }
+        }
+    }
+    std::ranges::for_each(oversized_, consider);
+    return found;
+}
+
+PairCacheStats PairCache::Rebuild(std::span<const Shape> shapes) {
+    Clear();
+    const size_t n = shapes.size();
+    boxes_.resize(n);
+    spans_.resize(n);
+    seen_.assign(n, 0);
+    partners_.resize(n);
+
+    std::vector<size_t> all(n);
+    double mean_extent = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        all[i] = i;
+        boxes_[i] = queries::GetBoundBox(shapes[i]);
+        mean_extent += std::max(boxes_[i].Width(), boxes_[i].Height());
+    }
+    mean_extent /= static_cast<double>(std::max<size_t>(n, 1));
+    cell_size_ = options_.cell_size > 0.0 ? options_.cell_size : (mean_extent > 0.0 ? mean_extent : 1.0);
+    // Раскладка по сетке и все пары — обычным кадром, в котором сдвинулось всё
+    return Update(shapes, all);
+}
+
+/**
+    @brief Кадр: перекладка сдвинувшихся фигур, обновление их пар и узкая фаза только для этих пар
+
+    Пары, в которых ни одна фигура не сдвинулась, не трогаются. Каждая затронутая пара проверяется
+    ровно один раз, даже если сдвинулись обе её фигуры; проверки независимы и идут параллельно.
+*/
+PairCacheStats PairCache::Update(std::span<const Shape> shapes, std::span<const size_t> moved) {
+    if (shapes.size() != boxes_.size() || cell_size_ == 0.0) {
+        return Rebuild(shapes);
+    }
+
+    std::vector<size_t> changed(moved.begin(), moved.end());
+    std::ranges::sort(changed);
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    std::erase_if(changed, [&shapes](size_t i) { return i >= shapes.size(); });
+
+    for (size_t i : changed) {
+        const BoundingBox box = queries::GetBoundBox(shapes[i]);
+        Unplace(i);
+        Place(i, box);
+    }
+
+    std::vector<uint64_t> dirty;
+    for (size_t i : changed) {
+        auto found = Candidates(i);
+        std::ranges::sort(found);
+        for (size_t j : partners_[i]) {
+            if (!std::ranges::binary_search(found, j)) {
+                pairs_.erase(PairKey(std::min(i, j), std::max(i, j)));
+                std::erase(partners_[j], i);
+            }
+        }
+        for (size_t j : found) {
+            const uint64_t key = PairKey(std::min(i, j), std::max(i, j));
+            if (pairs_.try_emplace(key).second) {
+                partners_[j].push_back(i);
+            }
+            dirty.push_back(key);
+        }
+        partners_[i] = std::move(found);
+    }
+    std::ranges::sort(dirty);
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+    std::vector<PairState *> states;
+    states.reserve(dirty.size());
+    for (uint64_t key : dirty) {
+        states.push_back(&pairs_.at(key));
+    }
+
+    const size_t threads = parallel::ResolveThreadCount(options_.threads);
+    std::vector<size_t> warm(threads, 0);
+    parallel::ParallelFor(
+        dirty.size(), NARROW_GRAIN,
+        [&](size_t begin, size_t end, size_t worker) {
+            for (size_t k = begin; k < end; ++k) {
+                const Shape &a = shapes[dirty[k] >> 32];
+                const Shape &b = shapes[dirty[k] & 0xFFFFFFFFu];
+                PairState &state = *states[k];
+
+                if (state.axis && Separates(a, b, *state.axis)) {
+                    state.colliding = false;
+                    ++warm[worker];
+                    continue;
+                }
+                if (state.contact && Inside(a, *state.contact) && Inside(b, *state.contact)) {
+                    state.colliding = true;
+                    ++warm[worker];
+                    continue;
+                }
+
+                state.colliding = queries::ShapesIntersect(a, b);
+                state.axis = state.colliding ? std::nullopt : FindSeparatingAxis(a, b);
+                state.contact = state.colliding ? FindContact(a, b) : std::nullopt;
+            }
+        },
+        threads);
+
+    PairCacheStats stats;
+    stats.pairs = pairs_.size();
+    stats.rechecked = dirty.size();
+    for (size_t count : warm) {
+        stats.warm_started += count;
+    }
+    stats.narrow_phase = stats.rechecked - stats.warm_started;
+    return stats;
+}
+
+std::vector<IndexPair> PairCache::Collisions() const {
+    std::vector<IndexPair> result;
+    for (const auto &[key, state] : pairs_) {
+        if (state.colliding) {
+            result.emplace_back(static_cast<size_t>(key >> 32), static_cast<size_t>(key & 0xFFFFFFFFu));
+        }
+    }
+    std::ranges::sort(result);
+    return result;
+}
+
+}  // namespace geometry::collision
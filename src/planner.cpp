@@ -0,0 +1,389 @@
+#include "planner.hpp"
+#include "convex_hull.hpp"
+#include "parallel.hpp"
+#include "queries.hpp"
+#include "spatial_index.hpp"
+#include "wide_bvh.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace geometry::planner {
+
+namespace {
+
+// Сколько объектов смотрит сбор статистики
+constexpr size_t SAMPLE_SIZE = 1024;
+// Ниже этого числа объектов полный перебор пар быстрее построения любого индекса
+constexpr size_t BRUTE_FORCE_LIMIT = 384;
+// Разброс размеров (p90 / медиана), после которого сетка проигрывает дереву
+constexpr double SKEW_LIMIT = 4.0;
+// Степень скученности, после которой равномерное разбиение перегружает отдельные ячейки
+constexpr double CLUSTERING_LIMIT = 0.5;
+// Сколько объектов должно приходиться на поток, чтобы он окупал свой запуск
+constexpr size_t ITEMS_PER_THREAD = 4096;
+constexpr size_t HULL_POINTS_PER_THREAD = 100000;
+// Ниже этого числа точек отсев не окупается
+constexpr size_t HULL_FILTER_LIMIT = 1024;
+// Если отсев оставляет больше этой доли точек, он только мешает
+constexpr double HULL_SURVIVOR_LIMIT = 0.5;
+constexpr size_t COLLISION_GRAIN = 64;
+
+size_t ThreadsFor(size_t work, size_t per_thread, const PlannerOptions &options) {
+    return std::clamp<size_t>(work / per_thread, 1, parallel::ResolveThreadCount(options.threads));
+}
+
+std::vector<BoundingBox> CollectBoxes(std::span<const Shape> shapes) {
+    std::vector<BoundingBox> boxes;
+    boxes.reserve(shapes.size());
+    for (const auto &shape : shapes) {
+        boxes.push_back(queries::GetBoundBox(shape));
+    }
+    return boxes;
+}
+
+/**
+    @brief Восьмиугольник крайних точек по осям и диагоналям (против часовой стрелки)
+
+    Точки строго внутри него не могут быть вершинами оболочки. Если крайние точки совпадают так, что
+    вершин меньше трёх, возвращается пустой вектор — отсеивать нечего.
+*/
+std::vector<Point2D> ExtremeOctagon(std::span<const Point2D> points) {
+    // Направления в порядке обхода против часовой стрелки, начиная с нижней точки
+    constexpr std::array<std::pair<double, double>, 8> DIRECTIONS{
+        {{0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}}};
+    std::vector<Point2D> octagon;
+    for (const auto &[dx, dy] : DIRECTIONS) {
+        const Point2D best = *std::ranges::max_element(
+            points, [dx, dy](const Point2D &l, const Point2D &r) { return l.x * dx + l.y * dy < r.x * dx + r.y * dy; });
+        if (octagon.empty() || (best != octagon.back() && best != octagon.front())) {
+            octagon.push_back(best);
+        }
+    }
+    if (octagon.size() < 3) {
+        octagon.clear();
+    }
+    return octagon;
+}
+
+bool StrictlyInside(std::span<const Point2D> convex, const Point2D &p) {
+    for (size_t i = 0, j = convex.size() - 1; i < convex.size(); j = i++) {
+        if ((convex[i] - convex[j]).Cross(p - convex[j]) <= 0.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Отсев Акла–Туссена: остаются только точки, которые могут оказаться вершинами оболочки
+std::vector<Point2D> AklToussaintFilter(std::span<const Point2D> points) {
+    const auto octagon = ExtremeOctagon(points);
+    if (octagon.empty()) {
+        return {points.begin(), points.end()};
+    }
+    std::vector<Point2D> kept;
+    for (const auto &p : points) {
+        if (!StrictlyInside(octagon, p)) {
+            kept.push_back(p);
+        }
+    }
+    return kept;
+}
+
+std::expected<std::vector<Point2D>, std::string> FilteredHull(std::span<const Point2D> points) {
+    auto kept = AklToussaintFilter(points);
+    return convex_hull::GrahamScan(kept);
+}
+
+}  // namespace
+
+/**
+    @brief Статистики по выборке из не более чем SAMPLE_SIZE равномерно взятых объектов
+
+    Габарит считается по всем объектам — это один проход без ветвлений. Скученность оценивается
+    по грубой сетке примерно с одной ячейкой на объект выборки: число занятых ячеек сравнивается
+    с ожидаемым для равномерно разбросанных центров K(1 - (1 - 1/K)^m).
+*/
+DataStats CollectStats(std::span<const BoundingBox> boxes) {
+    DataStats stats;
+    stats.count = boxes.size();
+    if (boxes.empty()) {
+        return stats;
+    }
+    stats.extent = index::UnionBox(boxes);
+
+    const size_t stride = std::max<size_t>(1, boxes.size() / SAMPLE_SIZE);
+    std::vector<double> sizes;
+    std::vector<Point2D> centers;
+    for (size_t i = 0; i < boxes.size(); i += stride) {
+        sizes.push_back(std::max(boxes[i].Width(), boxes[i].Height()));
+        centers.push_back(boxes[i].Center());
+    }
+    stats.sampled = sizes.size();
+
+    auto quantile = [&sizes](double q) {
+        const auto nth = sizes.begin() + static_cast<ptrdiff_t>(q * static_cast<double>(sizes.size() - 1));
+        std::ranges::nth_element(sizes, nth);
+        return *nth;
+    };
+    stats.median_size = quantile(0.5);
+    stats.p90_size = quantile(0.9);
+    stats.max_size = *std::ranges::max_element(sizes);
+
+    for (double size : sizes) {
+        size_t bin = 0;
+        if (size > 0.0 && stats.median_size > 0.0) {
+            const double octave = std::floor(std::log2(size / stats.median_size)) + DataStats::HISTOGRAM_BINS / 2;
+            bin = static_cast<size_t>(std::clamp(octave, 0.0, double(DataStats::HISTOGRAM_BINS - 1)));
+        }
+        ++stats.size_histogram[bin];
+    }
+
+    const auto side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(centers.size()))));
+    const double cells = static_cast<double>(side * side);
+    const double width = std::max(stats.extent.Width(), 1e-12);
+    const double height = std::max(stats.extent.Height(), 1e-12);
+    std::vector<bool> occupied(side * side, false);
+    for (const auto &c : centers) {
+        const auto cx = std::min(side - 1, static_cast<size_t>((c.x - stats.extent.min_x) / width * double(side)));
+        const auto cy = std::min(side - 1, static_cast<size_t>((c.y - stats.extent.min_y) / height * double(side)));
+        occupied[cy * side + cx] = true;
+    }
+    const double expected = cells * (1.0 - std::pow(1.0 - 1.0 / cells, static_cast<double>(centers.size())));
+    const auto filled = static_cast<double>(std::ranges::count(occupied, true));
+    stats.clustering = std::clamp(1.0 - filled / expected, 0.0, 1.0);
+    return stats;
+}
+
+CollisionPlan PlanCollisions(std::span<const BoundingBox> boxes, const PlannerOptions &options) {
+    CollisionPlan plan;
+    plan.stats = CollectStats(boxes);
+    const DataStats &s = plan.stats;
+
+    if (s.count < BRUTE_FORCE_LIMIT) {
+        plan.engine = BroadPhase::BruteForce;
+        plan.reason = std::format("{} objects: pairwise check is cheaper than an index", s.count);
+        return plan;
+    }
+    plan.threads = ThreadsFor(s.count, ITEMS_PER_THREAD, options);
+    if (s.SizeSkew() > SKEW_LIMIT || s.clustering > CLUSTERING_LIMIT) {
+        plan.engine = BroadPhase::Bvh;
+        plan.leaf_size = index::WideBvh::WIDTH;
+        plan.reason = std::format("size skew {:.2f}, clustering {:.2f}: grid cells would be uneven", s.SizeSkew(),
+                                  s.clustering);
+        return plan;
+    }
+    plan.engine = BroadPhase::HashGrid;
+    // Ячейка в два типичных размера: объект занимает не больше четырёх ячеек, а в ячейке мало чужих
+    plan.cell_size = 2.0 * s.median_size;
+    plan.reason = std::format("uniform sizes (skew {:.2f}) and spread (clustering {:.2f})", s.SizeSkew(),
+                              s.clustering);
+    return plan;
+}
+
+JoinPlan PlanJoin(std::span<const BoundingBox> a, std::span<const BoundingBox> b, bool exact,
+                  const PlannerOptions &options) {
+    JoinPlan plan;
+    plan.a_stats = CollectStats(a);
+    plan.b_stats = CollectStats(b);
+    plan.options.exact = exact;
+
+    const size_t smaller = std::min(a.size(), b.size());
+    const size_t larger = std::max(a.size(), b.size());
+    plan.options.threads = ThreadsFor(a.size() + b.size(), ITEMS_PER_THREAD, options);
+    const double skew = std::max(plan.a_stats.SizeSkew(), plan.b_stats.SizeSkew());
+    const double clustering = std::max(plan.a_stats.clustering, plan.b_stats.clustering);
+
+    if (larger < BRUTE_FORCE_LIMIT) {
+        plan.options.strategy = join::JoinStrategy::IndexNestedLoop;
+        plan.reason = std::format("{}x{} objects: a single-thread probe of a small index", a.size(), b.size());
+    } else if (join::ChooseJoinStrategy(a.size(), b.size()) == join::JoinStrategy::IndexNestedLoop) {
+        plan.options.strategy = join::JoinStrategy::IndexNestedLoop;
+        plan.reason = std::format("sizes differ {:.1f}x: index the smaller set",
+                                  static_cast<double>(larger) / static_cast<double>(std::max<size_t>(smaller, 1)));
+    } else if (skew > SKEW_LIMIT || clustering > CLUSTERING_LIMIT) {
+        // Крупные объекты размножаются по многим плиткам разбиения, а скопления перегружают отдельные плитки
+        plan.options.strategy = join::JoinStrategy::IndexNestedLoop;
+        plan.reason = std::format("size skew {:.2f}, clustering {:.2f}: uniform tiles would be uneven", skew,
+                                  clustering);
+    } else {
+        plan.options.strategy = join::JoinStrategy::Partition;
+        plan.reason = std::format("comparable uniform sets (skew {:.2f}, clustering {:.2f})", skew, clustering);
+    }
+    return plan;
+}
+
+HullPlan PlanHull(std::span<const Point2D> points, const PlannerOptions &options) {
+    HullPlan plan;
+    plan.count = points.size();
+    if (points.size() < HULL_FILTER_LIMIT) {
+        plan.reason = std::format("{} points: filtering does not pay off", points.size());
+        return plan;
+    }
+
+    // Доля точек выборки вне восьмиугольника её крайних точек — оценка того, сколько переживёт отсев
+    const size_t stride = std::max<size_t>(1, points.size() / SAMPLE_SIZE);
+    std::vector<Point2D> sample;
+    for (size_t i = 0; i < points.size(); i += stride) {
+        sample.push_back(points[i]);
+    }
+    plan.filter_survivors = static_cast<double>(AklToussaintFilter(sample).size()) / static_cast<double>(sample.size());
+    if (plan.filter_survivors > HULL_SURVIVOR_LIMIT) {
+        plan.reason = std::format("{:.0f}% of points lie on the hull side of the octagon", 100 * plan.filter_survivors);
+        return plan;
+    }
+
+    plan.threads = ThreadsFor(points.size(), HULL_POINTS_PER_THREAD, options);
+    plan.algorithm = plan.threads > 1 ? HullAlgorithm::ParallelChunks : HullAlgorithm::AklToussaint;
+    plan.reason = std::format("octagon filter keeps {:.0f}% of points", 100 * plan.filter_survivors);
+    return plan;
+}
+
+/**
+    @brief Поиск пересекающихся пар с выбранной широкой фазой
+
+    Каждая пара проверяется из объекта с меньшим индексом, поэтому дубликатов нет; кандидаты сначала
+    сверяются по точным bounding box (дерево отдаёт их консервативно), затем queries::ShapesIntersect.
+*/
+std::vector<IndexPair> FindCollisions(std::span<const Shape> shapes, const CollisionPlan &plan) {
+    const auto boxes = CollectBoxes(shapes);
+    std::vector<std::vector<IndexPair>> per_worker(std::max<size_t>(plan.threads, 1));
+    auto check = [&](size_t i, size_t j, std::vector<IndexPair> &out) {
+        if (j > i && boxes[i].Overlaps(boxes[j]) && queries::ShapesIntersect(shapes[i], shapes[j])) {
+            out.emplace_back(i, j);
+        }
+    };
+
+    auto run = [&](auto &&probe) {
+        parallel::ParallelFor(
+            shapes.size(), COLLISION_GRAIN,
+            [&](size_t begin, size_t end, size_t worker) {
+                for (size_t i = begin; i < end; ++i) {
+                    probe(i, per_worker[worker]);
+                }
+            },
+            per_worker.size());
+    };
+
+    switch (plan.engine) {
+    case BroadPhase::BruteForce:
+        run([&](size_t i, auto &out) {
+            for (size_t j = i + 1; j < shapes.size(); ++j) {
+                check(i, j, out);
+            }
+        });
+        break;
+    case BroadPhase::HashGrid: {
+        const index::GridIndex grid(boxes, plan.cell_size);
+        run([&](size_t i, auto &out) { grid.Query(boxes[i], [&](size_t j) { check(i, j, out); }); });
+        break;
+    }
+    case BroadPhase::Bvh: {
+        const index::WideBvh bvh(boxes);
+        run([&](size_t i, auto &out) { bvh.Query(boxes[i], [&](size_t j) { check(i, j, out); }); });
+        break;
+    }
+    }
+
+    std::vector<IndexPair> result;
+    for (const auto &part : per_worker) {
+        result.insert(result.end(), part.begin(), part.end());
+    }
+    std::ranges::sort(result);
+    return result;
+}
+
+std::vector<IndexPair> FindCollisions(std::span<const Shape> shapes, CollisionPlan *chosen) {
+    const auto plan = PlanCollisions(CollectBoxes(shapes));
+    if (chosen != nullptr) {
+        *chosen = plan;
+    }
+    return FindCollisions(shapes, plan);
+}
+
+std::vector<IndexPair> SpatialJoin(std::span<const Shape> a, std::span<const Shape> b, bool exact, JoinPlan *chosen) {
+    const auto plan = PlanJoin(CollectBoxes(a), CollectBoxes(b), exact);
+    if (chosen != nullptr) {
+        *chosen = plan;
+    }
+    return join::SpatialJoin(a, b, plan.options);
+}
+
+std::expected<std::vector<Point2D>, std::string> ConvexHull(std::span<const Point2D> points, const HullPlan &plan) {
+    switch (plan.algorithm) {
+    case HullAlgorithm::GrahamScan: {
+        std::vector<Point2D> copy(points.begin(), points.end());
+        return convex_hull::GrahamScan(copy);
+    }
+    case HullAlgorithm::AklToussaint:
+        return FilteredHull(points);
+    case HullAlgorithm::ParallelChunks:
+        break;
+    }
+
+    // Вершины оболочки всего набора — вершины оболочек его кусков
+    const size_t chunks = std::max<size_t>(plan.threads, 1);
+    std::vector<std::vector<Point2D>> partial(chunks);
+    parallel::ParallelFor(
+        chunks, 1,
+        [&](size_t begin, size_t end, size_t) {
+            for (size_t c = begin; c < end; ++c) {
+                const auto part = points.subspan(points.size() * c / chunks,
+                                                 points.size() * (c + 1) / chunks - points.size() * c / chunks);
+                auto hull = FilteredHull(part);
+                partial[c] = hull ? std::move(*hull) : std::vector<Point2D>(part.begin(), part.end());
+            }
+        },
+        chunks);
+
+    std::vector<Point2D> candidates;
+    for (const auto &part : partial) {
+        candidates.insert(candidates.end(), part.begin(), part.end());
+    }
+    return convex_hull::GrahamScan(candidates);
+}
+
+std::expected<std::vector<Point2D>, std::string> ConvexHull(std::span<const Point2D> points, HullPlan *chosen) {
+    const auto plan = PlanHull(points);
+    if (chosen != nullptr) {
+        *chosen = plan;
+    }
+    return ConvexHull(points, plan);
+}
+
+std::string_view ToString(BroadPhase engine) noexcept {
+    switch (engine) {
+    case BroadPhase::BruteForce:
+        return "brute-force";
+    case BroadPhase::HashGrid:
+        return "hash-grid";
+    case BroadPhase::Bvh:
+        return "bvh";
+    }
+    return "unknown";
+}
+
+std::string_view ToString(join::JoinStrategy strategy) noexcept {
+    switch (strategy) {
+    case join::JoinStrategy::Auto:
+        return "auto";
+    case join::JoinStrategy::IndexNestedLoop:
+        return "index-nested-loop";
+    case join::JoinStrategy::Partition:
+        return "partition";
+    }
+    return "unknown";
+}
+
+std::string_view ToString(HullAlgorithm algorithm) noexcept {
+    switch (algorithm) {
+    case HullAlgorithm::GrahamScan:
+        return "graham-scan";
+    case HullAlgorithm::AklToussaint:
+        return "akl-toussaint";
+    case HullAlgorithm::ParallelChunks:
+        return "parallel-chunks";
+    }
+    return "unknown";
+}
+
+}  // namespace geometry::planner
@@ -0,0 +1,266 @@
+#include "point_location.hpp"
+#include "parallel.hpp"
+#include "point_set.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <unordered_map>
+
+namespace geometry::triangulation {
+
+namespace {
+
+constexpr size_t TRIANGLES_PER_CELL = 2;
+constexpr size_t BATCH_GRAIN = 1024;
+
+bool Contains(const Triangle &t, const Point2D &p) noexcept {
+    return (t.b - t.a).Cross(p - t.a) >= 0 && (t.c - t.b).Cross(p - t.b) >= 0 && (t.a - t.c).Cross(p - t.c) >= 0;
+}
+
+/**
+    @brief Проверяет, что граница сетки — один выпуклый контур
+
+    Граничные рёбра обходятся так, что сетка лежит слева; правый поворот на границе или вершина,
+    из которой выходят два граничных ребра (дыра, касание частей), означают невыпуклость.
+*/
+bool IsConvexMesh(const TriangleMesh &mesh) {
+    std::unordered_map<size_t, size_t> boundary_next;
+    for (size_t t = 0; t < mesh.Size(); ++t) {
+        for (size_t k = 0; k < 3; ++k) {
+            if (mesh.neighbors[t][k] == NO_NEIGHBOR &&
+                !boundary_next.emplace(mesh.triangles[t][k], mesh.triangles[t][(k + 1) % 3]).second) {
+                return false;
+            }
+        }
+    }
+
+    size_t loop_length = 0;
+    for (const auto &[a, b] : boundary_next) {
+        const auto it = boundary_next.find(b);
+        if (it == boundary_next.end()) {
+            return false;
+        }
+        const Point2D &pa = mesh.vertices[a], &pb = mesh.vertices[b], &pc = mesh.vertices[it->second];
+        const double turn = (pb - pa).Cross(pc - pb);
+        if (turn < -EPS * (pb - pa).Length() * (pc - pb).Length()) {
+            return false;
+        }
+    }
+
+    // Несколько контуров (несвязные части сетки) тоже не выпуклы
+    if (!boundary_next.empty()) {
+        const size_t first = boundary_next.begin()->first;
+        size_t v = first;
+        do {
+            v = boundary_next.at(v);
+            ++loop_length;
+        } while (v != first && loop_length <= boundary_next.size());
+    }
+    return loop_length == boundary_next.size();
+}
+
+}  // namespace
+
+PointLocator::PointLocator(const TriangleMesh &mesh) : mesh_(&mesh) {
+    if (mesh.Size() == 0) {
+        return;
+    }
+
+    bounds_ = {mesh.vertices[mesh.triangles[0][0]].x, mesh.vertices[mesh.triangles[0][0]].y,
+               mesh.vertices[mesh.triangles[0][0]].x, mesh.vertices[mesh.triangles[0][0]].y};
+    for (const auto &tri : mesh.triangles) {
+        for (size_t v : tri) {
+            bounds_.min_x = std::min(bounds_.min_x, mesh.vertices[v].x);
+            bounds_.min_y = std::min(bounds_.min_y, mesh.vertices[v].y);
+            bounds_.max_x = std::max(bounds_.max_x, mesh.vertices[v].x);
+            bounds_.max_y = std::max(bounds_.max_y, mesh.vertices[v].y);
+        }
+    }
+
+    // Ячейки почти квадратные, в среднем TRIANGLES_PER_CELL треугольников на ячейку
+    const double cells = std::max(1.0, static_cast<double>(mesh.Size() / TRIANGLES_PER_CELL));
+    const double aspect = bounds_.Width() / std::max(bounds_.Height(), std::numeric_limits<double>::min());
+    nx_ = static_cast<size_t>(std::clamp(std::sqrt(cells * aspect), 1.0, cells));
+    ny_ = static_cast<size_t>(std::clamp(cells / static_cast<double>(nx_), 1.0, cells));
+    cell_width_ = std::max(bounds_.Width() / static_cast<double>(nx_), std::numeric_limits<double>::min());
+    cell_height_ = std::max(bounds_.Height() / static_cast<double>(ny_), std::numeric_limits<double>::min());
+
+    // Затравка ячейки — треугольник с центром в ней, ближайший к центру ячейки
+    seeds_.assign(nx_ * ny_, NO_NEIGHBOR);
+    std::vector<double> best(seeds_.size(), std::numeric_limits<double>::infinity());
+    for (size_t t = 0; t < mesh.Size(); ++t) {
+        const Point2D center = mesh.GetTriangle(t).Center();
+        const size_t cell = CellOf(center);
+        const double cx = bounds_.min_x + (static_cast<double>(cell % nx_) + 0.5) * cell_width_;
+        const double cy = bounds_.min_y + (static_cast<double>(cell / nx_) + 0.5) * cell_height_;
+        const double d = center.DistanceTo({cx, cy});
+        if (d < best[cell]) {
+            best[cell] = d;
+            seeds_[cell] = t;
+        }
+    }
+
+    // Пустые ячейки наследуют затравку ближайшей по сетке заполненной ячейки
+    std::queue<size_t> frontier;
+    for (size_t cell = 0; cell < seeds_.size(); ++cell) {
+        if (seeds_[cell] != NO_NEIGHBOR) {
+            frontier.push(cell);
+        }
+    }
+    while (!frontier.empty()) {
+        const size_t cell = frontier.front();
+        frontier.pop();
+        const size_t x = cell % nx_, y = cell / nx_;
+        auto spread = [&](size_t next) {
+            if (seeds_[next] == NO_NEIGHBOR) {
+                seeds_[next] = seeds_[cell];
+                frontier.push(next);
+            }
+        };
+        if (x > 0) {
+            spread(cell - 1);
+        }
+        if (x + 1 < nx_) {
+            spread(cell + 1);
+        }
+        if (y > 0) {
+            spread(cell - nx_);
+        }
+        if (y + 1 < ny_) {
+            spread(cell + nx_);
+        }
+    }
+
+    convex_ = IsConvexMesh(mesh);
+    if (!convex_) {
+        std::vector<BoundingBox> boxes;
+        boxes.reserve(mesh.Size());
+        for (size_t t = 0; t < mesh.Size(); ++t) {
+            boxes.push_back(mesh.GetTriangle(t).BoundBox());
+        }
+        fallback_ = index::GridIndex(boxes);
+    }
+}
+
+size_t PointLocator::CellOf(const Point2D &p) const noexcept {
+    const double fx = std::floor((p.x - bounds_.min_x) / cell_width_);
+    const double fy = std::floor((p.y - bounds_.min_y) / cell_height_);
+    const auto cx = static_cast<size_t>(std::clamp(fx, 0.0, static_cast<double>(nx_ - 1)));
+    const auto cy = static_cast<size_t>(std::clamp(fy, 0.0, static_cast<double>(ny_ - 1)));
+    return cy * nx_ + cx;
+}
+
+std::optional<size_t> PointLocator::Locate(const Point2D &p) const {
+    if (seeds_.empty()) {
+        return std::nullopt;
+    }
+    return Walk(p, seeds_[CellOf(p)]);
+}
+
+std::optional<size_t> PointLocator::Locate(const Point2D &p, size_t hint) const {
+    if (hint >= mesh_->Size()) {
+        return Locate(p);
+    }
+    return Walk(p, hint);
+}
+
+/**
+    @brief Обход с запоминанием: переход через ребро, за которым лежит точка, кроме ребра, через которое пришли
+
+    Ребро для проверки первым выбирается псевдослучайно, что исключает зацикливание на триангуляциях,
+    не являющихся триангуляциями Делоне. Число шагов ограничено числом треугольников, после чего
+    (как и при выходе за невыпуклую границу) точка ищется по индексу.
+*/
+std::optional<size_t> PointLocator::Walk(const Point2D &p, size_t from) const {
+    const auto &mesh = *mesh_;
+    size_t t = from;
+    size_t previous = NO_NEIGHBOR;
+    auto state = static_cast<uint32_t>(from * 2654435761u) | 1u;
+
+    for (size_t step = 0; step <= mesh.Size(); ++step) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        const size_t first = state % 3;
+
+        size_t next = t;
+        for (size_t i = 0; i < 3; ++i) {
+            const size_t k = (first + i) % 3;
+            const size_t neighbor = mesh.neighbors[t][k];
+            if (neighbor != NO_NEIGHBOR && neighbor == previous) {
+                continue;
+            }
+            const Point2D &a = mesh.vertices[mesh.triangles[t][k]];
+            const Point2D &b = mesh.vertices[mesh.triangles[t][(k + 1) % 3]];
+            if ((b - a).Cross(p - a) < 0) {
+                next = neighbor;
+                break;
+            }
+        }
+
+        if (next == t) {
+            return t;
+        }
+        if (next == NO_NEIGHBOR) {
+            return convex_ ? std::nullopt : Scan(p);
+        }
+        previous = t;
+        t = next;
+    }
+    return Scan(p);
+}
+
+std::optional<size_t> PointLocator::Scan(const Point2D &p) const {
+    std::optional<size_t> found;
+    if (!convex_) {
+        fallback_.Query({p.x, p.y, p.x, p.y}, [&](size_t t) {
+            if (!found && Contains(mesh_->GetTriangle(t), p)) {
+                found = t;
+            }
+        });
+        return found;
+    }
+    for (size_t t = 0; t < mesh_->Size() && !found; ++t) {
+        if (Contains(mesh_->GetTriangle(t), p)) {
+            found = t;
+        }
+    }
+    return found;
+}
+
+/**
+    @brief Пакетная локализация: запросы идут вдоль кривой Гильберта, соседние ответы служат подсказками
+
+    Блоки упорядоченных запросов обрабатываются параллельно; внутри блока обход начинается из треугольника
+    предыдущего ответа или из затравки ячейки — смотря что ближе к точке.
+*/
+std::vector<std::optional<size_t>> PointLocator::LocateAll(std::span<const Point2D> points, size_t threads) const {
+    std::vector<std::optional<size_t>> result(points.size());
+    if (seeds_.empty()) {
+        return result;
+    }
+    const auto order = point_set::HilbertOrder(points);
+
+    parallel::ParallelFor(
+        order.size(), BATCH_GRAIN,
+        [&](size_t begin, size_t end, size_t) {
+            size_t hint = NO_NEIGHBOR;
+            for (size_t i = begin; i < end; ++i) {
+                const Point2D &p = points[order[i]];
+                size_t from = seeds_[CellOf(p)];
+                if (hint != NO_NEIGHBOR &&
+                    mesh_->GetTriangle(hint).Center().DistanceTo(p) < mesh_->GetTriangle(from).Center().DistanceTo(p)) {
+                    from = hint;
+                }
+                result[order[i]] = Walk(p, from);
+                if (result[order[i]]) {
+                    hint = *result[order[i]];
+                }
+            }
+        },
+        threads);
+    return result;
+}
+
+}  // namespace geometry::triangulation
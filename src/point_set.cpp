@@ -0,0 +1,198 @@
+#include "point_set.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace geometry::point_set {
+
+namespace {
+
+constexpr size_t NO_NEXT = std::numeric_limits<size_t>::max();
+constexpr uint32_t HILBERT_ORDER = 16;  // Бит на координату
+// Предел номера ячейки: соседние номера cell ± 1 тоже умещаются в int64_t
+constexpr double MAX_CELL = 0x1p62;
+
+struct CellKey {
+    int64_t x, y;
+
+    [[nodiscard]] constexpr bool operator==(const CellKey &other) const noexcept = default;
+};
+
+struct CellKeyHash {
+    [[nodiscard]] size_t operator()(const CellKey &key) const noexcept {
+        const auto hx = static_cast<uint64_t>(key.x) * 0x9e3779b97f4a7c15ULL;
+        const auto hy = static_cast<uint64_t>(key.y) * 0xc2b2ae3d27d4eb4fULL;
+        return static_cast<size_t>(hx ^ (hy >> 1));
+    }
+};
+
+// Номер ячейки по одной координате. Если частное не умещается в int64_t или координата не конечна, шаг
+// double на этой величине уже больше tolerance и сваривать можно только равные координаты — номером служат их биты
+int64_t CellCoordinate(double v, double tolerance) noexcept {
+    const double cell = std::floor(v / tolerance);
+    if (std::abs(cell) <= MAX_CELL) {
+        return static_cast<int64_t>(cell);
+    }
+    return std::bit_cast<int64_t>(v) >> 1;
+}
+
+WeldResult RemoveDuplicatesWithRemap(std::span<const Point2D> points) {
+    WeldResult result;
+    result.remap.reserve(points.size());
+
+    std::unordered_map<Point2D, size_t> index;
+    index.reserve(points.size());
+
+    for (const auto &p : points) {
+        auto [it, inserted] = index.try_emplace(p, result.points.size());
+        if (inserted) {
+            result.points.push_back(p);
+        }
+        result.remap.push_back(it->second);
+    }
+    return result;
+}
+
+// Номер ячейки (x, y) решётки 2^HILBERT_ORDER x 2^HILBERT_ORDER вдоль кривой Гильберта
+uint64_t HilbertIndex(uint32_t x, uint32_t y) noexcept {
+    uint64_t d = 0;
+    for (uint32_t s = 1u << (HILBERT_ORDER - 1); s > 0; s >>= 1) {
+        const uint32_t rx = (x & s) != 0 ? 1 : 0;
+        const uint32_t ry = (y & s) != 0 ? 1 : 0;
+        d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+        // Поворот квадранта, чтобы кривая в нём шла в стандартной ориентации
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+}  // namespace
+
+/**
+    @brief Удаляет точные дубликаты за ожидаемое линейное время, сохраняя порядок первого появления
+*/
+std::vector<Point2D> RemoveDuplicates(std::span<const Point2D> points) {
+    std::vector<Point2D> result;
+    result.reserve(points.size());
+
+    std::unordered_set<Point2D> seen;
+    seen.reserve(points.size());
+
+    for (const auto &p : points) {
+        if (seen.insert(p).second) {
+            result.push_back(p);
+        }
+    }
+    return result;
+}
+
+/**
+    @brief Сваривает точки, находящиеся ближе tolerance друг к другу, в одного представителя
+
+    Точки раскладываются по хеш-сетке с шагом tolerance, поэтому кандидаты на слияние ищутся только
+    в соседних 3x3 ячейках. При tolerance <= 0 выполняется точная дедупликация. Координаты, для которых
+    номер ячейки не умещается в int64_t (очень большие или не конечные), сваривает только точное равенство.
+*/
+WeldResult WeldVertices(std::span<const Point2D> points, double tolerance) {
+    if (!(tolerance > 0.0)) {
+        return RemoveDuplicatesWithRemap(points);
+    }
+
+    WeldResult result;
+    result.remap.reserve(points.size());
+
+    // Представители одной ячейки связаны в односвязный список: голова в cells, продолжение в next
+    std::unordered_map<CellKey, size_t, CellKeyHash> cells;
+    cells.reserve(points.size());
+    std::vector<size_t> next;
+
+    const double tolerance_sq = tolerance * tolerance;
+    auto cell_of = [tolerance](const Point2D &p) {
+        return CellKey{CellCoordinate(p.x, tolerance), CellCoordinate(p.y, tolerance)};
+    };
+
+    for (const auto &p : points) {
+        const CellKey cell = cell_of(p);
+        size_t found = NO_NEXT;
+
+        for (int64_t dx = -1; dx <= 1 && found == NO_NEXT; ++dx) {
+            for (int64_t dy = -1; dy <= 1 && found == NO_NEXT; ++dy) {
+                auto it = cells.find({cell.x + dx, cell.y + dy});
+                if (it == cells.end()) {
+                    continue;
+                }
+                for (size_t rep = it->second; rep != NO_NEXT; rep = next[rep]) {
+                    // Разность бесконечных координат — NaN, поэтому их точные дубликаты сравниваются отдельно
+                    const Point2D d = result.points[rep] - p;
+                    if (d.Dot(d) <= tolerance_sq || result.points[rep] == p) {
+                        found = rep;
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (found == NO_NEXT) {
+            found = result.points.size();
+            result.points.push_back(p);
+
+            auto [it, inserted] = cells.try_emplace(cell, found);
+            next.push_back(inserted ? NO_NEXT : it->second);
+            it->second = found;
+        }
+        result.remap.push_back(found);
+    }
+
+    return result;
+}
+
+/**
+    @brief Сортирует точки вдоль кривой Гильберта над их общим ограничивающим прямоугольником
+
+    Координаты квантуются до 16 бит, так что порядок точек внутри одной ячейки решётки произволен.
+    Обработка запросов в этом порядке сохраняет пространственную локальность между соседними запросами.
+*/
+std::vector<size_t> HilbertOrder(std::span<const Point2D> points) {
+    if (points.empty()) {
+        return {};
+    }
+    BoundingBox bounds{points.front().x, points.front().y, points.front().x, points.front().y};
+    for (const auto &p : points) {
+        bounds.min_x = std::min(bounds.min_x, p.x);
+        bounds.min_y = std::min(bounds.min_y, p.y);
+        bounds.max_x = std::max(bounds.max_x, p.x);
+        bounds.max_y = std::max(bounds.max_y, p.y);
+    }
+
+    constexpr double CELLS = static_cast<double>((1u << HILBERT_ORDER) - 1);
+    const double extent = std::max({bounds.Width(), bounds.Height(), std::numeric_limits<double>::min()});
+    auto quantize = [&](double v, double origin) {
+        return static_cast<uint32_t>(std::clamp((v - origin) / extent * CELLS, 0.0, CELLS));
+    };
+
+    std::vector<std::pair<uint64_t, size_t>> keyed;
+    keyed.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        keyed.emplace_back(HilbertIndex(quantize(points[i].x, bounds.min_x), quantize(points[i].y, bounds.min_y)), i);
+    }
+    std::ranges::sort(keyed);
+
+    std::vector<size_t> order;
+    order.reserve(points.size());
+    for (const auto &[key, i] : keyed) {
+        order.push_back(i);
+    }
+    return order;
+}
+
+}  // namespace geometry::point_set
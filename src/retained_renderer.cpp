@@ -0,0 +1,272 @@
+#include "retained_renderer.hpp"
+#include "parallel.hpp"
+#include "queries.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace geometry::visualization {
+
+namespace {
+
+// Цвета контуров те же, что у Draw
+template <typename T>
+constexpr Rgb ColorOf() {
+    if constexpr (std::is_same_v<T, Line>) {
+        return {255, 255, 0};
+    } else if constexpr (std::is_same_v<T, Triangle>) {
+        return {0, 0, 255};
+    } else if constexpr (std::is_same_v<T, Rectangle>) {
+        return {0, 128, 0};
+    } else if constexpr (std::is_same_v<T, RegularPolygon>) {
+        return {255, 0, 255};
+    } else if constexpr (std::is_same_v<T, Circle>) {
+        return {255, 0, 0};
+    } else {
+        return {0, 255, 255};
+    }
+}
+
+// Пиксельная координата, приведённая к диапазону, в котором её можно безопасно перевести в целое
+int64_t ClampToPixel(double v, double limit) noexcept {
+    return static_cast<int64_t>(std::clamp(std::floor(v), -1.0, limit + 1.0));
+}
+
+}  // namespace
+
+RetainedRenderer::RetainedRenderer(const RenderOptions &options) : options_(options) {
+    options_.line_width = std::max<size_t>(options_.line_width, 1);
+    options_.tile_size = std::max<size_t>(options_.tile_size, 1);
+    image_.width = options_.width;
+    image_.height = options_.height;
+    image_.pixels.assign(image_.width * image_.height, options_.background);
+
+    tiles_x_ = (image_.width + options_.tile_size - 1) / options_.tile_size;
+    tiles_y_ = (image_.height + options_.tile_size - 1) / options_.tile_size;
+    tiles_.resize(tiles_x_ * tiles_y_);
+}
+
+/**
+    @brief Пиксели, которые может закрасить контур внутри прямоугольника мира
+
+    Точка контура попадает в пиксель floor(координаты), вокруг которого ставится квадратная кисть
+    line_width × line_width; ещё пиксель запаса покрывает округление при переводе координат.
+*/
+RetainedRenderer::PixelRect RetainedRenderer::ToPixels(const BoundingBox &box) const noexcept {
+    const auto &view = options_.view;
+    const double sx = static_cast<double>(image_.width) / view.Width();
+    const double sy = static_cast<double>(image_.height) / view.Height();
+    const double w = static_cast<double>(image_.width), h = static_cast<double>(image_.height);
+    const auto before = static_cast<int64_t>((options_.line_width - 1) / 2) + 1;
+    const auto after = static_cast<int64_t>(options_.line_width / 2) + 2;
+
+    const int64_t x0 = ClampToPixel((box.min_x - view.min_x) * sx, w) - before;
+    const int64_t x1 = ClampToPixel((box.max_x - view.min_x) * sx, w) + after;
+    const int64_t y0 = ClampToPixel((view.max_y - box.max_y) * sy, h) - before;
+    const int64_t y1 = ClampToPixel((view.max_y - box.min_y) * sy, h) + after;
+
+    const auto clamp_x = [this](int64_t v) { return static_cast<size_t>(std::clamp<int64_t>(v, 0, image_.width)); };
+    const auto clamp_y = [this](int64_t v) { return static_cast<size_t>(std::clamp<int64_t>(v, 0, image_.height)); };
+    return {clamp_x(x0), clamp_y(y0), clamp_x(x1), clamp_y(y1)};
+}
+
+void RetainedRenderer::Damage(PixelRect rect) {
+    if (rect.Empty()) {
+        return;
+    }
+    // Поглощаем пересекающиеся прямоугольники, пока новый не станет непересекающимся со всеми
+    for (size_t i = 0; i < damage_.size();) {
+        const PixelRect &other = damage_[i];
+        if (!rect.Overlaps(other)) {
+            ++i;
+            continue;
+        }
+        rect = {std::min(rect.x0, other.x0), std::min(rect.y0, other.y0), std::max(rect.x1, other.x1),
+                std::max(rect.y1, other.y1)};
+        damage_[i] = damage_.back();
+        damage_.pop_back();
+        i = 0;
+    }
+    damage_.push_back(rect);
+}
+
+void RetainedRenderer::Place(size_t id) {
+    const PixelRect &rect = footprints_[id];
+    if (rect.Empty()) {
+        return;
+    }
+    const size_t tile = options_.tile_size;
+    for (size_t ty = rect.y0 / tile; ty <= (rect.y1 - 1) / tile; ++ty) {
+        for (size_t tx = rect.x0 / tile; tx <= (rect.x1 - 1) / tile; ++tx) {
+            tiles_[ty * tiles_x_ + tx].push_back(id);
+        }
+    }
+}
+
+void RetainedRenderer::Unplace(size_t id) {
+    const PixelRect &rect = footprints_[id];
+    if (rect.Empty()) {
+        return;
+    }
+    const size_t tile = options_.tile_size;
+    for (size_t ty = rect.y0 / tile; ty <= (rect.y1 - 1) / tile; ++ty) {
+        for (size_t tx = rect.x0 / tile; tx <= (rect.x1 - 1) / tile; ++tx) {
+            auto &bucket = tiles_[ty * tiles_x_ + tx];
+            const auto it = std::ranges::find(bucket, id);
+            *it = bucket.back();
+            bucket.pop_back();
+        }
+    }
+}
+
+std::vector<size_t> RetainedRenderer::Candidates(const PixelRect &rect) const {
+    std::vector<size_t> ids;
+    const size_t tile = options_.tile_size;
+    for (size_t ty = rect.y0 / tile; ty <= (rect.y1 - 1) / tile; ++ty) {
+        for (size_t tx = rect.x0 / tile; tx <= (rect.x1 - 1) / tile; ++tx) {
+            for (size_t id : tiles_[ty * tiles_x_ + tx]) {
+                if (footprints_[id].Overlaps(rect)) {
+                    ids.push_back(id);
+                }
+            }
+        }
+    }
+    std::ranges::sort(ids);
+    const auto [first, last] = std::ranges::unique(ids);
+    ids.erase(first, last);
+    return ids;
+}
+
+size_t RetainedRenderer::Add(Shape shape) {
+    const size_t id = shapes_.size();
+    footprints_.push_back(ToPixels(queries::GetBoundBox(shape)));
+    shapes_.emplace_back(std::move(shape));
+    Place(id);
+    Damage(footprints_[id]);
+    return id;
+}
+
+void RetainedRenderer::Update(size_t id, Shape shape) {
+    if (id >= shapes_.size()) {
+        throw std::out_of_range("Unknown shape id.");
+    }
+    Damage(footprints_[id]);
+    Unplace(id);
+    footprints_[id] = ToPixels(queries::GetBoundBox(shape));
+    shapes_[id] = std::move(shape);
+    Place(id);
+    Damage(footprints_[id]);
+}
+
+void RetainedRenderer::Remove(size_t id) {
+    if (id >= shapes_.size()) {
+        throw std::out_of_range("Unknown shape id.");
+    }
+    Damage(footprints_[id]);
+    Unplace(id);
+    footprints_[id] = {};
+    shapes_[id].reset();
+}
+
+void RetainedRenderer::Invalidate(const BoundingBox &box) { Damage(ToPixels(box)); }
+
+void RetainedRenderer::InvalidateAll() { Damage({0, 0, image_.width, image_.height}); }
+
+/**
+    @brief Контур фигуры, обрезанный прямоугольником clip
+
+    Отрезок из пиксельной точки a в b проходится steps = max(|dx|, |dy|) равными шагами, и в каждой точке
+    ставится кисть. Положение k-й точки зависит только от концов отрезка, а обрезка лишь сужает диапазон k
+    и отбрасывает пиксели вне clip, поэтому внутри clip результат тот же, что при рисовании целиком.
+*/
+void RetainedRenderer::Rasterize(const Shape &shape, const PixelRect &clip) {
+    const auto &view = options_.view;
+    const double sx = static_cast<double>(image_.width) / view.Width();
+    const double sy = static_cast<double>(image_.height) / view.Height();
+    const auto before = static_cast<int64_t>((options_.line_width - 1) / 2);
+    const auto after = static_cast<int64_t>(options_.line_width / 2);
+    const auto cx0 = static_cast<int64_t>(clip.x0), cx1 = static_cast<int64_t>(clip.x1);
+    const auto cy0 = static_cast<int64_t>(clip.y0), cy1 = static_cast<int64_t>(clip.y1);
+
+    // Пиксельные координаты точек, кисть в которых может задеть clip, с запасом в пиксель
+    const auto reach_x0 = static_cast<double>(cx0 - after - 1), reach_x1 = static_cast<double>(cx1 + before + 1);
+    const auto reach_y0 = static_cast<double>(cy0 - after - 1), reach_y1 = static_cast<double>(cy1 + before + 1);
+
+    auto stamp = [&](double px, double py, Rgb color) {
+        const auto x = static_cast<int64_t>(std::floor(px)), y = static_cast<int64_t>(std::floor(py));
+        for (int64_t yy = std::max(y - before, cy0); yy <= std::min(y + after, cy1 - 1); ++yy) {
+            for (int64_t xx = std::max(x - before, cx0); xx <= std::min(x + after, cx1 - 1); ++xx) {
+                image_.At(static_cast<size_t>(xx), static_cast<size_t>(yy)) = color;
+            }
+        }
+    };
+    // Диапазон параметра t, при котором кисть в точке a + t * d может задеть [lo, hi)
+    auto reach = [](double a, double d, double lo, double hi) -> std::pair<double, double> {
+        if (d == 0.0) {
+            return a >= lo && a < hi ? std::pair{0.0, 1.0} : std::pair{1.0, 0.0};
+        }
+        const double t0 = (lo - a) / d, t1 = (hi - a) / d;
+        return {std::min(t0, t1), std::max(t0, t1)};
+    };
+    auto segment = [&](double ax, double ay, double bx, double by, Rgb color) {
+        const double dx = bx - ax, dy = by - ay;
+        const double steps = std::max(1.0, std::ceil(std::max(std::abs(dx), std::abs(dy))));
+        const auto [tx0, tx1] = reach(ax, dx, reach_x0, reach_x1);
+        const auto [ty0, ty1] = reach(ay, dy, reach_y0, reach_y1);
+        const double k0 = std::max(0.0, std::floor(std::max(tx0, ty0) * steps) - 1.0);
+        const double k1 = std::min(steps, std::ceil(std::min(tx1, ty1) * steps) + 1.0);
+        for (double k = k0; k <= k1; k += 1.0) {
+            stamp(ax + dx * k / steps, ay + dy * k / steps, color);
+        }
+    };
+
+    std::visit(
+        [&](const auto &s) {
+            constexpr Rgb color = ColorOf<std::decay_t<decltype(s)>>();
+            const auto lines = s.Lines();
+            for (size_t i = 1; i < lines.x.size(); ++i) {
+                const double ax = (lines.x[i - 1] - view.min_x) * sx, ay = (view.max_y - lines.y[i - 1]) * sy;
+                const double bx = (lines.x[i] - view.min_x) * sx, by = (view.max_y - lines.y[i]) * sy;
+                // NaN разделяет кольца, такие отрезки не рисуются
+                if (std::isfinite(ax) && std::isfinite(ay) && std::isfinite(bx) && std::isfinite(by)) {
+                    segment(ax, ay, bx, by, color);
+                }
+            }
+        },
+        shape);
+}
+
+RenderStats RetainedRenderer::Render() {
+    struct RegionStats {
+        size_t shapes = 0, pixels = 0;
+    };
+    std::vector<RegionStats> per_region(damage_.size());
+
+    // Прямоугольники не пересекаются, и запись каждого обрезана им самим, поэтому гонок нет
+    parallel::ParallelFor(
+        damage_.size(), 1,
+        [&](size_t begin, size_t end, size_t) {
+            for (size_t r = begin; r < end; ++r) {
+                const PixelRect &rect = damage_[r];
+                for (size_t y = rect.y0; y < rect.y1; ++y) {
+                    std::fill_n(&image_.At(rect.x0, y), rect.x1 - rect.x0, options_.background);
+                }
+                const auto ids = Candidates(rect);
+                for (size_t id : ids) {
+                    Rasterize(*shapes_[id], rect);
+                }
+                per_region[r] = {ids.size(), rect.Area()};
+            }
+        },
+        options_.threads);
+
+    RenderStats stats{.regions = damage_.size()};
+    for (const auto &region : per_region) {
+        stats.shapes += region.shapes;
+        stats.pixels += region.pixels;
+    }
+    damage_.clear();
+    return stats;
+}
+
+}  // namespace geometry::visualization
@@ -0,0 +1,330 @@
+#include "sampling.hpp"
+#include "convex_decomposition.hpp"
+#include "parallel.hpp"
+#include "queries.hpp"
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <optional>
+
+namespace geometry::sampling {
+
+namespace {
+
+constexpr size_t FILL_GRAIN = 4096;
+// Номеров генератора на одну точку: ячейка и монета таблицы, два параметра внутри примитива
+constexpr uint64_t COUNTERS_PER_SAMPLE = 4;
+
+// Ребро кольца, пересекающее полосу; y вершин различны
+struct SlabEdge {
+    Point2D low, high;
+    int direction;  // +1, если кольцо идёт по ребру вверх
+
+    [[nodiscard]] double XAt(double y) const noexcept {
+        return low.x + (y - low.y) * (high.x - low.x) / (high.y - low.y);
+    }
+};
+
+// Пересекаются ли несмежные рёбра кольца. Отсечение ушей такие кольца не распознаёт: у пентаграммы все
+// вершины выпуклые, и уши покрывают её центр, который по правилу чётности лежит снаружи
+bool CrossesItself(std::span<const Point2D> ring) noexcept {
+    auto orientation = [](const Point2D &a, const Point2D &b, const Point2D &c) {
+        const double turn = (b - a).Cross(c - a);
+        return (turn > 0) - (turn < 0);
+    };
+    const size_t n = ring.size();
+    for (size_t i = 0; i < n; ++i) {
+        const Point2D &a = ring[i], &b = ring[(i + 1) % n];
+        for (size_t j = i + 2; j < n; ++j) {
+            if (i == 0 && j == n - 1) {
+                continue;
+            }
+            const Point2D &c = ring[j], &d = ring[(j + 1) % n];
+            if (orientation(a, b, c) * orientation(a, b, d) < 0 && orientation(c, d, a) * orientation(c, d, b) < 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// y точки, в которой рёбра пересекаются внутренними точками обоих, если такая есть
+std::optional<double> CrossingY(const SlabEdge &e, const SlabEdge &f) noexcept {
+    const Point2D r = e.high - e.low, s = f.high - f.low, q = f.low - e.low;
+    const double denominator = r.Cross(s);
+    if (denominator == 0.0) {
+        return std::nullopt;
+    }
+    const double t = q.Cross(s) / denominator, u = q.Cross(r) / denominator;
+    if (t <= 0.0 || t >= 1.0 || u <= 0.0 || u >= 1.0) {
+        return std::nullopt;
+    }
+    return e.low.y + t * r.y;
+}
+
+}  // namespace
+
+AliasTable::AliasTable(std::span<const double> weights) : threshold_(weights.size(), 1.0), alias_(weights.size()) {
+    std::iota(alias_.begin(), alias_.end(), 0u);
+    const double total = std::accumulate(weights.begin(), weights.end(), 0.0,
+                                         [](double sum, double w) { return sum + std::max(w, 0.0); });
+    if (total <= 0.0) {
+        return;
+    }
+
+    const auto n = static_cast<double>(weights.size());
+    std::vector<double> scaled(weights.size());
+    std::vector<uint32_t> small, large;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        scaled[i] = std::max(weights[i], 0.0) * n / total;
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+    while (!small.empty() && !large.empty()) {
+        const uint32_t s = small.back(), l = large.back();
+        small.pop_back();
+        large.pop_back();
+        threshold_[s] = scaled[s];
+        alias_[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        (scaled[l] < 1.0 ? small : large).push_back(l);
+    }
+    // Остатки из-за округления заполняют ячейку целиком
+    for (uint32_t i : small) {
+        threshold_[i] = 1.0;
+    }
+}
+
+ShapeSampler::ShapeSampler(const Shape &shape, Region region) {
+    std::visit([&](const auto &s) { Build(s, region); }, shape);
+    Finish();
+    if (measure_ == 0.0 && region == Region::Interior) {
+        *this = ShapeSampler(shape, Region::Boundary);
+        return;
+    }
+    if (origin_.empty()) {
+        // Пустой многоугольник: единственная возможная точка — его центр
+        const Point2D center = queries::GetBoundBox(shape).Center();
+        transform_ = {};
+        AddSegment(center, center);
+        Finish();
+    }
+}
+
+template <typename T>
+void ShapeSampler::Build(const T &shape, Region region) {
+    const bool interior = region == Region::Interior;
+    if constexpr (std::is_same_v<T, Line>) {
+        kind_ = Kind::Segments;
+        AddSegment(shape.start, shape.end);
+    } else if constexpr (std::is_same_v<T, Circle>) {
+        kind_ = interior ? Kind::Disk : Kind::Circle;
+        origin_.push_back(shape.center_p);
+        first_.push_back({shape.radius, 0});
+        second_.push_back({0, 0});
+        weights_.push_back(1.0);
+    } else if constexpr (std::is_same_v<T, InstancedShape>) {
+        std::visit([&](const auto &prototype) { Build(prototype, region); }, shape.Prototype());
+        transform_ = shape.GetTransform();
+    } else if (!interior) {
+        kind_ = Kind::Segments;
+        if constexpr (std::is_base_of_v<RingSet, T>) {
+            for (size_t r = 0; r < shape.RingCount(); ++r) {
+                AddRingEdges(shape.Ring(r));
+            }
+        } else {
+            const auto vertices = shape.Vertices();
+            AddRingEdges(vertices);
+        }
+    } else if constexpr (std::is_same_v<T, Triangle>) {
+        AddTriangle(shape.a, shape.b, shape.c);
+    } else if constexpr (std::is_same_v<T, Rectangle>) {
+        const auto v = shape.Vertices();
+        AddTriangle(v[0], v[1], v[2]);
+        AddTriangle(v[0], v[2], v[3]);
+    } else if constexpr (std::is_same_v<T, RegularPolygon>) {
+        const auto v = shape.Vertices();
+        for (size_t i = 0, j = v.size() - 1; i < v.size(); j = i++) {
+            AddTriangle(shape.center_p, v[j], v[i]);
+        }
+    } else if constexpr (std::is_same_v<T, Polygon>) {
+        const auto ring = shape.Vertices();
+        if (!CrossesItself(ring)) {
+            if (const auto triangles = decomposition::TriangulateSimplePolygon(ring)) {
+                for (const auto &[a, b, c] : *triangles) {
+                    AddTriangle(ring[a], ring[b], ring[c]);
+                }
+                return;
+            }
+        }
+        const std::span<const Point2D> rings[] = {ring};
+        AddSlabs(rings, FillRule::EvenOdd);
+    } else {
+        std::vector<std::span<const Point2D>> rings;
+        for (size_t r = 0; r < shape.RingCount(); ++r) {
+            rings.push_back(shape.Ring(r));
+        }
+        AddSlabs(rings, FillRule::NonZero);
+    }
+}
+
+void ShapeSampler::AddTriangle(Point2D a, Point2D b, Point2D c) {
+    const double area = std::abs((b - a).Cross(c - a)) / 2;
+    if (area == 0.0) {
+        return;
+    }
+    origin_.push_back(a);
+    first_.push_back(b - a);
+    second_.push_back(c - a);
+    weights_.push_back(area);
+}
+
+void ShapeSampler::AddSegment(Point2D a, Point2D b) {
+    origin_.push_back(a);
+    first_.push_back(b - a);
+    second_.push_back({0, 0});
+    weights_.push_back(a.DistanceTo(b));
+}
+
+void ShapeSampler::AddRingEdges(std::span<const Point2D> ring) {
+    if (ring.size() < 2) {
+        return;
+    }
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        AddSegment(ring[j], ring[i]);
+    }
+}
+
+/**
+    @brief Разбиение колец на трапеции горизонтальными прямыми через все вершины
+
+    Внутри полосы между соседними различными y вершин рёбра не начинаются и не кончаются, поэтому их
+    порядок по x постоянен. Рёбра полосы сортируются по x на её середине, и при проходе слева направо
+    копится число оборотов; промежуток между соседними рёбрами, где это число по правилу rule значит
+    «внутри» (ненулевое или нечётное), — трапеция фигуры, она режется диагональю на два треугольника.
+    Активные рёбра ведутся заметанием снизу вверх. Рёбра самопересекающегося Polygon (правило чётности)
+    пересекаются и между вершинами, поэтому для него полосы режутся ещё и по y точек пересечения рёбер.
+*/
+void ShapeSampler::AddSlabs(std::span<const std::span<const Point2D>> rings, FillRule rule) {
+    std::vector<SlabEdge> edges;
+    std::vector<double> ys;
+    for (const auto &ring : rings) {
+        for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+            ys.push_back(ring[i].y);
+            if (ring[j].y < ring[i].y) {
+                edges.push_back({ring[j], ring[i], 1});
+            } else if (ring[j].y > ring[i].y) {
+                edges.push_back({ring[i], ring[j], -1});
+            }
+        }
+    }
+    if (rule == FillRule::EvenOdd) {
+        for (size_t i = 0; i < edges.size(); ++i) {
+            for (size_t j = i + 1; j < edges.size(); ++j) {
+                if (const auto y = CrossingY(edges[i], edges[j])) {
+                    ys.push_back(*y);
+                }
+            }
+        }
+    }
+    std::ranges::sort(ys);
+    ys.erase(std::ranges::unique(ys).begin(), ys.end());
+    std::ranges::sort(edges, {}, [](const SlabEdge &e) { return e.low.y; });
+
+    std::vector<SlabEdge> active;
+    std::vector<std::pair<double, size_t>> order;
+    size_t next = 0;
+    for (size_t s = 0; s + 1 < ys.size(); ++s) {
+        const double y0 = ys[s], y1 = ys[s + 1], mid = (y0 + y1) / 2;
+        std::erase_if(active, [y0](const SlabEdge &e) { return e.high.y <= y0; });
+        for (; next < edges.size() && edges[next].low.y <= y0; ++next) {
+            active.push_back(edges[next]);
+        }
+
+        order.clear();
+        for (size_t i = 0; i < active.size(); ++i) {
+            order.emplace_back(active[i].XAt(mid), i);
+        }
+        std::ranges::sort(order);
+        int winding = 0;
+        for (size_t k = 0; k + 1 < order.size(); ++k) {
+            const SlabEdge &left = active[order[k].second];
+            winding += left.direction;
+            if (rule == FillRule::NonZero ? winding == 0 : winding % 2 == 0) {
+                continue;
+            }
+            const SlabEdge &right = active[order[k + 1].second];
+            const Point2D l0{left.XAt(y0), y0}, l1{left.XAt(y1), y1};
+            const Point2D r0{right.XAt(y0), y0}, r1{right.XAt(y1), y1};
+            AddTriangle(l0, r0, r1);
+            AddTriangle(l0, r1, l1);
+        }
+    }
+}
+
+void ShapeSampler::Finish() {
+    table_ = AliasTable(weights_);
+    const double total = std::accumulate(weights_.begin(), weights_.end(), 0.0);
+    const double scale = transform_.scale;
+    switch (kind_) {
+    case Kind::Triangles:
+        measure_ = total * scale * scale;
+        break;
+    case Kind::Segments:
+        measure_ = total * scale;
+        break;
+    case Kind::Disk:
+        measure_ = std::numbers::pi * first_[0].x * first_[0].x * scale * scale;
+        break;
+    case Kind::Circle:
+        measure_ = 2 * std::numbers::pi * first_[0].x * scale;
+        break;
+    }
+}
+
+Point2D ShapeSampler::Sample(const CounterRng &rng, uint64_t index) const noexcept {
+    const uint64_t counter = index * COUNTERS_PER_SAMPLE;
+    const size_t i = table_.Sample(rng.Uniform(counter), rng.Uniform(counter + 1));
+    double u = rng.Uniform(counter + 2), v = rng.Uniform(counter + 3);
+
+    Point2D p = origin_[i];
+    switch (kind_) {
+    case Kind::Triangles:
+        // Точка из квадрата, отражённая в нижний треугольник, равномерна в треугольнике
+        if (u + v > 1.0) {
+            u = 1.0 - u;
+            v = 1.0 - v;
+        }
+        p = p + first_[i] * u + second_[i] * v;
+        break;
+    case Kind::Segments:
+        p = p + first_[i] * u;
+        break;
+    case Kind::Disk: {
+        const double r = first_[i].x * std::sqrt(u), angle = 2 * std::numbers::pi * v;
+        p = p + Point2D{r * std::cos(angle), r * std::sin(angle)};
+        break;
+    }
+    case Kind::Circle: {
+        const double angle = 2 * std::numbers::pi * u;
+        p = p + Point2D{first_[i].x * std::cos(angle), first_[i].x * std::sin(angle)};
+        break;
+    }
+    }
+    return transform_.Apply(p);
+}
+
+void ShapeSampler::Fill(const CounterRng &rng, uint64_t first, std::span<double> xs, std::span<double> ys,
+                        size_t threads) const {
+    parallel::ParallelFor(
+        std::min(xs.size(), ys.size()), FILL_GRAIN,
+        [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; ++i) {
+                const Point2D p = Sample(rng, first + i);
+                xs[i] = p.x;
+                ys[i] = p.y;
+            }
+        },
+        threads);
+}
+
+}  // namespace geometry::sampling
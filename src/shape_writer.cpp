@@ -0,0 +1,162 @@
+#include "shape_writer.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <format>
+
+namespace geometry::utils {
+
+namespace {
+
+// Кратчайшая запись double не длиннее 24 символов («-2.2250738585072014e-308»)
+constexpr size_t MAX_NUMBER = 32;
+// Самая длинная запись — «triangle» и шесть чисел с пробелами, с запасом
+constexpr size_t MAX_RECORD = 256;
+constexpr size_t MIN_CHUNK = 1024;
+
+// Пишет в заранее обеспеченный запасом буфер и двигает указатель
+class RecordWriter {
+public:
+    explicit RecordWriter(char *out) noexcept : out_(out) {}
+
+    void Name(std::string_view name) noexcept {
+        std::memcpy(out_, name.data(), name.size());
+        out_ += name.size();
+    }
+    template <typename T>
+    void Number(T value) noexcept {
+        *out_++ = ' ';
+        out_ = std::to_chars(out_, out_ + MAX_NUMBER, value).ptr;
+    }
+    void Point(const Point2D &p) noexcept {
+        Number(p.x);
+        Number(p.y);
+    }
+    void End() noexcept {
+        *out_++ = ';';
+        *out_++ = '\n';
+    }
+    [[nodiscard]] char *Position() const noexcept { return out_; }
+
+private:
+    char *out_;
+};
+
+// Записывает фигуру и возвращает конец записи; фигуры вне формата не передаются
+char *WriteRecord(char *out, const Shape &shape) noexcept {
+    RecordWriter w(out);
+    std::visit(
+        [&w](const auto &s) {
+            using T = std::decay_t<decltype(s)>;
+            if constexpr (std::is_same_v<T, Circle>) {
+                w.Name("circle");
+                w.Point(s.center_p);
+                w.Number(s.radius);
+            } else if constexpr (std::is_same_v<T, Line>) {
+                w.Name("line");
+                w.Point(s.start);
+                w.Point(s.end);
+            } else if constexpr (std::is_same_v<T, Triangle>) {
+                w.Name("triangle");
+                w.Point(s.a);
+                w.Point(s.b);
+                w.Point(s.c);
+            } else if constexpr (std::is_same_v<T, Rectangle>) {
+                w.Name("rectangle");
+                w.Point(s.bottom_left);
+                w.Number(s.width);
+                w.Number(s.height);
+            } else if constexpr (std::is_same_v<T, RegularPolygon>) {
+                w.Name("polygon");
+                w.Point(s.center_p);
+                w.Number(s.radius);
+                w.Number(s.sides);
+            }
+        },
+        shape);
+    w.End();
+    return w.Position();
+}
+
+// Фигура, которую ParseShapes прочтёт обратно: те же проверки, что в MakeCircle, MakeRectangle и MakePolygon,
+// и конечные числа — «nan» и «inf» разбор не должен получать
+bool HasTextForm(const Shape &shape) noexcept {
+    auto finite = [](std::initializer_list<double> values) {
+        return std::ranges::all_of(values, [](double v) { return std::isfinite(v); });
+    };
+    auto positive = [](double v) { return v > 0; };
+    return std::visit(
+        [&](const auto &s) {
+            using T = std::decay_t<decltype(s)>;
+            if constexpr (std::is_same_v<T, Circle>) {
+                return finite({s.center_p.x, s.center_p.y, s.radius}) && positive(s.radius);
+            } else if constexpr (std::is_same_v<T, Line>) {
+                return finite({s.start.x, s.start.y, s.end.x, s.end.y});
+            } else if constexpr (std::is_same_v<T, Triangle>) {
+                return finite({s.a.x, s.a.y, s.b.x, s.b.y, s.c.x, s.c.y});
+            } else if constexpr (std::is_same_v<T, Rectangle>) {
+                return finite({s.bottom_left.x, s.bottom_left.y, s.width, s.height}) && positive(s.width) &&
+                       positive(s.height);
+            } else if constexpr (std::is_same_v<T, RegularPolygon>) {
+                return finite({s.center_p.x, s.center_p.y, s.radius}) && positive(s.radius) && s.sides >= 3;
+            } else {
+                return false;
+            }
+        },
+        shape);
+}
+
+}  // namespace
+
+std::expected<std::string_view, std::string> ShapeWriter::Write(std::span<const Shape> shapes) {
+    if (const auto it = std::ranges::find_if_not(shapes, HasTextForm); it != shapes.end()) {
+        return std::unexpected(std::format("Shape {} has no text form in the ParseShapes format.",
+                                           std::distance(shapes.begin(), it)));
+    }
+
+    const size_t threads = parallel::ResolveThreadCount(threads_);
+    const size_t grain = std::max(MIN_CHUNK, (shapes.size() + 4 * threads - 1) / (4 * threads));
+    const size_t chunk_count = (shapes.size() + grain - 1) / grain;
+    if (chunks_.size() < chunk_count) {
+        chunks_.resize(chunk_count);
+    }
+
+    // Буфер c — фигуры [c * grain, (c + 1) * grain); ParallelFor раздаёт номера буферов, а не фигуры,
+    // поэтому границы блоков не зависят от того, как он делит работу
+    parallel::ParallelFor(
+        chunk_count, 1,
+        [&](size_t first_chunk, size_t last_chunk, size_t) {
+            for (size_t c = first_chunk; c < last_chunk; ++c) {
+                std::string &chunk = chunks_[c];
+                chunk.resize(std::max(chunk.capacity(), MAX_RECORD));
+                size_t used = 0;
+                for (size_t i = c * grain; i < std::min(shapes.size(), (c + 1) * grain); ++i) {
+                    if (chunk.size() - used < MAX_RECORD) {
+                        chunk.resize(std::max(2 * chunk.size(), used + MAX_RECORD));
+                    }
+                    used = static_cast<size_t>(WriteRecord(chunk.data() + used, shapes[i]) - chunk.data());
+                }
+                chunk.resize(used);
+            }
+        },
+        threads);
+
+    std::vector<size_t> offsets(chunk_count + 1, 0);
+    for (size_t c = 0; c < chunk_count; ++c) {
+        offsets[c + 1] = offsets[c] + chunks_[c].size();
+    }
+    buffer_.resize(offsets.back());
+    parallel::ParallelFor(
+        chunk_count, 1,
+        [&](size_t begin, size_t end, size_t) {
+            for (size_t c = begin; c < end; ++c) {
+                std::memcpy(buffer_.data() + offsets[c], chunks_[c].data(), chunks_[c].size());
+            }
+        },
+        threads);
+    return std::string_view(buffer_);
+}
+
+}  // namespace geometry::utils
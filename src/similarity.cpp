@@ -0,0 +1,185 @@
+#include "similarity.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace geometry::similarity {
+
+namespace {
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+double DistanceSq(const Point2D &a, const Point2D &b) noexcept {
+    const Point2D d = a - b;
+    return d.Dot(d);
+}
+
+// Вершины, упорядоченные по x: поиск ближайшей расходится от позиции запроса, пока |dx| меньше найденного
+class SortedByX {
+public:
+    explicit SortedByX(std::span<const Point2D> points) : points_(points.begin(), points.end()) {
+        std::ranges::sort(points_, [](const Point2D &l, const Point2D &r) { return l.x < r.x; });
+    }
+
+    // Квадрат расстояния до ближайшей вершины. Поиск прекращается досрочно, как только нашлась вершина
+    // не дальше stop_sq: для Хаусдорфа такая точка уже не может увеличить текущий максимум
+    [[nodiscard]] double NearestSq(const Point2D &p, double stop_sq) const noexcept {
+        const auto it = std::ranges::lower_bound(points_, p.x, {}, &Point2D::x);
+        size_t right = static_cast<size_t>(it - points_.begin());
+        size_t left = right;
+        double best = INF;
+
+        bool go_right = right < points_.size();
+        bool go_left = left > 0;
+        while (go_right || go_left) {
+            if (go_right) {
+                const double dx = points_[right].x - p.x;
+                if (dx * dx >= best) {
+                    go_right = false;
+                } else {
+                    best = std::min(best, DistanceSq(points_[right], p));
+                    go_right = ++right < points_.size();
+                }
+            }
+            if (go_left) {
+                const double dx = p.x - points_[left - 1].x;
+                if (dx * dx >= best) {
+                    go_left = false;
+                } else {
+                    best = std::min(best, DistanceSq(points_[left - 1], p));
+                    go_left = --left > 0;
+                }
+            }
+            if (best <= stop_sq) {
+                break;
+            }
+        }
+        return best;
+    }
+
+private:
+    std::vector<Point2D> points_;
+};
+
+/**
+    @brief Направленное расстояние Хаусдорфа в квадрате (алгоритм EARLYBREAK)
+
+    Вершины a обходятся в псевдослучайном порядке, чтобы большой максимум находился рано и как можно больше
+    внутренних поисков обрывалось. Как только максимум превышает abandon_sq, результат уже известен.
+*/
+double DirectedHausdorffSq(std::span<const Point2D> a, const SortedByX &b, double cmax_sq, double abandon_sq) {
+    std::vector<size_t> order(a.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::shuffle(order, std::mt19937{a.size()});
+
+    for (size_t i : order) {
+        const double d = b.NearestSq(a[i], cmax_sq);
+        if (d > cmax_sq) {
+            cmax_sq = d;
+            if (cmax_sq > abandon_sq) {
+                break;
+            }
+        }
+    }
+    return cmax_sq;
+}
+
+double HausdorffSq(std::span<const Point2D> a, std::span<const Point2D> b, double abandon_sq) {
+    if (a.empty() || b.empty()) {
+        return INF;
+    }
+    const SortedByX sorted_a(a);
+    const SortedByX sorted_b(b);
+
+    // Максимум первого направления служит стартовой границей второго и отсекает ещё больше поисков
+    const double forward = DirectedHausdorffSq(a, sorted_b, 0.0, abandon_sq);
+    if (forward > abandon_sq) {
+        return forward;
+    }
+    return DirectedHausdorffSq(b, sorted_a, forward, abandon_sq);
+}
+
+/**
+    @brief Дискретное расстояние Фреше в квадрате, динамика по строкам с памятью O(|b|)
+
+    Любая сцепка проходит через каждую строку таблицы, поэтому если минимум строки уже больше abandon_sq,
+    итог тоже больше, и дальше считать не нужно.
+*/
+double FrechetSq(std::span<const Point2D> a, std::span<const Point2D> b, double abandon_sq) {
+    if (a.empty() || b.empty()) {
+        return INF;
+    }
+    // Концы ломаных сопоставляются всегда — дешёвая нижняя оценка
+    const double ends = std::max(DistanceSq(a.front(), b.front()), DistanceSq(a.back(), b.back()));
+    if (ends > abandon_sq) {
+        return ends;
+    }
+
+    const size_t m = b.size();
+    std::vector<double> prev(m), cur(m);
+
+    for (size_t i = 0; i < a.size(); ++i) {
+        double row_min = INF;
+        for (size_t j = 0; j < m; ++j) {
+            const double d = DistanceSq(a[i], b[j]);
+            if (i == 0 && j == 0) {
+                cur[j] = d;
+            } else if (i == 0) {
+                cur[j] = std::max(cur[j - 1], d);
+            } else if (j == 0) {
+                cur[j] = std::max(prev[j], d);
+            } else {
+                cur[j] = std::max(std::min({prev[j], prev[j - 1], cur[j - 1]}), d);
+            }
+            row_min = std::min(row_min, cur[j]);
+        }
+        if (row_min > abandon_sq) {
+            return row_min;
+        }
+        std::swap(prev, cur);
+    }
+    return prev[m - 1];
+}
+
+std::optional<double> WithinThreshold(double distance_sq, double threshold) {
+    const double distance = std::sqrt(distance_sq);
+    return distance <= threshold ? std::make_optional(distance) : std::nullopt;
+}
+
+}  // namespace
+
+double DirectedHausdorff(std::span<const Point2D> a, std::span<const Point2D> b) {
+    if (a.empty() || b.empty()) {
+        return INF;
+    }
+    return std::sqrt(DirectedHausdorffSq(a, SortedByX{b}, 0.0, INF));
+}
+
+double HausdorffDistance(std::span<const Point2D> a, std::span<const Point2D> b) {
+    return std::sqrt(HausdorffSq(a, b, INF));
+}
+
+std::optional<double> HausdorffDistanceWithin(std::span<const Point2D> a, std::span<const Point2D> b,
+                                              double threshold) {
+    if (threshold < 0.0) {
+        return std::nullopt;
+    }
+    return WithinThreshold(HausdorffSq(a, b, threshold * threshold), threshold);
+}
+
+double DiscreteFrechetDistance(std::span<const Point2D> a, std::span<const Point2D> b) {
+    return std::sqrt(FrechetSq(a, b, INF));
+}
+
+std::optional<double> DiscreteFrechetDistanceWithin(std::span<const Point2D> a, std::span<const Point2D> b,
+                                                    double threshold) {
+    if (threshold < 0.0) {
+        return std::nullopt;
+    }
+    return WithinThreshold(FrechetSq(a, b, threshold * threshold), threshold);
+}
+
+}  // namespace geometry::similarity
@@ -0,0 +1,92 @@
+#include "spatial_index.hpp"
+#include <limits>
+#include <numeric>
+
+namespace geometry::index {
+
+namespace {
+
+// Ограничение на число ячеек относительно числа объектов, чтобы пустая сетка не съедала память
+constexpr size_t MAX_CELLS_PER_ITEM = 4;
+
+double ChooseCellSize(std::span<const BoundingBox> boxes, const BoundingBox &bounds) {
+    double mean_extent = 0.0;
+    for (const auto &box : boxes) {
+        mean_extent += std::max(box.Width(), box.Height());
+    }
+    mean_extent /= static_cast<double>(boxes.size());
+
+    // Примерно один объект на ячейку, но не мельче среднего объекта
+    const double area = std::max(bounds.Width(), 1e-12) * std::max(bounds.Height(), 1e-12);
+    const double uniform_cell = std::sqrt(area / static_cast<double>(boxes.size()));
+    return std::max(mean_extent, uniform_cell);
+}
+
+}  // namespace
+
+BoundingBox UnionBox(std::span<const BoundingBox> boxes) {
+    if (boxes.empty()) {
+        return {};
+    }
+    BoundingBox result{std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                       std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+    for (const auto &box : boxes) {
+        result.min_x = std::min(result.min_x, box.min_x);
+        result.min_y = std::min(result.min_y, box.min_y);
+        result.max_x = std::max(result.max_x, box.max_x);
+        result.max_y = std::max(result.max_y, box.max_y);
+    }
+    return result;
+}
+
+GridIndex::GridIndex(std::span<const BoundingBox> boxes, double cell_size) : boxes_(boxes.begin(), boxes.end()) {
+    if (boxes_.empty()) {
+        offsets_.assign(2, 0);
+        return;
+    }
+
+    bounds_ = UnionBox(boxes_);
+    cell_size_ = cell_size > 0.0 ? cell_size : ChooseCellSize(boxes_, bounds_);
+
+    // Укрупняем ячейки, пока их не станет разумно мало
+    const size_t max_cells = std::max<size_t>(1, MAX_CELLS_PER_ITEM * boxes_.size());
+    for (;;) {
+        nx_ = static_cast<size_t>(bounds_.Width() / cell_size_) + 1;
+        ny_ = static_cast<size_t>(bounds_.Height() / cell_size_) + 1;
+        if (nx_ * ny_ <= max_cells) {
+            break;
+        }
+        cell_size_ *= 2.0;
+    }
+
+    // Первый проход — подсчёт, второй — раскладка индексов по ячейкам
+    offsets_.assign(nx_ * ny_ + 1, 0);
+    for (const auto &box : boxes_) {
+        const auto [x0, y0, x1, y1] = CellRange(box);
+        for (size_t cy = y0; cy <= y1; ++cy) {
+            for (size_t cx = x0; cx <= x1; ++cx) {
+                ++offsets_[cy * nx_ + cx + 1];
+            }
+        }
+    }
+    std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+
+    items_.resize(offsets_.back());
+    std::vector<size_t> cursor(offsets_.begin(), offsets_.end() - 1);
+    for (size_t i = 0; i < boxes_.size(); ++i) {
+        const auto [x0, y0, x1, y1] = CellRange(boxes_[i]);
+        for (size_t cy = y0; cy <= y1; ++cy) {
+            for (size_t cx = x0; cx <= x1; ++cx) {
+                items_[cursor[cy * nx_ + cx]++] = i;
+            }
+        }
+    }
+}
+
+std::vector<size_t> GridIndex::Query(const BoundingBox &box) const {
+    std::vector<size_t> result;
+    Query(box, [&result](size_t i) { result.push_back(i); });
+    return result;
+}
+
+}  // namespace geometry::index
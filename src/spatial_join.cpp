@@ -0,0 +1,312 @@
+#include "spatial_join.hpp"
+#include "parallel.hpp"
+#include "queries.hpp"
+#include "spatial_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <numeric>
+
+namespace geometry::join {
+
+namespace {
+
+// Во сколько раз один набор должен быть больше другого, чтобы индекс по меньшему окупался
+constexpr size_t INDEX_NESTED_LOOP_RATIO = 8;
+// Ниже этого размера строить разбиение дороже, чем пройтись по индексу
+constexpr size_t SMALL_INPUT = 256;
+constexpr size_t PROBE_GRAIN = 512;
+// Целевое число объектов обоих наборов в одной ячейке разбиения
+constexpr size_t ITEMS_PER_TILE = 256;
+
+struct Entry {
+    BoundingBox box;
+    size_t index;
+};
+
+std::vector<BoundingBox> CollectBoxes(std::span<const Shape> shapes) {
+    std::vector<BoundingBox> boxes;
+    boxes.reserve(shapes.size());
+    for (const auto &shape : shapes) {
+        boxes.push_back(queries::GetBoundBox(shape));
+    }
+    return boxes;
+}
+
+std::vector<IndexPair> MergeSorted(std::vector<std::vector<IndexPair>> &per_worker) {
+    size_t total = 0;
+    for (const auto &part : per_worker) {
+        total += part.size();
+    }
+
+    std::vector<IndexPair> result;
+    result.reserve(total);
+    for (auto &part : per_worker) {
+        result.insert(result.end(), part.begin(), part.end());
+    }
+    std::ranges::sort(result);
+    return result;
+}
+
+std::vector<IndexPair> IndexNestedLoopJoin(std::span<const Shape> a, std::span<const Shape> b,
+                                           const std::vector<BoundingBox> &a_boxes,
+                                           const std::vector<BoundingBox> &b_boxes, const JoinOptions &options) {
+    // Индексируем меньший набор: он лучше помещается в кеш, а обход большего хорошо распараллеливается
+    const bool index_a = a.size() <= b.size();
+    const index::GridIndex grid(index_a ? a_boxes : b_boxes);
+    const auto &probe_boxes = index_a ? b_boxes : a_boxes;
+
+    const size_t threads = parallel::ResolveThreadCount(options.threads);
+    std::vector<std::vector<IndexPair>> per_worker(threads);
+
+    parallel::ParallelFor(
+        probe_boxes.size(), PROBE_GRAIN,
+        [&](size_t begin, size_t end, size_t worker) {
+            auto &out = per_worker[worker];
+            for (size_t k = begin; k < end; ++k) {
+                grid.Query(probe_boxes[k], [&](size_t hit) {
+                    const IndexPair pair = index_a ? IndexPair{hit, k} : IndexPair{k, hit};
+                    if (!options.exact || queries::ShapesIntersect(a[pair.first], b[pair.second])) {
+                        out.push_back(pair);
+                    }
+                });
+            }
+        },
+        threads);
+
+    return MergeSorted(per_worker);
+}
+
+std::vector<IndexPair> PartitionJoin(std::span<const Shape> a, std::span<const Shape> b,
+                                     const std::vector<BoundingBox> &a_boxes, const std::vector<BoundingBox> &b_boxes,
+                                     const JoinOptions &options) {
+    const BoundingBox a_bounds = index::UnionBox(a_boxes);
+    const BoundingBox b_bounds = index::UnionBox(b_boxes);
+    if (!a_bounds.Overlaps(b_bounds)) {
+        return {};
+    }
+    // Пары могут лежать только в пересечении габаритов наборов
+    const BoundingBox bounds{std::max(a_bounds.min_x, b_bounds.min_x), std::max(a_bounds.min_y, b_bounds.min_y),
+                             std::min(a_bounds.max_x, b_bounds.max_x), std::min(a_bounds.max_y, b_bounds.max_y)};
+
+    const size_t tiles_wanted = std::max<size_t>(1, (a.size() + b.size()) / ITEMS_PER_TILE);
+    const double side = std::max(bounds.Width(), bounds.Height());
+    const double tile_size = std::max(side / std::ceil(std::sqrt(static_cast<double>(tiles_wanted))), 1e-12);
+    const size_t nx = static_cast<size_t>(bounds.Width() / tile_size) + 1;
+    const size_t ny = static_cast<size_t>(bounds.Height() / tile_size) + 1;
+
+    auto tile_x = [&](double x) {
+        return static_cast<size_t>(std::clamp(std::floor((x - bounds.min_x) / tile_size), 0.0, double(nx - 1)));
+    };
+    auto tile_y = [&](double y) {
+        return static_cast<size_t>(std::clamp(std::floor((y - bounds.min_y) / tile_size), 0.0, double(ny - 1)));
+    };
+
+    std::vector<std::vector<Entry>> a_tiles(nx * ny);
+    std::vector<std::vector<Entry>> b_tiles(nx * ny);
+    auto distribute = [&](const std::vector<BoundingBox> &boxes, std::vector<std::vector<Entry>> &tiles) {
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (!boxes[i].Overlaps(bounds)) {
+                continue;
+            }
+            for (size_t ty = tile_y(boxes[i].min_y); ty <= tile_y(boxes[i].max_y); ++ty) {
+                for (size_t tx = tile_x(boxes[i].min_x); tx <= tile_x(boxes[i].max_x); ++tx) {
+                    tiles[ty * nx + tx].push_back({boxes[i], i});
+                }
+            }
+        }
+    };
+    distribute(a_boxes, a_tiles);
+    distribute(b_boxes, b_tiles);
+
+    const size_t threads = parallel::ResolveThreadCount(options.threads);
+    std::vector<std::vector<IndexPair>> per_worker(threads);
+
+    parallel::ParallelFor(
+        nx * ny, 1,
+        [&](size_t begin, size_t end, size_t worker) {
+            auto &out = per_worker[worker];
+            for (size_t tile = begin; tile < end; ++tile) {
+                auto &ta = a_tiles[tile];
+                auto &tb = b_tiles[tile];
+                if (ta.empty() || tb.empty()) {
+                    continue;
+                }
+
+                auto by_min_x = [](const Entry &l, const Entry &r) { return l.box.min_x < r.box.min_x; };
+                std::ranges::sort(ta, by_min_x);
+                std::ranges::sort(tb, by_min_x);
+
+                auto report = [&](const Entry &ea, const Entry &eb) {
+                    if (ea.box.max_y < eb.box.min_y || eb.box.max_y < ea.box.min_y) {
+                        return;
+                    }
+                    // Пара, попавшая в несколько ячеек, учитывается только в ячейке своего опорного угла
+                    const size_t ref_x = tile_x(std::max(ea.box.min_x, eb.box.min_x));
+                    const size_t ref_y = tile_y(std::max(ea.box.min_y, eb.box.min_y));
+                    if (ref_y * nx + ref_x != tile) {
+                        return;
+                    }
+                    if (!options.exact || queries::ShapesIntersect(a[ea.index], b[eb.index])) {
+                        out.emplace_back(ea.index, eb.index);
+                    }
+                };
+
+                // Плоское заметание по x
+                size_t i = 0, j = 0;
+                while (i < ta.size() && j < tb.size()) {
+                    if (ta[i].box.min_x <= tb[j].box.min_x) {
+                        for (size_t k = j; k < tb.size() && tb[k].box.min_x <= ta[i].box.max_x; ++k) {
+                            report(ta[i], tb[k]);
+                        }
+                        ++i;
+                    } else {
+                        for (size_t k = i; k < ta.size() && ta[k].box.min_x <= tb[j].box.max_x; ++k) {
+                            report(ta[k], tb[j]);
+                        }
+                        ++j;
+                    }
+                }
+            }
+        },
+        threads);
+
+    return MergeSorted(per_worker);
+}
+
+}  // namespace
+
+/**
+    @brief Соединение по расстоянию
+
+    Набор b индексируется сеткой, набор a разбивается на ячейки сетки по центрам фигур, и каждая ячейка
+    обрабатывается отдельной задачей — соседние запросы к индексу идут из одной области и переиспользуют кеш.
+    Кандидаты отбираются по bounding box, расширенному на distance, затем по евклидову расстоянию между
+    прямоугольниками и в конце по точному расстоянию между фигурами.
+*/
+void DistanceJoin(std::span<const Shape> a, std::span<const Shape> b, double distance, const PairSink &sink,
+                  const DistanceJoinOptions &options) {
+    if (a.empty() || b.empty() || distance < 0.0) {
+        return;
+    }
+
+    const auto a_boxes = CollectBoxes(a);
+    const auto b_boxes = CollectBoxes(b);
+    const index::GridIndex grid(b_boxes);
+
+    // Группируем a по ячейкам с шагом индекса: упорядочиваем индексы по номеру ячейки центра
+    const BoundingBox a_bounds = index::UnionBox(a_boxes);
+    const double tile_size = std::max(grid.CellSize(), distance);
+    const size_t nx = static_cast<size_t>(a_bounds.Width() / tile_size) + 1;
+    auto tile_of = [&](const BoundingBox &box) {
+        const Point2D c = box.Center();
+        const auto tx = static_cast<size_t>((c.x - a_bounds.min_x) / tile_size);
+        const auto ty = static_cast<size_t>((c.y - a_bounds.min_y) / tile_size);
+        return ty * nx + tx;
+    };
+
+    std::vector<size_t> tiles(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        tiles[i] = tile_of(a_boxes[i]);
+    }
+    std::vector<size_t> order(a.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, [&tiles](size_t l, size_t r) { return tiles[l] < tiles[r]; });
+
+    // Границы непустых ячеек в order
+    std::vector<size_t> tile_starts;
+    for (size_t k = 0; k < order.size(); ++k) {
+        if (k == 0 || tiles[order[k]] != tiles[order[k - 1]]) {
+            tile_starts.push_back(k);
+        }
+    }
+    tile_starts.push_back(order.size());
+
+    std::mutex sink_mutex;
+    const size_t batch_size = std::max<size_t>(options.batch_size, 1);
+    auto flush = [&](std::vector<IndexPair> &batch) {
+        if (batch.empty()) {
+            return;
+        }
+        std::scoped_lock lock(sink_mutex);
+        sink(batch);
+        batch.clear();
+    };
+
+    const size_t threads = parallel::ResolveThreadCount(options.threads);
+    std::vector<std::vector<IndexPair>> per_worker(threads);
+
+    parallel::ParallelFor(
+        tile_starts.size() - 1, 1,
+        [&](size_t begin, size_t end, size_t worker) {
+            auto &batch = per_worker[worker];
+            for (size_t k = tile_starts[begin]; k < tile_starts[end]; ++k) {
+                const size_t i = order[k];
+                const BoundingBox &box = a_boxes[i];
+                const BoundingBox expanded{box.min_x - distance, box.min_y - distance, box.max_x + distance,
+                                           box.max_y + distance};
+
+                grid.Query(expanded, [&](size_t j) {
+                    if (queries::BoundingBoxDistance(box, b_boxes[j]) > distance ||
+                        queries::ExactDistanceBetweenShapes(a[i], b[j]) > distance) {
+                        return;
+                    }
+                    batch.emplace_back(i, j);
+                    if (batch.size() >= batch_size) {
+                        flush(batch);
+                    }
+                });
+            }
+        },
+        threads);
+
+    for (auto &batch : per_worker) {
+        flush(batch);
+    }
+}
+
+std::vector<IndexPair> DistanceJoin(std::span<const Shape> a, std::span<const Shape> b, double distance,
+                                    const DistanceJoinOptions &options) {
+    std::vector<IndexPair> result;
+    auto collect = [&result](std::span<const IndexPair> batch) {
+        result.insert(result.end(), batch.begin(), batch.end());
+    };
+    DistanceJoin(a, b, distance, collect, options);
+    std::ranges::sort(result);
+    return result;
+}
+
+JoinStrategy ChooseJoinStrategy(size_t a_size, size_t b_size) noexcept {
+    const size_t smaller = std::min(a_size, b_size);
+    const size_t larger = std::max(a_size, b_size);
+    if (larger < SMALL_INPUT || smaller * INDEX_NESTED_LOOP_RATIO <= larger) {
+        return JoinStrategy::IndexNestedLoop;
+    }
+    return JoinStrategy::Partition;
+}
+
+/**
+    @brief Пространственное соединение двух наборов фигур
+
+    Кандидаты отбираются по bounding box, при options.exact дополнительно проверяется точное пересечение.
+*/
+std::vector<IndexPair> SpatialJoin(std::span<const Shape> a, std::span<const Shape> b, const JoinOptions &options) {
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+
+    const auto a_boxes = CollectBoxes(a);
+    const auto b_boxes = CollectBoxes(b);
+
+    auto strategy = options.strategy;
+    if (strategy == JoinStrategy::Auto) {
+        strategy = ChooseJoinStrategy(a.size(), b.size());
+    }
+
+    if (strategy == JoinStrategy::IndexNestedLoop) {
+        return IndexNestedLoopJoin(a, b, a_boxes, b_boxes, options);
+    }
+    return PartitionJoin(a, b, a_boxes, b_boxes, options);
+}
+
+}  // namespace geometry::join
@@ -0,0 +1,462 @@
+#include "tile_pyramid.hpp"
+#include "clipping.hpp"
+#include "parallel.hpp"
+#include "queries.hpp"
+#include "spatial_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <set>
+#include <tuple>
+
+namespace geometry::tiles {
+
+namespace {
+
+constexpr size_t SHAPE_GRAIN = 16;
+constexpr size_t MIN_CIRCLE_SEGMENTS = 8;
+constexpr size_t MAX_CIRCLE_SEGMENTS = 1024;
+constexpr uint32_t MAX_ZOOM = 30;
+
+// Контур фигуры в мировых координатах: замкнутые кольца или открытые ломаные
+struct Outline {
+    bool closed = true;
+    std::vector<std::vector<Point2D>> parts;
+};
+
+template <typename T>
+void AppendOutline(const T &s, double tolerance, Outline &out) {
+    if constexpr (std::is_same_v<T, Line>) {
+        out.closed = false;
+        out.parts.push_back({s.start, s.end});
+    } else if constexpr (std::is_same_v<T, Circle>) {
+        // Число сторон, при котором хорда отходит от дуги не дальше допуска
+        size_t segments = MIN_CIRCLE_SEGMENTS;
+        if (tolerance < s.radius) {
+            const double steps = std::ceil(std::numbers::pi / std::acos(1.0 - tolerance / s.radius));
+            segments = std::clamp(static_cast<size_t>(steps), MIN_CIRCLE_SEGMENTS, MAX_CIRCLE_SEGMENTS);
+        }
+        out.parts.push_back(s.Vertices(segments));
+    } else if constexpr (std::is_base_of_v<RingSet, T>) {
+        for (size_t r = 0; r < s.RingCount(); ++r) {
+            out.parts.emplace_back(s.Ring(r).begin(), s.Ring(r).end());
+        }
+    } else if constexpr (std::is_same_v<T, InstancedShape>) {
+        std::visit([&](const auto &image) { AppendOutline(image, tolerance, out); },
+                   Transformed(s.Prototype(), s.GetTransform()));
+    } else {
+        const auto vertices = s.Vertices();
+        out.parts.emplace_back(vertices.begin(), vertices.end());
+    }
+}
+
+double SegmentDistance(const Point2D &p, const Point2D &a, const Point2D &b) {
+    const Point2D ab = b - a;
+    const double length2 = ab.Dot(ab);
+    const double t = length2 > 0.0 ? std::clamp((p - a).Dot(ab) / length2, 0.0, 1.0) : 0.0;
+    return p.DistanceTo(a + ab * t);
+}
+
+// Дуглас–Пекер по отрезку [first, last] ломаной; keep отмечает оставленные вершины
+void DouglasPeucker(std::span<const Point2D> points, size_t first, size_t last, double tolerance,
+                    std::vector<bool> &keep) {
+    std::vector<std::pair<size_t, size_t>> stack{{first, last}};
+    while (!stack.empty()) {
+        const auto [a, b] = stack.back();
+        stack.pop_back();
+        double farthest = tolerance;
+        size_t split = a;
+        for (size_t i = a + 1; i < b; ++i) {
+            const double d = SegmentDistance(points[i], points[a], points[b % points.size()]);
+            if (d > farthest) {
+                farthest = d;
+                split = i;
+            }
+        }
+        if (split != a) {
+            keep[split] = true;
+            stack.emplace_back(a, split);
+            stack.emplace_back(split, b);
+        }
+    }
+}
+
+/**
+    @brief Упрощение ломаной или кольца с допуском tolerance
+
+    Кольцо разрезается в вершине 0 и в самой далёкой от неё вершине, и обе половины упрощаются
+    независимо, так что обе опорные вершины сохраняются.
+*/
+std::vector<Point2D> Simplify(std::span<const Point2D> points, double tolerance, bool closed) {
+    if (points.size() <= (closed ? 3u : 2u)) {
+        return {points.begin(), points.end()};
+    }
+    std::vector<bool> keep(points.size(), false);
+    keep[0] = true;
+    if (closed) {
+        size_t far = 1;
+        for (size_t i = 2; i < points.size(); ++i) {
+            if (points[i].DistanceTo(points[0]) > points[far].DistanceTo(points[0])) {
+                far = i;
+            }
+        }
+        keep[far] = true;
+        DouglasPeucker(points, 0, far, tolerance, keep);
+        // Индекс points.size() обозначает вершину 0, замыкающую кольцо
+        DouglasPeucker(points, far, points.size(), tolerance, keep);
+    } else {
+        keep.back() = true;
+        DouglasPeucker(points, 0, points.size() - 1, tolerance, keep);
+    }
+    std::vector<Point2D> result;
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (keep[i]) {
+            result.push_back(points[i]);
+        }
+    }
+    return result;
+}
+
+void PutVarint(std::vector<uint8_t> &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t ZigZag(int64_t v) noexcept { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+int64_t UnZigZag(uint64_t v) noexcept { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+using GridPoint = std::pair<int64_t, int64_t>;
+
+/**
+    @brief Фигура в тайле: обрезка окном тайла с запасом и перевод в целочисленную решётку
+
+    Повторяющиеся после округления точки схлопываются; кольца, выродившиеся меньше чем в три точки,
+    и ломаные короче двух точек отбрасываются. Пустой результат — фигура в тайл ничего не вносит.
+*/
+std::vector<uint8_t> EncodeFeature(size_t id, const Outline &outline, const BoundingBox &tile, double unit,
+                                   const BoundingBox &window) {
+    auto quantize = [&](const Point2D &p) -> GridPoint {
+        return {std::llround((p.x - tile.min_x) / unit), std::llround((p.y - tile.min_y) / unit)};
+    };
+    auto append = [](std::vector<GridPoint> &part, const GridPoint &q) {
+        if (part.empty() || part.back() != q) {
+            part.push_back(q);
+        }
+    };
+
+    std::vector<std::vector<GridPoint>> parts;
+    for (const auto &source : outline.parts) {
+        if (outline.closed) {
+            std::vector<GridPoint> ring;
+            for (const auto &p : clipping::ClipRing(source, window)) {
+                append(ring, quantize(p));
+            }
+            while (ring.size() > 1 && ring.front() == ring.back()) {
+                ring.pop_back();
+            }
+            if (ring.size() >= 3) {
+                parts.push_back(std::move(ring));
+            }
+            continue;
+        }
+        // Ломаная обрезается по отрезкам; разрыв там, где соседние обрезанные отрезки не стыкуются
+        std::vector<GridPoint> current;
+        for (size_t i = 0; i + 1 < source.size(); ++i) {
+            const auto clipped = clipping::ClipLine(Line{source[i], source[i + 1]}, window);
+            if (!clipped) {
+                continue;
+            }
+            const GridPoint start = quantize(clipped->start);
+            if (!current.empty() && current.back() != start) {
+                if (current.size() >= 2) {
+                    parts.push_back(std::move(current));
+                }
+                current.clear();
+            }
+            append(current, start);
+            append(current, quantize(clipped->end));
+        }
+        if (current.size() >= 2) {
+            parts.push_back(std::move(current));
+        }
+    }
+    if (parts.empty()) {
+        return {};
+    }
+
+    std::vector<uint8_t> bytes;
+    PutVarint(bytes, id);
+    bytes.push_back(outline.closed ? 1 : 0);
+    PutVarint(bytes, parts.size());
+    GridPoint cursor{0, 0};
+    for (const auto &part : parts) {
+        PutVarint(bytes, part.size());
+        for (const auto &q : part) {
+            PutVarint(bytes, ZigZag(q.first - cursor.first));
+            PutVarint(bytes, ZigZag(q.second - cursor.second));
+            cursor = q;
+        }
+    }
+    return bytes;
+}
+
+}  // namespace
+
+TilePyramid::TilePyramid(const BoundingBox &world, const PyramidOptions &options) : options_(options) {
+    const double side = std::max({world.Width(), world.Height(), 1e-12});
+    world_ = {world.min_x, world.min_y, world.min_x + side, world.min_y + side};
+    options_.max_zoom = std::min(options_.max_zoom, MAX_ZOOM);
+    options_.extent = std::max<uint32_t>(options_.extent, 1);
+}
+
+double TilePyramid::TileSize(uint32_t zoom) const noexcept {
+    return world_.Width() / static_cast<double>(uint64_t{1} << zoom);
+}
+
+BoundingBox TilePyramid::TileBounds(const TileKey &key) const noexcept {
+    const double size = TileSize(key.zoom);
+    const double x = world_.min_x + size * key.x, y = world_.min_y + size * key.y;
+    return {x, y, x + size, y + size};
+}
+
+TilePyramid::TileRange TilePyramid::RangeOf(const BoundingBox &box, uint32_t zoom) const noexcept {
+    const double size = TileSize(zoom);
+    const double pad = size * options_.buffer / options_.extent;
+    const BoundingBox padded{box.min_x - pad, box.min_y - pad, box.max_x + pad, box.max_y + pad};
+    if (!padded.Overlaps(world_)) {
+        return {};
+    }
+    const double last = static_cast<double>((uint64_t{1} << zoom) - 1);
+    auto tile = [&](double v, double origin) {
+        return static_cast<uint32_t>(std::clamp(std::floor((v - origin) / size), 0.0, last));
+    };
+    return {tile(padded.min_x, world_.min_x), tile(padded.min_y, world_.min_y), tile(padded.max_x, world_.min_x),
+            tile(padded.max_y, world_.min_y)};
+}
+
+std::span<const uint8_t> TilePyramid::Tile(const TileKey &key) const {
+    const auto it = tiles_.find(key);
+    return it == tiles_.end() ? std::span<const uint8_t>{} : std::span<const uint8_t>(it->second);
+}
+
+/**
+    @brief Перегенерация тайлов одного уровня
+
+    Каждая фигура упрощается один раз на уровень и обрезается по всем своим грязным тайлам; куски
+    копятся в буферах потоков, затем группируются по тайлам в порядке индексов фигур, чтобы блок
+    не зависел от расписания потоков.
+*/
+template <typename Dirty>
+void TilePyramid::Regenerate(std::span<const Shape> shapes, uint32_t zoom, std::span<const size_t> candidates,
+                             Dirty dirty) {
+    struct Piece {
+        TileKey key;
+        size_t id;
+        std::vector<uint8_t> bytes;
+    };
+    const double unit = TileSize(zoom) / options_.extent;
+    const double pad = unit * options_.buffer;
+    const size_t threads = parallel::ResolveThreadCount(options_.threads);
+    std::vector<std::vector<Piece>> per_worker(threads);
+
+    parallel::ParallelFor(
+        candidates.size(), SHAPE_GRAIN,
+        [&](size_t begin, size_t end, size_t worker) {
+            for (size_t k = begin; k < end; ++k) {
+                const size_t id = candidates[k];
+                const TileRange range = RangeOf(boxes_[id], zoom);
+                if (range.x1 < range.x0) {
+                    continue;
+                }
+                Outline outline;
+                std::visit([&](const auto &s) { AppendOutline(s, unit, outline); }, shapes[id]);
+                for (auto &part : outline.parts) {
+                    part = Simplify(part, unit, outline.closed);
+                }
+
+                for (uint32_t y = range.y0; y <= range.y1; ++y) {
+                    for (uint32_t x = range.x0; x <= range.x1; ++x) {
+                        if (!dirty(x, y)) {
+                            continue;
+                        }
+                        const TileKey key{zoom, x, y};
+                        const BoundingBox tile = TileBounds(key);
+                        const BoundingBox window{tile.min_x - pad, tile.min_y - pad, tile.max_x + pad,
+                                                 tile.max_y + pad};
+                        auto bytes = EncodeFeature(id, outline, tile, unit, window);
+                        if (!bytes.empty()) {
+                            per_worker[worker].push_back({key, id, std::move(bytes)});
+                        }
+                    }
+                }
+            }
+        },
+        threads);
+
+    std::vector<Piece> pieces;
+    for (auto &part : per_worker) {
+        std::ranges::move(part, std::back_inserter(pieces));
+    }
+    std::ranges::sort(pieces,
+                      [](const Piece &a, const Piece &b) { return std::tie(a.key, a.id) < std::tie(b.key, b.id); });
+
+    for (size_t first = 0; first < pieces.size();) {
+        size_t last = first;
+        while (last < pieces.size() && pieces[last].key == pieces[first].key) {
+            ++last;
+        }
+        std::vector<uint8_t> blob;
+        PutVarint(blob, last - first);
+        for (size_t k = first; k < last; ++k) {
+            blob.insert(blob.end(), pieces[k].bytes.begin(), pieces[k].bytes.end());
+        }
+        tiles_[pieces[first].key] = std::move(blob);
+        first = last;
+    }
+}
+
+void TilePyramid::Build(std::span<const Shape> shapes) {
+    tiles_.clear();
+    boxes_.clear();
+    for (const auto &shape : shapes) {
+        boxes_.push_back(queries::GetBoundBox(shape));
+    }
+    std::vector<size_t> all(shapes.size());
+    std::iota(all.begin(), all.end(), 0);
+    for (uint32_t zoom = 0; zoom <= options_.max_zoom; ++zoom) {
+        Regenerate(shapes, zoom, all, [](uint32_t, uint32_t) { return true; });
+    }
+}
+
+/**
+    @brief Инкрементальное обновление после изменения части фигур
+
+    Грязные тайлы уровня — задетые прежним или новым bounding box изменённой фигуры. Они собираются
+    заново из всех фигур, которые их касаются (их находит сетка по bounding box), остальные тайлы
+    не трогаются.
+*/
+size_t TilePyramid::Update(std::span<const Shape> shapes, std::span<const size_t> changed) {
+    if (shapes.size() != boxes_.size()) {
+        Build(shapes);
+        return tiles_.size();
+    }
+
+    std::vector<BoundingBox> old_boxes;
+    std::vector<size_t> moved;
+    for (size_t i : changed) {
+        if (i < shapes.size()) {
+            moved.push_back(i);
+            old_boxes.push_back(boxes_[i]);
+            boxes_[i] = queries::GetBoundBox(shapes[i]);
+        }
+    }
+    if (moved.empty()) {
+        return 0;
+    }
+    const index::GridIndex grid(boxes_);
+
+    size_t regenerated = 0;
+    for (uint32_t zoom = 0; zoom <= options_.max_zoom; ++zoom) {
+        std::set<std::pair<uint32_t, uint32_t>> dirty;
+        auto mark = [&](const BoundingBox &box) {
+            const TileRange range = RangeOf(box, zoom);
+            for (uint32_t y = range.y0; y <= range.y1 && range.x0 <= range.x1; ++y) {
+                for (uint32_t x = range.x0; x <= range.x1; ++x) {
+                    dirty.emplace(x, y);
+                }
+            }
+        };
+        for (size_t k = 0; k < moved.size(); ++k) {
+            mark(old_boxes[k]);
+            mark(boxes_[moved[k]]);
+        }
+
+        // Кандидаты с избытком: окно запроса чуть шире запаса тайла, точный отбор делает RangeOf
+        const double pad = TileSize(zoom) * (static_cast<double>(options_.buffer) / options_.extent + 1e-9);
+        std::vector<size_t> candidates;
+        for (const auto &[x, y] : dirty) {
+            const BoundingBox tile = TileBounds({zoom, x, y});
+            grid.Query({tile.min_x - pad, tile.min_y - pad, tile.max_x + pad, tile.max_y + pad},
+                       [&candidates](size_t i) { candidates.push_back(i); });
+            tiles_.erase({zoom, x, y});
+        }
+        std::ranges::sort(candidates);
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        Regenerate(shapes, zoom, candidates, [&dirty](uint32_t x, uint32_t y) { return dirty.contains({x, y}); });
+        regenerated += dirty.size();
+    }
+    return regenerated;
+}
+
+/**
+    @brief Разбор блока тайла
+
+    Формат: varint число фигур; для каждой — varint индекс, байт 1/0 (кольца или ломаные), varint число
+    частей, для каждой части varint число точек и пары zigzag-varint разностей от предыдущей точки
+    (первая точка фигуры — от начала решётки).
+*/
+std::expected<std::vector<TileFeature>, std::string> DecodeTile(std::span<const uint8_t> blob) {
+    size_t pos = 0;
+    bool truncated = false;
+    auto varint = [&]() -> uint64_t {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (pos >= blob.size()) {
+                truncated = true;
+                return 0;
+            }
+            const uint8_t byte = blob[pos++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        truncated = true;
+        return 0;
+    };
+
+    std::vector<TileFeature> features;
+    if (blob.empty()) {
+        return features;
+    }
+    const uint64_t count = varint();
+    for (uint64_t f = 0; f < count && !truncated; ++f) {
+        TileFeature feature;
+        feature.id = varint();
+        if (pos >= blob.size()) {
+            truncated = true;
+            break;
+        }
+        feature.closed = blob[pos++] != 0;
+        const uint64_t parts = varint();
+        GridPoint cursor{0, 0};
+        for (uint64_t p = 0; p < parts && !truncated; ++p) {
+            const uint64_t points = varint();
+            if (points > blob.size() - pos) {
+                truncated = true;
+                break;
+            }
+            auto &ring = feature.rings.emplace_back();
+            for (uint64_t k = 0; k < points && !truncated; ++k) {
+                cursor.first += UnZigZag(varint());
+                cursor.second += UnZigZag(varint());
+                ring.emplace_back(static_cast<double>(cursor.first), static_cast<double>(cursor.second));
+            }
+        }
+        features.push_back(std::move(feature));
+    }
+    if (truncated) {
+        return std::unexpected("Truncated tile blob.");
+    }
+    if (pos != blob.size()) {
+        return std::unexpected("Trailing bytes in tile blob.");
+    }
+    return features;
+}
+
+}  // namespace geometry::tiles
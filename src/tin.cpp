@@ -0,0 +1,225 @@
+#include "tin.hpp"
+#include "parallel.hpp"
+#include "point_set.hpp"
+#include "triangulation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+namespace geometry::triangulation {
+
+namespace {
+
+constexpr size_t INTERPOLATION_GRAIN = 1024;
+// Доля размера треугольника, на которую точка сдвигается с ребра, где координаты Сибсона вырождаются
+constexpr double NUDGE = 1e-7;
+
+double SignedArea(const Point2D &a, const Point2D &b, const Point2D &c) noexcept { return (b - a).Cross(c - a) / 2; }
+
+// Центр окружности через начало координат, a и b
+Point2D CircumcenterWithOrigin(const Point2D &a, const Point2D &b) noexcept {
+    const double d = 2 * a.Cross(b);
+    const double a2 = a.Dot(a), b2 = b.Dot(b);
+    return {(b.y * a2 - a.y * b2) / d, (a.x * b2 - b.x * a2) / d};
+}
+
+Point2D Circumcenter(const Point2D &a, const Point2D &b, const Point2D &c) noexcept {
+    return a + CircumcenterWithOrigin(b - a, c - a);
+}
+
+// Точка q строго внутри окружности, описанной около треугольника abc с обходом против часовой стрелки
+bool InCircumcircle(const Point2D &a, const Point2D &b, const Point2D &c, const Point2D &q) noexcept {
+    const Point2D da = a - q, db = b - q, dc = c - q;
+    return da.Dot(da) * db.Cross(dc) + db.Dot(db) * dc.Cross(da) + dc.Dot(dc) * da.Cross(db) > 0;
+}
+
+// Точка почти на прямой ребра (a, b): окружность через неё и ребро вырождается
+bool NearlyCollinear(const Point2D &a, const Point2D &b, const Point2D &q) noexcept {
+    const Point2D edge = b - a;
+    return std::abs(edge.Cross(q - a)) <= 1e-12 * edge.Dot(edge);
+}
+
+}  // namespace
+
+Point2D RasterGrid::Node(size_t column, size_t row) const noexcept {
+    return {box.min_x + (static_cast<double>(column) + 0.5) * box.Width() / static_cast<double>(columns),
+            box.min_y + (static_cast<double>(row) + 0.5) * box.Height() / static_cast<double>(rows)};
+}
+
+Tin::Tin(std::unique_ptr<TriangleMesh> mesh, std::vector<double> values)
+    : mesh_(std::move(mesh)), values_(std::move(values)), locator_(*mesh_) {}
+
+std::expected<Tin, std::string> Tin::Build(std::span<const Point2D> points, std::span<const double> values) {
+    if (points.size() != values.size()) {
+        return std::unexpected("Each sample point requires exactly one value.");
+    }
+
+    const auto welded = point_set::WeldVertices(points, 0.0);
+    std::vector<double> sums(welded.points.size(), 0.0);
+    std::vector<size_t> counts(welded.points.size(), 0);
+    for (size_t i = 0; i < points.size(); ++i) {
+        sums[welded.remap[i]] += values[i];
+        ++counts[welded.remap[i]];
+    }
+
+    auto triangles = DelaunayTriangulation(welded.points);
+    if (!triangles) {
+        return std::unexpected(triangles.error());
+    }
+    auto mesh = std::make_unique<TriangleMesh>(BuildMesh(*triangles));
+    if (mesh->Size() == 0) {
+        return std::unexpected("Sample points must not be collinear.");
+    }
+
+    std::unordered_map<Point2D, size_t> sample;
+    sample.reserve(welded.points.size());
+    for (size_t i = 0; i < welded.points.size(); ++i) {
+        sample.emplace(welded.points[i], i);
+    }
+    std::vector<double> vertex_values;
+    vertex_values.reserve(mesh->vertices.size());
+    for (const auto &v : mesh->vertices) {
+        const size_t i = sample.at(v);
+        vertex_values.push_back(sums[i] / static_cast<double>(counts[i]));
+    }
+    return Tin(std::move(mesh), std::move(vertex_values));
+}
+
+double Tin::Linear(const Point2D &p, size_t triangle) const {
+    const auto &[a, b, c] = mesh_->triangles[triangle];
+    const Point2D &pa = mesh_->vertices[a], &pb = mesh_->vertices[b], &pc = mesh_->vertices[c];
+    const double area = SignedArea(pa, pb, pc);
+    const double wa = SignedArea(p, pb, pc) / area;
+    const double wb = SignedArea(pa, p, pc) / area;
+    return wa * values_[a] + wb * values_[b] + (1.0 - wa - wb) * values_[c];
+}
+
+/**
+    @brief Интерполяция по естественным соседям (координаты Сибсона) по схеме Уотсона
+
+    Полость — треугольники, в описанную окружность которых попадает точка q; их вершины и есть естественные
+    соседи. Для треугольника полости (v0, v1, v2) с центром описанной окружности c и центрами g_k окружностей
+    через q и ребро напротив v_k площадь, которую ячейка q отнимает у v0, получает вклад S(c, g2, g1),
+    у остальных вершин — циклически. Суммирование знаковых площадей не требует упорядочивать вершины
+    ячеек Вороного.
+*/
+double Tin::NaturalNeighbor(const Point2D &p, size_t triangle, std::vector<size_t> &cavity) const {
+    const auto &mesh = *mesh_;
+    for (size_t v : mesh.triangles[triangle]) {
+        if (mesh.vertices[v].DistanceTo(p) < EPS) {
+            return values_[v];
+        }
+    }
+
+    Point2D q = p;
+    auto collect_cavity = [&] {
+        cavity.assign(1, triangle);
+        for (size_t i = 0; i < cavity.size(); ++i) {
+            for (size_t neighbor : mesh.neighbors[cavity[i]]) {
+                if (neighbor == NO_NEIGHBOR || std::ranges::find(cavity, neighbor) != cavity.end()) {
+                    continue;
+                }
+                const Triangle t = mesh.GetTriangle(neighbor);
+                if (InCircumcircle(t.a, t.b, t.c, q)) {
+                    cavity.push_back(neighbor);
+                }
+            }
+        }
+    };
+    auto degenerate = [&] {
+        return std::ranges::any_of(cavity, [&](size_t t) {
+            const Triangle tri = mesh.GetTriangle(t);
+            return NearlyCollinear(tri.a, tri.b, q) || NearlyCollinear(tri.b, tri.c, q) ||
+                   NearlyCollinear(tri.c, tri.a, q);
+        });
+    };
+
+    collect_cavity();
+    if (degenerate()) {
+        const Triangle tri = mesh.GetTriangle(triangle);
+        q = q + (tri.Center() - q) * NUDGE;
+        collect_cavity();
+        if (degenerate()) {
+            return Linear(p, triangle);
+        }
+    }
+
+    // Вершины полости и накопленные веса; соседей немного, поэтому линейный поиск дешевле хеша
+    std::vector<std::pair<size_t, double>> weights;
+    auto add = [&weights](size_t v, double w) {
+        auto it = std::ranges::find(weights, v, &std::pair<size_t, double>::first);
+        if (it == weights.end()) {
+            weights.emplace_back(v, w);
+        } else {
+            it->second += w;
+        }
+    };
+
+    for (size_t t : cavity) {
+        const auto &tri = mesh.triangles[t];
+        // Координаты относительно q, чтобы центры окружностей через q считались точнее
+        const std::array<Point2D, 3> v = {mesh.vertices[tri[0]] - q, mesh.vertices[tri[1]] - q,
+                                          mesh.vertices[tri[2]] - q};
+        const Point2D c = Circumcenter(v[0], v[1], v[2]);
+        const std::array<Point2D, 3> g = {CircumcenterWithOrigin(v[1], v[2]), CircumcenterWithOrigin(v[2], v[0]),
+                                          CircumcenterWithOrigin(v[0], v[1])};
+        for (size_t k = 0; k < 3; ++k) {
+            add(tri[k], SignedArea(c, g[(k + 2) % 3], g[(k + 1) % 3]));
+        }
+    }
+
+    double total = 0.0, weighted = 0.0;
+    for (const auto &[v, w] : weights) {
+        total += w;
+        weighted += w * values_[v];
+    }
+    return total != 0.0 ? weighted / total : Linear(p, triangle);
+}
+
+std::optional<double> Tin::Interpolate(const Point2D &p, InterpolationMethod method) const {
+    const auto triangle = locator_.Locate(p);
+    if (!triangle) {
+        return std::nullopt;
+    }
+    if (method == InterpolationMethod::Linear) {
+        return Linear(p, *triangle);
+    }
+    std::vector<size_t> cavity;
+    return NaturalNeighbor(p, *triangle, cavity);
+}
+
+std::vector<double> Tin::Interpolate(std::span<const Point2D> points, InterpolationMethod method,
+                                     size_t threads) const {
+    const auto triangles = locator_.LocateAll(points, threads);
+    std::vector<double> result(points.size(), std::numeric_limits<double>::quiet_NaN());
+
+    parallel::ParallelFor(
+        points.size(), INTERPOLATION_GRAIN,
+        [&](size_t begin, size_t end, size_t) {
+            std::vector<size_t> cavity;
+            for (size_t i = begin; i < end; ++i) {
+                if (!triangles[i]) {
+                    continue;
+                }
+                result[i] = method == InterpolationMethod::Linear ? Linear(points[i], *triangles[i])
+                                                                  : NaturalNeighbor(points[i], *triangles[i], cavity);
+            }
+        },
+        threads);
+    return result;
+}
+
+std::vector<double> Tin::Interpolate(const RasterGrid &grid, InterpolationMethod method, size_t threads) const {
+    std::vector<Point2D> nodes;
+    nodes.reserve(grid.columns * grid.rows);
+    for (size_t row = 0; row < grid.rows; ++row) {
+        for (size_t column = 0; column < grid.columns; ++column) {
+            nodes.push_back(grid.Node(column, row));
+        }
+    }
+    return Interpolate(nodes, method, threads);
+}
+
+}  // namespace geometry::triangulation
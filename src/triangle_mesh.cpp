@@ -0,0 +1,75 @@
+#include "triangle_mesh.hpp"
+#include <unordered_map>
+
+namespace geometry::triangulation {
+
+namespace {
+
+struct EdgeKeyHash {
+    [[nodiscard]] size_t operator()(const std::pair<size_t, size_t> &edge) const noexcept {
+        return std::hash<size_t>{}(edge.first * 0x9e3779b97f4a7c15ULL ^ edge.second);
+    }
+};
+
+}  // namespace
+
+TriangleMesh BuildMesh(std::span<const DelaunayTriangle> triangles) {
+    std::vector<Point2D> vertices;
+    std::unordered_map<Point2D, size_t> index;
+    index.reserve(triangles.size());
+
+    auto vertex_id = [&](const Point2D &p) {
+        auto [it, inserted] = index.try_emplace(p, vertices.size());
+        if (inserted) {
+            vertices.push_back(p);
+        }
+        return it->second;
+    };
+
+    std::vector<std::array<size_t, 3>> indexed;
+    indexed.reserve(triangles.size());
+    for (const auto &t : triangles) {
+        indexed.push_back({vertex_id(t.a), vertex_id(t.b), vertex_id(t.c)});
+    }
+    return BuildMesh(std::move(vertices), std::move(indexed));
+}
+
+TriangleMesh BuildMesh(std::vector<Point2D> vertices, std::vector<std::array<size_t, 3>> triangles) {
+    TriangleMesh mesh;
+    mesh.vertices = std::move(vertices);
+    mesh.triangles.reserve(triangles.size());
+
+    for (auto tri : triangles) {
+        const Point2D &a = mesh.vertices[tri[0]];
+        const double doubled_area = (mesh.vertices[tri[1]] - a).Cross(mesh.vertices[tri[2]] - a);
+        if (std::abs(doubled_area) < EPS) {
+            continue;
+        }
+        if (doubled_area < 0) {
+            std::swap(tri[1], tri[2]);
+        }
+        mesh.triangles.push_back(tri);
+    }
+
+    // Ориентированное ребро (a, b) одного треугольника встречается у соседа как (b, a)
+    std::unordered_map<std::pair<size_t, size_t>, size_t, EdgeKeyHash> half_edges;
+    half_edges.reserve(mesh.triangles.size() * 3);
+    for (size_t t = 0; t < mesh.triangles.size(); ++t) {
+        for (size_t k = 0; k < 3; ++k) {
+            half_edges.emplace(std::pair{mesh.triangles[t][k], mesh.triangles[t][(k + 1) % 3]}, t);
+        }
+    }
+
+    mesh.neighbors.assign(mesh.triangles.size(), {NO_NEIGHBOR, NO_NEIGHBOR, NO_NEIGHBOR});
+    for (size_t t = 0; t < mesh.triangles.size(); ++t) {
+        for (size_t k = 0; k < 3; ++k) {
+            auto it = half_edges.find({mesh.triangles[t][(k + 1) % 3], mesh.triangles[t][k]});
+            if (it != half_edges.end()) {
+                mesh.neighbors[t][k] = it->second;
+            }
+        }
+    }
+    return mesh;
+}
+
+}  // namespace geometry::triangulation
@@ -1,5 +1,6 @@
 #include "visualization.hpp"
 #include "geometry.hpp"
+#include "labeling.hpp"
 
 #include <matplot/matplot.h>
 #include <print>
@@ -34,6 +35,8 @@ void Draw(std::span<geometry::Shape> shapes, std::string_view filename) {
     using namespace matplot;
 
     const auto &fh = DrawConfig();
+    // Подписи ставятся в полюс недоступности, чтобы у невыпуклых многоугольников они не попадали наружу
+    const auto labels = labeling::LabelPoints(shapes);
 
     for (const auto &[index, shape] : std::ranges::views::enumerate(shapes)) {
         std::visit(Multilambda{[index](const Line &line) {
@@ -75,12 +78,31 @@ void Draw(std::span<geometry::Shape> shapes, std::string_view filename) {
                                    auto p = plot(lines.x, lines.y);
                                    p->line_width(2).color("cyan");
                                    std::println("Drawing Polygon {} with {} vertices", index, poly.Vertices().size());
+                               },
+                               [index](const PolygonWithHoles &poly) {
+                                   auto lines = poly.Lines();
+                                   auto p = plot(lines.x, lines.y);
+                                   p->line_width(2).color("cyan");
+                                   std::println("Drawing PolygonWithHoles {} with {} vertices and {} holes", index,
+                                                poly.Vertices().size(), poly.HoleCount());
+                               },
+                               [index](const MultiPolygon &multi) {
+                                   auto lines = multi.Lines();
+                                   auto p = plot(lines.x, lines.y);
+                                   p->line_width(2).color("cyan");
+                                   std::println("Drawing MultiPolygon {} with {} parts and {} rings", index,
+                                                multi.PartCount(), multi.RingCount());
+                               },
+                               [index](const InstancedShape &instance) {
+                                   auto lines = instance.Lines();
+                                   auto p = plot(lines.x, lines.y);
+                                   p->line_width(2).color("cyan");
+                                   std::println("Drawing InstancedShape {}: {}", index, instance);
                                }},
                    shape);
 
-        auto center = std::visit([](const auto &s) -> Point2D { return s.Center(); }, shape);
-
-        auto t = matplot::text(center.x, center.y, std::to_string(index));
+        const auto &label = labels[static_cast<size_t>(index)];
+        auto t = matplot::text(label.x, label.y, std::to_string(index));
         t->font_size(14);
         t->color("black");
     }
@@ -0,0 +1,119 @@
+#include "wide_bvh.hpp"
+#include "point_set.hpp"
+#include "spatial_index.hpp"
+#include <limits>
+
+namespace geometry::index {
+
+namespace {
+
+// Ссылка на ребёнка вместе с его точным прямоугольником — нужен только на время построения
+struct Entry {
+    uint32_t ref;
+    BoundingBox box;
+};
+
+// Наибольшее float, не превосходящее v
+float FloatBelow(double v) noexcept {
+    const auto f = static_cast<float>(v);
+    return static_cast<double>(f) > v ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f;
+}
+
+std::vector<BoundingBox> ShapeBoxes(std::span<const Shape> shapes) {
+    std::vector<BoundingBox> boxes;
+    boxes.reserve(shapes.size());
+    for (const auto &shape : shapes) {
+        boxes.push_back(std::visit([](const auto &s) -> BoundingBox { return s.BoundBox(); }, shape));
+    }
+    return boxes;
+}
+
+}  // namespace
+
+WideBvh::WideBvh(std::span<const Shape> shapes) : WideBvh(ShapeBoxes(shapes)) {}
+
+/**
+    @brief Построение packed R-tree: объекты по кривой Гильберта группируются по восемь, затем так же узлы
+
+    Решётка узла начинается в его левом нижнем углу (округлённом вниз до float), а шаг подбирается так,
+    чтобы 127 шагов покрывали узел целиком. Границы детей округляются наружу той же формулой, что
+    и запрос в Node::Overlapping; формула монотонна, поэтому пересекающийся с запросом ребёнок не теряется.
+*/
+WideBvh::WideBvh(std::span<const BoundingBox> boxes) : size_(boxes.size()) {
+    if (boxes.empty()) {
+        return;
+    }
+    bounds_ = UnionBox(boxes);
+
+    std::vector<Point2D> centers;
+    centers.reserve(boxes.size());
+    for (const auto &box : boxes) {
+        centers.push_back(box.Center());
+    }
+    std::vector<Entry> level;
+    level.reserve(boxes.size());
+    for (size_t i : point_set::HilbertOrder(centers)) {
+        level.push_back({static_cast<uint32_t>(i) | ITEM_BIT, boxes[i]});
+    }
+
+    nodes_.reserve(boxes.size() / (WIDTH - 1) + 1);
+    do {
+        std::vector<Entry> parents;
+        parents.reserve(level.size() / WIDTH + 1);
+        for (size_t first = 0; first < level.size(); first += WIDTH) {
+            const size_t count = std::min(WIDTH, level.size() - first);
+            const auto group = std::span(level).subspan(first, count);
+
+            BoundingBox box = group.front().box;
+            for (const auto &entry : group) {
+                box = {std::min(box.min_x, entry.box.min_x), std::min(box.min_y, entry.box.min_y),
+                       std::max(box.max_x, entry.box.max_x), std::max(box.max_y, entry.box.max_y)};
+            }
+
+            Node node{};
+            node.origin_x = FloatBelow(box.min_x);
+            node.origin_y = FloatBelow(box.min_y);
+            auto fit_step = [](double origin, double max) {
+                auto step = static_cast<float>((max - origin) / LEVELS);
+                if (!(step > 0.0f)) {
+                    return 1.0f;
+                }
+                while ((max - origin) / step > LEVELS) {
+                    step = std::nextafter(step, std::numeric_limits<float>::infinity());
+                }
+                return step;
+            };
+            node.step_x = fit_step(node.origin_x, box.max_x);
+            node.step_y = fit_step(node.origin_y, box.max_y);
+
+            auto lane = [](double v, double origin, double step, bool up) {
+                const double cell = (v - origin) / step;
+                return static_cast<uint64_t>(std::clamp(up ? std::ceil(cell) : std::floor(cell), 0.0, LEVELS));
+            };
+            for (size_t k = 0; k < count; ++k) {
+                const auto &child = group[k].box;
+                const size_t shift = 8 * k;
+                node.lo_x |= lane(child.min_x, node.origin_x, node.step_x, false) << shift;
+                node.hi_x |= lane(child.max_x, node.origin_x, node.step_x, true) << shift;
+                node.lo_y |= lane(child.min_y, node.origin_y, node.step_y, false) << shift;
+                node.hi_y |= lane(child.max_y, node.origin_y, node.step_y, true) << shift;
+                node.present |= uint64_t{0x80} << shift;
+                node.children[k] = group[k].ref;
+            }
+
+            parents.push_back({static_cast<uint32_t>(nodes_.size()), box});
+            nodes_.push_back(node);
+        }
+        level = std::move(parents);
+    } while (level.size() > 1);
+
+    root_ = level.front().ref;
+}
+
+std::vector<size_t> WideBvh::Query(const BoundingBox &box) const {
+    std::vector<size_t> result;
+    Query(box, [&result](size_t item) { result.push_back(item); });
+    return result;
+}
+
+}  // namespace geometry::index
@@ -0,0 +1,158 @@
+#include "clipping.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::clipping;
+
+namespace {
+
+const BoundingBox WINDOW{0, 0, 10, 10};
+
+double SignedArea(std::span<const Point2D> ring) {
+    double area = 0.0;
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        area += ring[j].Cross(ring[i]);
+    }
+    return area / 2;
+}
+
+}  // namespace
+
+TEST(ClippingTest, LineInsideIsUnchanged) {
+    const auto clipped = ClipLine(Line({1, 1}, {9, 5}), WINDOW);
+    ASSERT_TRUE(clipped.has_value());
+    EXPECT_EQ(clipped->start, Point2D(1, 1));
+    EXPECT_EQ(clipped->end, Point2D(9, 5));
+}
+
+TEST(ClippingTest, LineCrossingWindowIsTrimmed) {
+    const auto clipped = ClipLine(Line({-5, 5}, {15, 5}), WINDOW);
+    ASSERT_TRUE(clipped.has_value());
+    EXPECT_EQ(clipped->start, Point2D(0, 5));
+    EXPECT_EQ(clipped->end, Point2D(10, 5));
+
+    const auto diagonal = ClipLine(Line({-2, -2}, {4, 4}), WINDOW);
+    ASSERT_TRUE(diagonal.has_value());
+    EXPECT_EQ(diagonal->start, Point2D(0, 0));
+    EXPECT_EQ(diagonal->end, Point2D(4, 4));
+}
+
+TEST(ClippingTest, LineOutsideIsRejected) {
+    EXPECT_FALSE(ClipLine(Line({-5, -1}, {15, -1}), WINDOW).has_value());
+    EXPECT_FALSE(ClipLine(Line({11, 0}, {11, 10}), WINDOW).has_value());
+    // Проходит мимо угла
+    EXPECT_FALSE(ClipLine(Line({9, 12}, {12, 9}), WINDOW).has_value());
+}
+
+TEST(ClippingTest, RingInsideIsUnchanged) {
+    const std::vector<Point2D> ring{{1, 1}, {5, 1}, {3, 4}};
+    EXPECT_EQ(ClipRing(ring, WINDOW), ring);
+}
+
+TEST(ClippingTest, RingCoveringWindowBecomesWindow) {
+    const std::vector<Point2D> ring{{-5, -5}, {15, -5}, {15, 15}, {-5, 15}};
+    const auto clipped = ClipRing(ring, WINDOW);
+    EXPECT_EQ(clipped.size(), 4u);
+    EXPECT_DOUBLE_EQ(SignedArea(clipped), 100.0);
+}
+
+TEST(ClippingTest, RingIsTrimmedToWindow) {
+    // Треугольник, наполовину выходящий за правую сторону окна
+    const std::vector<Point2D> ring{{5, 2}, {15, 2}, {5, 8}};
+    const auto clipped = ClipRing(ring, WINDOW);
+    EXPECT_NEAR(SignedArea(clipped), 30.0 - 7.5, 1e-9);
+    for (const auto &p : clipped) {
+        EXPECT_LE(p.x, 10.0);
+    }
+    EXPECT_TRUE(ClipRing(std::vector<Point2D>{{20, 20}, {30, 20}, {25, 30}}, WINDOW).empty());
+}
+
+TEST(ClippingTest, BatchLinesMatchScalar) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> coord(-10.0, 20.0);
+    std::vector<Line> lines;
+    for (int i = 0; i < 1000; ++i) {
+        lines.emplace_back(Point2D{coord(rng), coord(rng)}, Point2D{coord(rng), coord(rng)});
+    }
+    // Вертикальные, горизонтальные и вырожденные отрезки, в том числе на границе окна
+    lines.emplace_back(Point2D{5, -5}, Point2D{5, 15});
+    lines.emplace_back(Point2D{-5, 10}, Point2D{15, 10});
+    lines.emplace_back(Point2D{12, 3}, Point2D{12, 8});
+    lines.emplace_back(Point2D{3, 3}, Point2D{3, 3});
+    lines.emplace_back(Point2D{-3, 3}, Point2D{-3, 3});
+
+    LineSoA in, out;
+    in.Assign(lines);
+    out.Resize(in.Size());
+    std::vector<uint8_t> visible(in.Size());
+    const size_t count = ClipLines(in, WINDOW, out, visible);
+
+    size_t expected_count = 0;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        const auto scalar = ClipLine(lines[i], WINDOW);
+        ASSERT_EQ(visible[i] != 0, scalar.has_value()) << i;
+        if (scalar) {
+            ++expected_count;
+            EXPECT_NEAR(out.At(i).start.x, scalar->start.x, 1e-9);
+            EXPECT_NEAR(out.At(i).start.y, scalar->start.y, 1e-9);
+            EXPECT_NEAR(out.At(i).end.x, scalar->end.x, 1e-9);
+            EXPECT_NEAR(out.At(i).end.y, scalar->end.y, 1e-9);
+        } else {
+            EXPECT_TRUE(std::isnan(out.At(i).start.x));
+        }
+    }
+    EXPECT_EQ(count, expected_count);
+
+    // Обрезка на месте
+    ClipLines(in, WINDOW, in, visible);
+    EXPECT_EQ(in.At(lines.size() - 4).start, Point2D(0, 10));
+    EXPECT_EQ(in.At(lines.size() - 4).end, Point2D(10, 10));
+}
+
+TEST(ClippingTest, RingClipperMatchesScalar) {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> coord(-5.0, 15.0);
+    RingClipper clipper;
+    for (int trial = 0; trial < 200; ++trial) {
+        std::vector<Point2D> ring(3 + trial % 20);
+        std::vector<double> xs, ys;
+        for (auto &p : ring) {
+            p = {coord(rng), coord(rng)};
+            xs.push_back(p.x);
+            ys.push_back(p.y);
+        }
+        const auto scalar = ClipRing(ring, WINDOW);
+        const auto [cx, cy] = clipper.Clip(xs, ys, WINDOW);
+        ASSERT_EQ(cx.size(), scalar.size());
+        ASSERT_EQ(cy.size(), scalar.size());
+        for (size_t i = 0; i < scalar.size(); ++i) {
+            EXPECT_NEAR(cx[i], scalar[i].x, 1e-9);
+            EXPECT_NEAR(cy[i], scalar[i].y, 1e-9);
+        }
+    }
+}
+
+TEST(ClippingTest, ClipRingsBatch) {
+    // Квадрат внутри, квадрат снаружи и квадрат, покрывающий окно
+    const std::vector<double> xs{1, 2, 2, 1, 20, 30, 30, 20, -5, 15, 15, -5};
+    const std::vector<double> ys{1, 1, 2, 2, 20, 20, 30, 30, -5, -5, 15, 15};
+    const std::vector<size_t> offsets{0, 4, 8, 12};
+
+    RingClipper clipper;
+    std::vector<double> out_xs{42}, out_ys;
+    std::vector<size_t> out_offsets;
+    clipper.ClipRings(xs, ys, offsets, WINDOW, out_xs, out_ys, out_offsets);
+    EXPECT_EQ(out_offsets, (std::vector<size_t>{0, 4, 4, 8}));
+    ASSERT_EQ(out_xs.size(), 8u);
+    std::vector<Point2D> covering;
+    for (size_t i = 4; i < 8; ++i) {
+        covering.emplace_back(out_xs[i], out_ys[i]);
+    }
+    EXPECT_DOUBLE_EQ(SignedArea(covering), 100.0);
+
+    clipper.ClipRings(xs, ys, {}, WINDOW, out_xs, out_ys, out_offsets);
+    EXPECT_TRUE(out_xs.empty());
+    EXPECT_EQ(out_offsets, std::vector<size_t>{0});
+}
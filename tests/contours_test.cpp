@@ -0,0 +1,108 @@
+#include "contours.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace geometry;
+using namespace geometry::triangulation;
+
+namespace {
+
+// Регулярная сетка side x side ячеек над квадратом [0, side]^2 и значения функции в её узлах
+struct Surface {
+    TriangleMesh mesh;
+    std::vector<double> values;
+};
+
+template <typename F>
+Surface GridSurface(size_t side, F f) {
+    std::vector<Point2D> vertices;
+    for (size_t y = 0; y <= side; ++y) {
+        for (size_t x = 0; x <= side; ++x) {
+            vertices.emplace_back(static_cast<double>(x), static_cast<double>(y));
+        }
+    }
+    std::vector<std::array<size_t, 3>> triangles;
+    for (size_t y = 0; y < side; ++y) {
+        for (size_t x = 0; x < side; ++x) {
+            const size_t v = y * (side + 1) + x;
+            triangles.push_back({v, v + 1, v + side + 2});
+            triangles.push_back({v, v + side + 2, v + side + 1});
+        }
+    }
+    Surface surface{BuildMesh(vertices, triangles), {}};
+    for (const auto &p : surface.mesh.vertices) {
+        surface.values.push_back(f(p));
+    }
+    return surface;
+}
+
+double SignedArea(std::span<const Point2D> ring) {
+    double area = 0.0;
+    for (size_t i = 0; i < ring.size(); ++i) {
+        area += ring[i].Cross(ring[(i + 1) % ring.size()]);
+    }
+    return area / 2;
+}
+
+}  // namespace
+
+TEST(ContoursTest, PlaneGivesOpenStraightChains) {
+    const auto surface = GridSurface(10, [](const Point2D &p) { return p.x + 0.5 * p.y; });
+    const std::vector<double> levels = {3.25, 7.75};
+    const auto contours = ExtractContours(surface.mesh, surface.values, levels);
+
+    ASSERT_EQ(contours.size(), 2);
+    for (size_t i = 0; i < contours.size(); ++i) {
+        const auto &contour = contours[i];
+        EXPECT_EQ(contour.level, levels[i]);
+        EXPECT_FALSE(contour.closed);
+        EXPECT_FALSE(contour.AsPolygon().has_value());
+        for (const auto &p : contour.points) {
+            EXPECT_NEAR(p.x + 0.5 * p.y, contour.level, 1e-12);
+        }
+        // Концы на границе, точки без повторов
+        EXPECT_NEAR(contour.points.front().y, 0.0, 1e-12);
+        const Point2D back = contour.points.back();
+        EXPECT_TRUE(std::abs(back.x) < 1e-12 || std::abs(back.y - 10.0) < 1e-12);
+        for (size_t k = 1; k < contour.points.size(); ++k) {
+            EXPECT_NE(contour.points[k - 1], contour.points[k]);
+        }
+    }
+}
+
+TEST(ContoursTest, ConeGivesClosedClockwiseRings) {
+    const Point2D peak{10, 10};
+    const auto surface = GridSurface(20, [&](const Point2D &p) { return 20.0 - p.DistanceTo(peak); });
+    const std::vector<double> levels = {12.5, 17.5, 25.0};
+    const auto contours = ExtractContours(surface.mesh, surface.values, levels, 2);
+
+    ASSERT_EQ(contours.size(), 2);
+    for (const auto &contour : contours) {
+        ASSERT_TRUE(contour.closed);
+        const double radius = 20.0 - contour.level;
+        for (const auto &p : contour.points) {
+            EXPECT_NEAR(p.DistanceTo(peak), radius, 0.1);
+        }
+        // Значения выше уровня справа: кольцо вокруг вершины идёт по часовой стрелке
+        const double area = SignedArea(contour.points);
+        EXPECT_LT(area, 0.0);
+        EXPECT_NEAR(-area, std::numbers::pi * radius * radius, 0.1 * radius * radius);
+
+        const auto polygon = contour.AsPolygon();
+        ASSERT_TRUE(polygon.has_value());
+        EXPECT_EQ(polygon->Vertices().size(), contour.points.size());
+    }
+}
+
+TEST(ContoursTest, LevelThroughVerticesAndEmptyInput) {
+    const auto surface = GridSurface(4, [](const Point2D &p) { return p.x; });
+    // Уровень ровно по узлам: изолиния не двоится и не рвётся
+    const std::vector<double> level = {2.0};
+    const auto contours = ExtractContours(surface.mesh, surface.values, level);
+    ASSERT_EQ(contours.size(), 1);
+    for (const auto &p : contours.front().points) {
+        EXPECT_NEAR(p.x, 2.0, 1e-12);
+    }
+
+    EXPECT_TRUE(ExtractContours(surface.mesh, surface.values, {}).empty());
+}
@@ -0,0 +1,120 @@
+#include "convex_decomposition.hpp"
+#include "queries.hpp"
+#include <gtest/gtest.h>
+
+using namespace geometry;
+using namespace geometry::decomposition;
+
+namespace {
+
+double Area(std::span<const Point2D> ring) {
+    double area = 0.0;
+    for (size_t i = 0; i < ring.size(); ++i) {
+        area += ring[i].Cross(ring[(i + 1) % ring.size()]);
+    }
+    return area / 2;
+}
+
+bool IsConvex(std::span<const Point2D> ring) {
+    for (size_t i = 0; i < ring.size(); ++i) {
+        const Point2D &a = ring[i], &b = ring[(i + 1) % ring.size()], &c = ring[(i + 2) % ring.size()];
+        if ((b - a).Cross(c - b) < -1e-12) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Гребёнка из teeth зубцов: сильно невыпуклый многоугольник, заданный по часовой стрелке
+std::vector<Point2D> Comb(size_t teeth) {
+    std::vector<Point2D> ring = {{0, 0}};
+    for (size_t i = 0; i < teeth; ++i) {
+        const auto x = static_cast<double>(2 * i);
+        ring.insert(ring.end(), {{x, 1}, {x, 3}, {x + 1, 3}, {x + 1, 1}});
+    }
+    ring.emplace_back(static_cast<double>(2 * teeth - 1), 0);
+    return ring;
+}
+
+}  // namespace
+
+TEST(ConvexDecompositionTest, TriangulateSimplePolygon) {
+    const auto comb = Comb(4);
+    auto triangles = TriangulateSimplePolygon(comb);
+    ASSERT_TRUE(triangles.has_value());
+
+    double total = 0.0;
+    for (const auto &[a, b, c] : *triangles) {
+        const std::array<Point2D, 3> tri = {comb[a], comb[b], comb[c]};
+        EXPECT_GT(Area(tri), 0.0);
+        total += Area(tri);
+    }
+    EXPECT_NEAR(total, std::abs(Area(comb)), 1e-12);
+
+    EXPECT_FALSE(TriangulateSimplePolygon(std::vector<Point2D>{{0, 0}, {1, 1}}).has_value());
+    auto bowtie = TriangulateSimplePolygon(std::vector<Point2D>{{0, 0}, {2, 2}, {2, 0}, {0, 2}});
+    ASSERT_FALSE(bowtie.has_value());
+}
+
+TEST(ConvexDecompositionTest, PartsAreConvexAndCoverPolygon) {
+    const auto comb = Comb(5);
+    auto parts = ConvexDecomposition(comb);
+    ASSERT_TRUE(parts.has_value());
+
+    double total = 0.0;
+    for (const auto &part : *parts) {
+        EXPECT_TRUE(IsConvex(part.points));
+        EXPECT_GT(Area(part.points), 0.0);
+        total += Area(part.points);
+    }
+    EXPECT_NEAR(total, std::abs(Area(comb)), 1e-12);
+    // Оптимум — по части на зубец и основание; Хертель–Мельхорн даёт не больше вчетверо
+    EXPECT_LE(parts->size(), 4 * 6);
+    EXPECT_GE(parts->size(), 6);
+
+    // Выпуклый многоугольник остаётся одной частью
+    auto square = ConvexDecomposition(std::vector<Point2D>{{0, 0}, {1, 0}, {1, 1}, {0, 1}});
+    ASSERT_TRUE(square.has_value());
+    EXPECT_EQ(square->size(), 1);
+}
+
+TEST(ConvexDecompositionTest, ConvexKernels) {
+    const std::vector<Point2D> square = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    const std::vector<Point2D> touching = {{1, 0}, {2, 0}, {2, 1}};
+    const std::vector<Point2D> far = {{3, 0}, {4, 0}, {4, 1}};
+
+    EXPECT_TRUE(ConvexPartsIntersect(square, touching));
+    EXPECT_FALSE(ConvexPartsIntersect(square, far));
+    EXPECT_DOUBLE_EQ(ConvexPartsDistance(square, touching), 0.0);
+    EXPECT_DOUBLE_EQ(ConvexPartsDistance(square, far), 2.0);
+}
+
+TEST(ConvexDecompositionTest, PolygonQueriesMatchGenericVisitors) {
+    ConvexDecompositionCache cache;
+    const Polygon comb(Comb(3));
+    // Квадрат в промежутке между зубцами гребёнки: bounding box пересекаются, сами фигуры — нет
+    const Polygon gap({{1.25, 1.5}, {1.75, 1.5}, {1.75, 2.5}, {1.25, 2.5}});
+    const Polygon tooth({{2.5, 2}, {3.5, 2}, {3.5, 4}, {2.5, 4}});
+
+    EXPECT_FALSE(PolygonsIntersect(comb, gap, cache));
+    EXPECT_TRUE(PolygonsIntersect(comb, tooth, cache));
+    EXPECT_EQ(PolygonsIntersect(comb, gap, cache), queries::ShapesIntersectVisitor{}(comb, gap));
+
+    EXPECT_NEAR(PolygonsDistance(comb, gap, cache), 0.25, 1e-12);
+    EXPECT_NEAR(PolygonsDistance(comb, gap, cache), queries::ExactDistanceVisitor{}(comb, gap), 1e-12);
+    EXPECT_DOUBLE_EQ(PolygonsDistance(comb, tooth, cache), 0.0);
+
+    EXPECT_EQ(cache.Size(), 3);
+    // Копия многоугольника находит то же разбиение
+    const Polygon copy = comb;
+    EXPECT_EQ(cache.Get(copy), cache.Get(comb));
+    EXPECT_EQ(cache.Size(), 3);
+
+    // Самопересекающийся многоугольник кешируется без частей и обрабатывается общей проверкой
+    const Polygon bowtie({{0, 0}, {2, 2}, {2, 0}, {0, 2}});
+    EXPECT_TRUE(cache.Get(bowtie)->empty());
+    EXPECT_TRUE(PolygonsIntersect(bowtie, tooth, cache) == queries::ShapesIntersectVisitor{}(bowtie, tooth));
+
+    cache.Clear();
+    EXPECT_EQ(cache.Size(), 0);
+}
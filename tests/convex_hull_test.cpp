@@ -1,5 +1,8 @@
 #include "convex_hull.hpp"
+#include <cmath>
 #include <gtest/gtest.h>
+#include <numbers>
+#include <random>
 
 using namespace geometry;
 using namespace geometry::convex_hull;
@@ -16,4 +19,144 @@ TEST(ConvexHullTest, GrahamScan_TooFewPoints) {
     auto result = geometry::convex_hull::GrahamScan(points);
     EXPECT_FALSE(result.has_value());
     EXPECT_EQ(result.error(), "At least three points are required for convex hull.");
-}
\ No newline at end of file
+}
+namespace {
+
+std::vector<Point2D> RandomHull(std::mt19937 &rng, size_t count) {
+    std::uniform_real_distribution<double> angle(0.0, 2 * std::numbers::pi);
+    std::uniform_real_distribution<double> radius(0.0, 10.0);
+    std::vector<Point2D> points(count);
+    for (auto &p : points) {
+        const double a = angle(rng), r = radius(rng);
+        p = {r * std::cos(a), r * std::sin(a)};
+    }
+    return GrahamScan(points).value();
+}
+
+// Все вершины не левее луча p -> v (для правой касательной) или не правее (для левой)
+bool IsTangent(std::span<const Point2D> hull, const Point2D &p, const Point2D &v, int side) {
+    return std::ranges::all_of(hull, [&](const Point2D &q) { return side * (v - p).Cross(q - p) >= -1e-9; });
+}
+
+}  // namespace
+
+TEST(ConvexPolygonTest, ContainsMatchesLinearCheck) {
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<double> coord(-12.0, 12.0);
+    for (int round = 0; round < 20; ++round) {
+        const auto hull = RandomHull(rng, 200);
+        const ConvexPolygon polygon(hull);
+        for (int i = 0; i < 200; ++i) {
+            const Point2D p{coord(rng), coord(rng)};
+            bool inside = true;
+            for (size_t k = 0; k < hull.size(); ++k) {
+                inside = inside && CrossProduct(hull[(k + 1) % hull.size()], hull[k], p) >= 0;
+            }
+            ASSERT_EQ(polygon.Contains(p), inside);
+        }
+        for (const auto &v : hull) {
+            EXPECT_TRUE(polygon.Contains(v));
+        }
+    }
+}
+
+TEST(ConvexPolygonTest, CollinearVerticesAndDegenerateInput) {
+    // Середины сторон остаются в оболочке как коллинеарные вершины
+    const std::vector<Point2D> square = {{0, 0}, {1, 0}, {2, 0}, {2, 1}, {2, 2}, {1, 2}, {0, 2}, {0, 1}};
+    const ConvexPolygon polygon(square);
+
+    EXPECT_TRUE(polygon.Contains({1, 1}));
+    EXPECT_TRUE(polygon.Contains({2, 0.5}));
+    EXPECT_TRUE(polygon.Contains({0, 1.5}));
+    EXPECT_FALSE(polygon.Contains({3, 0}));
+    EXPECT_FALSE(polygon.Contains({-0.1, 1}));
+
+    const auto tangents = polygon.Tangents({5, 1});
+    ASSERT_TRUE(tangents.has_value());
+    // Смотрящему из (5, 1) на запад правая касательная приходится на верхнюю сторону
+    EXPECT_EQ(square[tangents->first].y, 2.0);
+    EXPECT_EQ(square[tangents->second].y, 0.0);
+    EXPECT_FALSE(polygon.Tangents({1, 1}).has_value());
+
+    const auto chord = polygon.IntersectLine({-1, 1}, {0, 1});
+    ASSERT_TRUE(chord.has_value());
+    EXPECT_EQ(chord->first, Point2D(0, 1));
+    EXPECT_EQ(chord->second, Point2D(2, 1));
+    EXPECT_FALSE(polygon.IntersectLine({0, 3}, {1, 3}).has_value());
+
+    const std::vector<Point2D> segment = {{0, 0}, {1, 1}};
+    EXPECT_FALSE(ConvexPolygon(segment).Contains({0, 0}));
+}
+
+TEST(ConvexPolygonTest, LongCollinearRun) {
+    // Нижняя сторона из 11 коллинеарных вершин — больше половины оболочки, плато у минимума длинное
+    std::vector<Point2D> hull;
+    for (int x = 0; x <= 10; ++x) {
+        hull.emplace_back(x, 0);
+    }
+    hull.emplace_back(10, 1);
+    hull.emplace_back(0, 1);
+    const ConvexPolygon polygon(hull);
+
+    for (int k = 0; k < 64; ++k) {
+        const double angle = 2 * std::numbers::pi * k / 64;
+        const Point2D direction{std::cos(angle), std::sin(angle)};
+        const double best = std::ranges::max(hull, {}, [&](const Point2D &v) { return direction.Dot(v); })
+                                .Dot(direction);
+        EXPECT_DOUBLE_EQ(direction.Dot(hull[polygon.ExtremeVertex(direction)]), best) << k;
+    }
+    EXPECT_EQ(hull[polygon.ExtremeVertex({0, 1})].y, 1.0);
+
+    const auto chord = polygon.IntersectLine({-1, 0.5}, {0, 0.5});
+    ASSERT_TRUE(chord.has_value());
+    EXPECT_EQ(chord->first, Point2D(0, 0.5));
+    EXPECT_EQ(chord->second, Point2D(10, 0.5));
+
+    // Точки на продолжении нижней стороны и под ней
+    for (const Point2D p : {Point2D(20, 0), Point2D(-5, 0), Point2D(5, -3), Point2D(15, -0.5), Point2D(5, 4)}) {
+        const auto tangents = polygon.Tangents(p);
+        ASSERT_TRUE(tangents.has_value());
+        EXPECT_TRUE(IsTangent(hull, p, hull[tangents->first], 1)) << p.x << " " << p.y;
+        EXPECT_TRUE(IsTangent(hull, p, hull[tangents->second], -1)) << p.x << " " << p.y;
+    }
+}
+
+TEST(ConvexPolygonTest, TangentsAndLineIntersection) {
+    std::mt19937 rng(23);
+    std::uniform_real_distribution<double> coord(-30.0, 30.0);
+    for (int round = 0; round < 20; ++round) {
+        const auto hull = RandomHull(rng, 100);
+        const ConvexPolygon polygon(hull);
+        for (int i = 0; i < 100; ++i) {
+            const Point2D p{coord(rng), coord(rng)};
+            const auto tangents = polygon.Tangents(p);
+            ASSERT_EQ(tangents.has_value(), !polygon.Contains(p));
+            if (tangents) {
+                EXPECT_TRUE(IsTangent(hull, p, hull[tangents->first], 1));
+                EXPECT_TRUE(IsTangent(hull, p, hull[tangents->second], -1));
+            }
+
+            // Эталон: отсечение параметрической прямой полуплоскостями рёбер
+            const Point2D a = p, b{coord(rng), coord(rng)};
+            const Point2D d = b - a;
+            double t0 = -1e18, t1 = 1e18;
+            for (size_t k = 0; k < hull.size(); ++k) {
+                const Point2D &u = hull[k], &v = hull[(k + 1) % hull.size()];
+                const double num = (v - u).Cross(a - u), den = (v - u).Cross(d);
+                if (den > 0) {
+                    t0 = std::max(t0, -num / den);
+                } else if (den < 0) {
+                    t1 = std::min(t1, -num / den);
+                } else if (num < 0) {
+                    t0 = 1, t1 = 0;
+                }
+            }
+            const auto chord = polygon.IntersectLine(a, b);
+            ASSERT_EQ(chord.has_value(), t0 <= t1);
+            if (chord) {
+                EXPECT_NEAR(chord->first.DistanceTo(a + d * t0), 0.0, 1e-7);
+                EXPECT_NEAR(chord->second.DistanceTo(a + d * t1), 0.0, 1e-7);
+            }
+        }
+    }
+}
@@ -39,6 +39,24 @@ TEST(Point2DTest, DistanceTo) {
     EXPECT_DOUBLE_EQ(a.DistanceTo(b), 5.0);
 }
 
+TEST(Point2DTest, LexicographicOrder) {
+    EXPECT_TRUE((Point2D{0, 5}) < (Point2D{1, 0}));
+    EXPECT_TRUE((Point2D{1, 0}) < (Point2D{1, 2}));
+    EXPECT_FALSE((Point2D{1, 2}) < (Point2D{1, 2}));
+
+    std::vector<Point2D> pts{{1, 0}, {0, 1}, {1, 0}, {0, 0}};
+    std::sort(pts.begin(), pts.end());
+    pts.erase(std::unique(pts.begin(), pts.end()), pts.end());
+    EXPECT_EQ(pts, (std::vector<Point2D>{{0, 0}, {0, 1}, {1, 0}}));
+}
+
+TEST(Point2DTest, Hash) {
+    std::hash<Point2D> hasher;
+    EXPECT_EQ(hasher(Point2D{1.5, -2.0}), hasher(Point2D{1.5, -2.0}));
+    EXPECT_EQ(hasher(Point2D{0.0, 0.0}), hasher(Point2D{-0.0, -0.0}));
+    EXPECT_NE(hasher(Point2D{1.0, 2.0}), hasher(Point2D{2.0, 1.0}));
+}
+
 // ----------------------------
 // Formatting tests
 // ----------------------------
@@ -185,4 +203,144 @@ TEST(ShapeTest, VariantConstruction) {
     EXPECT_TRUE(std::holds_alternative<Line>(s1));
     EXPECT_TRUE(std::holds_alternative<Circle>(s2));
     EXPECT_TRUE(std::holds_alternative<Polygon>(s3));
-}
\ No newline at end of file
+}
+// ----------------------------
+// PolygonWithHoles / MultiPolygon
+// ----------------------------
+
+namespace {
+
+PolygonWithHoles SquareWithHole() {
+    // Внешний контур по часовой стрелке, дыра — против: конструктор должен развернуть оба
+    return PolygonWithHoles{{{0, 0}, {0, 10}, {10, 10}, {10, 0}}, {{{4, 4}, {6, 4}, {6, 6}, {4, 6}}}};
+}
+
+double SignedArea(std::span<const Point2D> ring) {
+    double area = 0.0;
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        area += ring[j].Cross(ring[i]);
+    }
+    return area / 2;
+}
+
+}  // namespace
+
+TEST(PolygonWithHolesTest, NormalizesRingOrientation) {
+    const auto poly = SquareWithHole();
+
+    EXPECT_EQ(poly.RingCount(), 2);
+    EXPECT_EQ(poly.HoleCount(), 1);
+    EXPECT_GT(SignedArea(poly.Outer()), 0.0);
+    EXPECT_LT(SignedArea(poly.Hole(0)), 0.0);
+    EXPECT_EQ(poly.Vertices().size(), 8);
+}
+
+TEST(PolygonWithHolesTest, ContainsExcludesHoles) {
+    const auto poly = SquareWithHole();
+
+    EXPECT_TRUE(poly.Contains({1, 1}));
+    EXPECT_TRUE(poly.Contains({5, 8}));
+    EXPECT_FALSE(poly.Contains({5, 5}));
+    EXPECT_FALSE(poly.Contains({11, 5}));
+    EXPECT_FALSE(poly.Contains({-1, -1}));
+}
+
+TEST(PolygonWithHolesTest, BoxesAndCenter) {
+    const auto poly = SquareWithHole();
+    const auto box = poly.BoundBox();
+
+    EXPECT_EQ(box.min_x, 0);
+    EXPECT_EQ(box.min_y, 0);
+    EXPECT_EQ(box.max_x, 10);
+    EXPECT_EQ(box.max_y, 10);
+    EXPECT_EQ(poly.RingBox(1).min_x, 4);
+    EXPECT_EQ(poly.RingBox(1).max_y, 6);
+    EXPECT_EQ(poly.Center(), (Point2D{5, 5}));
+    EXPECT_EQ(poly.Height(), 10);
+}
+
+TEST(PolygonWithHolesTest, LinesSeparateRingsWithNaN) {
+    const auto lines = SquareWithHole().Lines();
+
+    // Два замкнутых контура по 5 точек и разделитель между ними
+    ASSERT_EQ(lines.x.size(), 11);
+    EXPECT_TRUE(std::isnan(lines.x[5]));
+    EXPECT_EQ(lines.x[0], lines.x[4]);
+    EXPECT_EQ(lines.y[6], lines.y[10]);
+}
+
+TEST(MultiPolygonTest, ContainsAnyPartOutsideHoles) {
+    const MultiPolygon multi{{SquareWithHole(), PolygonWithHoles{{{20, 0}, {30, 0}, {25, 5}}}}};
+
+    EXPECT_EQ(multi.PartCount(), 2);
+    EXPECT_EQ(multi.RingCount(), 3);
+    EXPECT_TRUE(multi.Contains({1, 1}));
+    EXPECT_TRUE(multi.Contains({25, 2}));
+    EXPECT_FALSE(multi.Contains({5, 5}));
+    EXPECT_FALSE(multi.Contains({15, 2}));
+
+    const auto box = multi.BoundBox();
+    EXPECT_EQ(box.min_x, 0);
+    EXPECT_EQ(box.max_x, 30);
+    EXPECT_EQ(multi.PartBox(1).min_x, 20);
+    EXPECT_EQ(multi.PartRings(1), (std::pair<size_t, size_t>{2, 3}));
+}
+
+// ----------------------------
+// Transform2D / InstancedShape
+// ----------------------------
+
+TEST(Transform2DTest, InverseAndComposition) {
+    const auto transform = Transform2D::Make({3, -2}, std::numbers::pi / 3, 2.0);
+    const Point2D p{1.5, 4};
+
+    const Point2D back = transform.ApplyInverse(transform.Apply(p));
+    EXPECT_NEAR(back.x, p.x, 1e-12);
+    EXPECT_NEAR(back.y, p.y, 1e-12);
+
+    const Point2D via_inverse = transform.Inverse().Apply(transform.Apply(p));
+    EXPECT_NEAR(via_inverse.x, p.x, 1e-12);
+    EXPECT_NEAR(via_inverse.y, p.y, 1e-12);
+
+    const auto second = Transform2D::Make({-1, 1}, -std::numbers::pi / 4, 0.5);
+    const Point2D composed = transform.Then(second).Apply(p);
+    const Point2D sequential = second.Apply(transform.Apply(p));
+    EXPECT_NEAR(composed.x, sequential.x, 1e-12);
+    EXPECT_NEAR(composed.y, sequential.y, 1e-12);
+}
+
+TEST(InstancedShapeTest, SharesPrototypeAndTransformsGeometry) {
+    const auto prototype = std::make_shared<const PrototypeShape>(Rectangle{{0, 0}, 2, 1});
+    const InstancedShape first(prototype, Transform2D::Make({10, 0}, std::numbers::pi / 2));
+    const InstancedShape second(prototype, Transform2D::Make({0, 10}, 0.0, 3.0));
+
+    EXPECT_EQ(prototype.use_count(), 3);
+    EXPECT_EQ(&first.Prototype(), &second.Prototype());
+
+    // Поворот на 90°: прямоугольник 2x1 становится 1x2 левее точки сдвига
+    const auto box = first.BoundBox();
+    EXPECT_NEAR(box.min_x, 9, 1e-12);
+    EXPECT_NEAR(box.max_x, 10, 1e-12);
+    EXPECT_NEAR(box.min_y, 0, 1e-12);
+    EXPECT_NEAR(box.max_y, 2, 1e-12);
+    EXPECT_NEAR(first.Height(), 2, 1e-12);
+    EXPECT_NEAR(first.Center().x, 9.5, 1e-12);
+    EXPECT_NEAR(first.Center().y, 1.0, 1e-12);
+
+    EXPECT_EQ(second.BoundBox().max_x, 6);
+    EXPECT_EQ(second.BoundBox().max_y, 13);
+    EXPECT_EQ(second.Vertices().size(), 4);
+    EXPECT_EQ(second.Lines().x.size(), 5);
+}
+
+TEST(InstancedShapeTest, TransformedKeepsShapeKinds) {
+    const auto shift = Transform2D::Make({1, 1}, 0.0, 2.0);
+    const auto turn = Transform2D::Make({0, 0}, 0.5);
+
+    EXPECT_TRUE(std::holds_alternative<Rectangle>(Transformed(Rectangle{{0, 0}, 1, 1}, shift)));
+    EXPECT_TRUE(std::holds_alternative<Polygon>(Transformed(Rectangle{{0, 0}, 1, 1}, turn)));
+
+    const auto circle = std::get<Circle>(Transformed(Circle{{1, 0}, 1}, shift));
+    EXPECT_EQ(circle.center_p, (Point2D{3, 1}));
+    EXPECT_EQ(circle.radius, 2);
+}
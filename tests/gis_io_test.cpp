@@ -0,0 +1,270 @@
+#include "gis_io.hpp"
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+using namespace geometry;
+using namespace geometry::io;
+
+namespace {
+
+const PolygonWithHoles FRAME({{0, 0}, {10, 0}, {10, 10}, {0, 10}}, {{{3, 3}, {3, 7}, {7, 7}, {7, 3}}});
+
+std::vector<Point2D> ToVector(std::span<const Point2D> points) { return {points.begin(), points.end()}; }
+
+// Фигуры всех видов и их ожидаемый вид после чтения
+void ExpectDecodedSample(const Geometries &decoded) {
+    ASSERT_EQ(decoded.shapes.size(), 7u);
+    const auto &line = std::get<Line>(decoded.shapes[0]);
+    EXPECT_EQ(line.start, Point2D(-1.5, 0.1));
+    EXPECT_EQ(line.end, Point2D(2, 1e-7));
+
+    const std::vector<Point2D> triangle{{0, 0}, {4, 0}, {0, 3}};
+    EXPECT_EQ(ToVector(std::get<Polygon>(decoded.shapes[1]).Vertices()), triangle);
+
+    const auto &frame = std::get<PolygonWithHoles>(decoded.shapes[2]);
+    EXPECT_EQ(ToVector(frame.Outer()), ToVector(FRAME.Outer()));
+    ASSERT_EQ(frame.HoleCount(), 1u);
+    EXPECT_EQ(ToVector(frame.Hole(0)), ToVector(FRAME.Hole(0)));
+
+    EXPECT_EQ(std::get<MultiPolygon>(decoded.shapes[3]).PartCount(), 2u);
+    EXPECT_EQ(std::get<Polygon>(decoded.shapes[4]).Vertices().size(), CIRCLE_VERTICES);
+
+    // Экземпляр записан как образ прототипа
+    const std::vector<Point2D> moved{{5, 5}, {7, 5}, {7, 6}, {5, 6}};
+    EXPECT_EQ(ToVector(std::get<Polygon>(decoded.shapes[5]).Vertices()), moved);
+    EXPECT_EQ(std::get<Polygon>(decoded.shapes[6]).Vertices().size(), 7u);
+
+    const std::vector<Point2D> points{{1, 2}, {-3.25, 4e10}};
+    EXPECT_EQ(decoded.points, points);
+}
+
+std::vector<Shape> SampleShapes() {
+    const auto prototype = std::make_shared<const PrototypeShape>(Rectangle({0, 0}, 2, 1));
+    return {
+        Line({-1.5, 0.1}, {2, 1e-7}),
+        Triangle({0, 0}, {4, 0}, {0, 3}),
+        FRAME,
+        MultiPolygon({FRAME, PolygonWithHoles({{20, 20}, {22, 20}, {21, 23}})}),
+        Circle({1, 1}, 2),
+        InstancedShape(prototype, Transform2D::Make({5, 5}, 0.0, 1.0)),
+        RegularPolygon({0, 0}, 1, 7),
+    };
+}
+
+const std::vector<Point2D> SAMPLE_POINTS{{1, 2}, {-3.25, 4e10}};
+
+void PutUint32(std::vector<uint8_t> &out, bool big_endian, uint32_t value) {
+    if (big_endian == (std::endian::native == std::endian::little)) {
+        value = std::byteswap(value);
+    }
+    const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+// Заголовок WKB с заданным порядком байтов
+void PutHeader(std::vector<uint8_t> &out, bool big_endian, uint32_t type) {
+    out.push_back(big_endian ? 0 : 1);
+    PutUint32(out, big_endian, type);
+}
+
+void PutDouble(std::vector<uint8_t> &out, bool big_endian, double value) {
+    auto bits = std::bit_cast<uint64_t>(value);
+    if (big_endian == (std::endian::native == std::endian::little)) {
+        bits = std::byteswap(bits);
+    }
+    const auto *bytes = reinterpret_cast<const uint8_t *>(&bits);
+    out.insert(out.end(), bytes, bytes + sizeof(bits));
+}
+
+}  // namespace
+
+TEST(GisIoTest, WkbRoundTripIsExact) {
+    const auto bytes = EncodeWkb(SampleShapes(), SAMPLE_POINTS);
+    const auto decoded = DecodeWkb(bytes);
+    ASSERT_TRUE(decoded) << decoded.error();
+    ExpectDecodedSample(*decoded);
+}
+
+TEST(GisIoTest, WktRoundTripIsExact) {
+    const std::string text = EncodeWkt(SampleShapes(), SAMPLE_POINTS);
+    EXPECT_TRUE(text.starts_with("LINESTRING (-1.5 0.1, 2 1e-07)\nPOLYGON ((0 0, 4 0, 0 3, 0 0))\n")) << text;
+    const auto decoded = DecodeWkt(text);
+    ASSERT_TRUE(decoded) << decoded.error();
+    ExpectDecodedSample(*decoded);
+}
+
+TEST(GisIoTest, GeoJsonRoundTripIsExact) {
+    const std::string text = EncodeGeoJson(SampleShapes(), SAMPLE_POINTS);
+    EXPECT_NE(text.find(R"({"type":"Feature","properties":{"index":0},"geometry":{"type":"LineString",)"
+                        R"("coordinates":[[-1.5,0.1],[2,1e-07]]}})"),
+              std::string::npos)
+        << text;
+    const auto decoded = DecodeGeoJson(text);
+    ASSERT_TRUE(decoded) << decoded.error();
+    ExpectDecodedSample(*decoded);
+}
+
+TEST(GisIoTest, ViewKeepsRingsAsStored) {
+    const auto bytes = EncodeWkb(std::vector<Shape>{FRAME});
+    size_t visits = 0;
+    const auto count = ReadWkb(bytes, [&](const GeometryView &view) {
+        ++visits;
+        EXPECT_EQ(view.type, GeometryType::Polygon);
+        ASSERT_EQ(view.PartCount(), 1u);
+        ASSERT_EQ(view.PathCount(), 2u);
+        // Кольца в WKB замкнуты повтором первой точки
+        EXPECT_EQ(view.Path(0).size(), 5u);
+        EXPECT_EQ(view.Path(1).front(), view.Path(1).back());
+    });
+    ASSERT_TRUE(count) << count.error();
+    EXPECT_EQ(*count, 1u);
+    EXPECT_EQ(visits, 1u);
+}
+
+TEST(GisIoTest, WkbByteOrderIsPerHeader) {
+    // MultiPoint в big-endian с точками в разных порядках байтов, затем пустая точка
+    std::vector<uint8_t> bytes;
+    PutHeader(bytes, true, 4);
+    PutUint32(bytes, true, 2);
+    PutHeader(bytes, false, 1);
+    PutDouble(bytes, false, 1.5);
+    PutDouble(bytes, false, -2);
+    PutHeader(bytes, true, 1);
+    PutDouble(bytes, true, 3);
+    PutDouble(bytes, true, 1e300);
+    PutHeader(bytes, true, 1);
+    PutDouble(bytes, true, std::numeric_limits<double>::quiet_NaN());
+    PutDouble(bytes, true, std::numeric_limits<double>::quiet_NaN());
+
+    const auto decoded = DecodeWkb(bytes);
+    ASSERT_TRUE(decoded) << decoded.error();
+    const std::vector<Point2D> expected{{1.5, -2}, {3, 1e300}};
+    EXPECT_EQ(decoded->points, expected);
+    EXPECT_TRUE(decoded->shapes.empty());
+}
+
+TEST(GisIoTest, CollectionsAreFlattened) {
+    const auto wkt = DecodeWkt("GEOMETRYCOLLECTION (POINT (1 2), LINESTRING (0 0, 1 1, 2 0), "
+                               "GEOMETRYCOLLECTION EMPTY, GEOMETRYCOLLECTION (POLYGON ((0 0, 1 0, 0 1))))");
+    ASSERT_TRUE(wkt) << wkt.error();
+    EXPECT_EQ(wkt->points.size(), 1u);
+    ASSERT_EQ(wkt->shapes.size(), 3u);
+    EXPECT_EQ(std::get<Polygon>(wkt->shapes[2]).Vertices().size(), 3u);
+
+    std::vector<uint8_t> bytes;
+    PutHeader(bytes, false, 7);
+    PutUint32(bytes, false, 2);
+    const auto body = EncodeWkb(std::vector<Shape>{Line({0, 0}, {1, 1})}, std::vector<Point2D>{{5, 5}});
+    bytes.insert(bytes.end(), body.begin(), body.end());
+    size_t visits = 0;
+    const auto read = ReadWkb(bytes, [&visits](const GeometryView &) { ++visits; });
+    ASSERT_TRUE(read) << read.error();
+    EXPECT_EQ(*read, 2u);
+    EXPECT_EQ(visits, 2u);
+}
+
+TEST(GisIoTest, WktAcceptsCommonVariants) {
+    const auto decoded = DecodeWkt("multipoint (1 2, 3 4); MultiPoint ((5 6));\nPOLYGON EMPTY  POINT EMPTY\n"
+                                   "MULTILINESTRING ((0 0, 1 0), (2 2, 3 3, 4 4))");
+    ASSERT_TRUE(decoded) << decoded.error();
+    const std::vector<Point2D> points{{1, 2}, {3, 4}, {5, 6}};
+    EXPECT_EQ(decoded->points, points);
+    EXPECT_EQ(decoded->shapes.size(), 3u);
+}
+
+TEST(GisIoTest, GeoJsonSkipsUnknownMembers) {
+    const auto decoded = DecodeGeoJson(R"({
+        "type": "FeatureCollection",
+        "bbox": [0, 0, 10, 10],
+        "features": [
+            {"type": "Feature", "id": "a\"b", "properties": {"geometry": {"type": "Point", "coordinates": [9, 9]}},
+             "geometry": {"coordinates": [[0, 0, 100], [1, 0, 100], [0, 1, 100], [0, 0, 100]], "type": "LineString"}},
+            {"type": "Feature", "properties": null, "geometry": null},
+            {"type": "Feature", "properties": {}, "geometry": {"type": "GeometryCollection", "geometries": [
+                {"type": "Point", "coordinates": [1, 2]},
+                {"type": "Polygon", "coordinates": []}
+            ]}}
+        ]
+    })");
+    ASSERT_TRUE(decoded) << decoded.error();
+    EXPECT_EQ(decoded->shapes.size(), 3u);
+    EXPECT_EQ(decoded->points, std::vector<Point2D>{Point2D(1, 2)});
+}
+
+TEST(GisIoTest, EmptyPolygonsAfterFilledGeometry) {
+    // Пустые многоугольники идут сразу за рамкой, чтобы в пуле остались её смещения
+    auto bytes = EncodeWkb(std::vector<Shape>{FRAME});
+    PutHeader(bytes, false, 3);
+    PutUint32(bytes, false, 0);
+    PutHeader(bytes, false, 6);
+    PutUint32(bytes, false, 2);
+    PutHeader(bytes, false, 3);
+    PutUint32(bytes, false, 0);
+    PutHeader(bytes, false, 3);
+    PutUint32(bytes, false, 1);
+    PutUint32(bytes, false, 3);
+    for (const Point2D &p : {Point2D(20, 20), Point2D(22, 20), Point2D(21, 23)}) {
+        PutDouble(bytes, false, p.x);
+        PutDouble(bytes, false, p.y);
+    }
+
+    const auto decoded = DecodeWkb(bytes);
+    ASSERT_TRUE(decoded) << decoded.error();
+    ASSERT_EQ(decoded->shapes.size(), 2u);
+    EXPECT_TRUE(std::holds_alternative<PolygonWithHoles>(decoded->shapes[0]));
+    const auto &multi = std::get<MultiPolygon>(decoded->shapes[1]);
+    ASSERT_EQ(multi.PartCount(), 1u);
+    EXPECT_EQ(multi.Vertices().size(), 3u);
+
+    // Те же геометрии через WKT: пустой многоугольник пишется как EMPTY и читается обратно
+    std::string wkt;
+    const auto count = ReadWkb(bytes, [&wkt](const GeometryView &view) {
+        WriteWkt(view, wkt);
+        wkt += '\n';
+    });
+    ASSERT_TRUE(count) << count.error();
+    EXPECT_NE(wkt.find("\nPOLYGON EMPTY\nMULTIPOLYGON (((20 20, 22 20, 21 23, 20 20)))\n"), std::string::npos) << wkt;
+    const auto reread = DecodeWkt(wkt);
+    ASSERT_TRUE(reread) << reread.error();
+    EXPECT_EQ(reread->shapes.size(), 2u);
+}
+
+TEST(GisIoTest, MalformedInputIsReported) {
+    auto bytes = EncodeWkb(std::vector<Shape>{FRAME});
+    bytes.pop_back();
+    EXPECT_FALSE(DecodeWkb(bytes));
+
+    std::vector<uint8_t> point_z;
+    PutHeader(point_z, false, 1001);
+    EXPECT_EQ(DecodeWkb(point_z).error(), "Unsupported WKB geometry type 1001.");
+
+    EXPECT_EQ(DecodeWkt("POINT Z (1 2 3)").error(), "WKT coordinates with Z or M are not supported.");
+    EXPECT_EQ(DecodeWkt("CIRCLE (1 2)").error(), "Unsupported WKT geometry type CIRCLE.");
+    EXPECT_FALSE(DecodeWkt("LINESTRING (0 0, 1)"));
+    EXPECT_FALSE(DecodeGeoJson(R"({"type": "Polygon", "coordinates": [[0, 0], [1, 0], [0, 1]]})"));
+    EXPECT_FALSE(DecodeGeoJson(R"({"type": "Point", "coordinates": [1, 2]} trailing)"));
+    EXPECT_FALSE(DecodeGeoJson(R"({"type": "Point", "coordinates": [1, 2])"));
+    EXPECT_FALSE(DecodeGeoJson(std::string(1000, '[')));
+}
+
+TEST(GisIoTest, MappedFileFeedsDecoder) {
+    const auto path = std::filesystem::temp_directory_path() / "gis_io_test.wkb";
+    const auto bytes = EncodeWkb(SampleShapes(), SAMPLE_POINTS);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+    auto file = MappedFile::Open(path.string());
+    ASSERT_TRUE(file) << file.error();
+    const MappedFile mapped = std::move(*file);
+    ASSERT_EQ(mapped.Bytes().size(), bytes.size());
+    const auto decoded = DecodeWkb(mapped.Bytes());
+    ASSERT_TRUE(decoded) << decoded.error();
+    ExpectDecodedSample(*decoded);
+    std::filesystem::remove(path);
+
+    EXPECT_FALSE(MappedFile::Open((std::filesystem::temp_directory_path() / "gis_io_missing.wkb").string()));
+}
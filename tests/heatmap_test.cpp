@@ -0,0 +1,64 @@
+#include "heatmap.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::visualization;
+
+TEST(HeatmapTest, PointsLandInTheirCells) {
+    const std::vector<Point2D> points{{0.5, 0.5}, {0.6, 0.4}, {3.5, 1.5}, {4, 4}, {9, 9}, {-1, 2}};
+    const auto grid = BinPoints(points, {.width = 4, .height = 4, .extent = BoundingBox{0, 0, 4, 4}});
+    EXPECT_EQ(grid.At(0, 0), 2.0);
+    EXPECT_EQ(grid.At(3, 1), 1.0);
+    // Точка на правом верхнем углу попадает в крайнюю ячейку
+    EXPECT_EQ(grid.At(3, 3), 1.0);
+    EXPECT_EQ(grid.Total(), 4.0);
+    EXPECT_EQ(grid.outside, 2u);
+}
+
+TEST(HeatmapTest, ParallelBinningMatchesSerial) {
+    std::mt19937 rng(1);
+    std::normal_distribution<double> coord(0.0, 10.0);
+    std::vector<Point2D> points(200000);
+    for (auto &p : points) {
+        p = {coord(rng), coord(rng)};
+    }
+    const auto serial = BinPoints(points, {.width = 64, .height = 48, .threads = 1});
+    const auto parallel = BinPoints(points, {.width = 64, .height = 48, .threads = 8});
+    EXPECT_EQ(serial.values, parallel.values);
+    EXPECT_EQ(serial.Total(), static_cast<double>(points.size()));
+    EXPECT_EQ(serial.outside, 0u);
+}
+
+TEST(HeatmapTest, BlurPreservesMassAndSpreadsSymmetrically) {
+    DensityGrid grid{{0, 0, 1, 1}, 41, 41, std::vector<double>(41 * 41, 0.0)};
+    grid.At(20, 20) = 100.0;
+    GaussianBlur(grid, 2.0, 3);
+
+    EXPECT_NEAR(grid.Total(), 100.0, 1e-9);
+    EXPECT_EQ(grid.Max(), grid.At(20, 20));
+    EXPECT_DOUBLE_EQ(grid.At(17, 20), grid.At(23, 20));
+    EXPECT_DOUBLE_EQ(grid.At(17, 20), grid.At(20, 17));
+    EXPECT_GT(grid.At(20, 14), 0.0);
+    EXPECT_EQ(grid.At(20, 13), 0.0);  // Дальше радиуса 3σ
+}
+
+TEST(HeatmapTest, ShapesAndColorize) {
+    const std::vector<Shape> shapes{Rectangle({0, 0}, 2, 2), Circle({8, 8}, 1), Line({0, 8}, {2, 8})};
+    const HeatmapOptions options{.width = 10, .height = 10, .extent = BoundingBox{0, 0, 10, 10}};
+    const auto centers = BinShapes(shapes, ShapePoints::Centers, options);
+    EXPECT_EQ(centers.Total(), 3.0);
+    EXPECT_EQ(centers.At(1, 1), 1.0);
+    EXPECT_EQ(centers.At(8, 8), 1.0);
+    const auto vertices = BinShapes(shapes, ShapePoints::Vertices, options);
+    EXPECT_EQ(vertices.Total(), 4.0 + 30.0 + 2.0);
+
+    const auto image = Colorize(centers, false);
+    ASSERT_EQ(image.width, 10u);
+    // Строка 0 кадра — верх сетки; пустые ячейки — начало палитры, максимум — конец
+    EXPECT_EQ(image.At(1, 8), (Rgb{253, 231, 37}));
+    EXPECT_EQ(image.At(5, 5), (Rgb{68, 1, 84}));
+
+    const std::vector<Point2D> points{{1, 1}};
+    EXPECT_EQ(RenderHeatmap(points, options).At(1, 8), (Rgb{253, 231, 37}));
+}
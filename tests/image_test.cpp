@@ -0,0 +1,57 @@
+#include "image.hpp"
+#include <gtest/gtest.h>
+
+using namespace geometry::visualization;
+
+namespace {
+
+uint32_t ReadBigEndian(const std::vector<uint8_t> &data, size_t at) {
+    return (uint32_t{data[at]} << 24) | (uint32_t{data[at + 1]} << 16) | (uint32_t{data[at + 2]} << 8) |
+           data[at + 3];
+}
+
+}  // namespace
+
+TEST(ImageTest, EncodesValidPngStructure) {
+    Image image{2, 2, {{255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {1, 2, 3}}};
+    const auto png = EncodePng(image);
+
+    const std::vector<uint8_t> signature{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    ASSERT_GE(png.size(), 8u);
+    EXPECT_TRUE(std::equal(signature.begin(), signature.end(), png.begin()));
+
+    // IHDR: длина 13, размеры 2 × 2, CRC эталонного заголовка
+    EXPECT_EQ(ReadBigEndian(png, 8), 13u);
+    EXPECT_EQ(std::string(png.begin() + 12, png.begin() + 16), "IHDR");
+    EXPECT_EQ(ReadBigEndian(png, 16), 2u);
+    EXPECT_EQ(ReadBigEndian(png, 20), 2u);
+    EXPECT_EQ(ReadBigEndian(png, 29), 0xFDD4'9A73u);
+
+    // IDAT: zlib-заголовок, один несжатый блок из двух строк по 1 + 6 байт
+    const size_t idat = 33;
+    EXPECT_EQ(std::string(png.begin() + idat + 4, png.begin() + idat + 8), "IDAT");
+    const size_t data = idat + 8;
+    EXPECT_EQ(png[data], 0x78);
+    EXPECT_EQ(png[data + 2], 1);  // Последний блок, без сжатия
+    EXPECT_EQ(png[data + 3] | (png[data + 4] << 8), 14);
+    const std::vector<uint8_t> raw{0, 255, 0, 0, 0, 255, 0, 0, 0, 0, 255, 1, 2, 3};
+    EXPECT_TRUE(std::equal(raw.begin(), raw.end(), png.begin() + data + 7));
+
+    EXPECT_EQ(std::string(png.end() - 8, png.end() - 4), "IEND");
+}
+
+TEST(ImageTest, LargeImageSplitsIntoStoredBlocks) {
+    Image image{300, 300, std::vector<Rgb>(300 * 300, Rgb{7, 7, 7})};
+    const auto png = EncodePng(image);
+    const size_t raw = 300 * (1 + 3 * 300);
+    const size_t blocks = (raw + 65534) / 65535;
+    // Сигнатура, три чанка по 12 байт служебных данных, IHDR, zlib: 2 + 5 на блок + данные + 4
+    EXPECT_EQ(png.size(), 8 + 3 * 12 + 13 + 2 + 5 * blocks + raw + 4);
+}
+
+TEST(ImageTest, SaveReportsUnwritablePath) {
+    const Image image{1, 1, {{0, 0, 0}}};
+    const auto result = SavePng(image, "/nonexistent-directory/out.png");
+    ASSERT_FALSE(result.has_value());
+    EXPECT_NE(result.error().find("Cannot open"), std::string::npos);
+}
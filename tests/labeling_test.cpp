@@ -0,0 +1,76 @@
+#include "labeling.hpp"
+#include "queries.hpp"
+#include <gtest/gtest.h>
+#include <numbers>
+
+using namespace geometry;
+using namespace geometry::labeling;
+
+namespace {
+
+// П-образный многоугольник: центр bounding box лежит в вырезе, снаружи фигуры
+const std::vector<Point2D> U_SHAPE = {{0, 0}, {10, 0}, {10, 10}, {7, 10}, {7, 3}, {3, 3}, {3, 10}, {0, 10}};
+
+}  // namespace
+
+TEST(LabelingTest, SquareCenter) {
+    const std::vector<Point2D> square = {{0, 0}, {4, 0}, {4, 4}, {0, 4}};
+    const auto pole = PoleOfInaccessibility(square, 1e-6);
+    EXPECT_NEAR(pole.x, 2.0, 1e-5);
+    EXPECT_NEAR(pole.y, 2.0, 1e-5);
+}
+
+TEST(LabelingTest, ConcavePolygonLabelIsInside) {
+    const Polygon polygon(U_SHAPE);
+    ASSERT_FALSE(queries::PointInShapeVisitor{polygon.Center()}(polygon));
+
+    const auto pole = PoleOfInaccessibility(U_SHAPE, 1e-3);
+    EXPECT_TRUE(queries::PointInShapeVisitor{pole}(polygon));
+    // Наибольший вписанный круг — в углу между ножкой и основанием: касается двух внешних сторон и
+    // внутренней вершины (3, 3), так что (3 - r) * sqrt(2) = r
+    const double radius = 3 * std::numbers::sqrt2 / (1 + std::numbers::sqrt2);
+    EXPECT_NEAR(queries::detail::DistanceToOutline(pole, U_SHAPE, true), radius, 1e-3);
+
+    // Ориентация контура не влияет на результат
+    std::vector<Point2D> reversed(U_SHAPE.rbegin(), U_SHAPE.rend());
+    EXPECT_NEAR(queries::detail::DistanceToOutline(PoleOfInaccessibility(reversed, 1e-3), U_SHAPE, true), radius, 1e-3);
+}
+
+TEST(LabelingTest, DegenerateRings) {
+    EXPECT_EQ(PoleOfInaccessibility(std::vector<Point2D>{{1, 1}, {1, 1}, {1, 1}}), Point2D(1, 1));
+    EXPECT_EQ(PoleOfInaccessibility(std::vector<Point2D>{{0, 0}, {2, 0}, {4, 0}}), Point2D(0, 0));
+}
+
+TEST(LabelingTest, LabelPointsForShapes) {
+    std::vector<Shape> shapes = {Circle{{1, 2}, 3}, Rectangle{{0, 0}, 2, 4}, Polygon(U_SHAPE)};
+    const auto labels = LabelPoints(shapes, 0.0, 2);
+    ASSERT_EQ(labels.size(), shapes.size());
+    EXPECT_EQ(labels[0], Point2D(1, 2));
+    EXPECT_EQ(labels[1], Point2D(1, 2));
+    EXPECT_TRUE(queries::PointInShapeVisitor{labels[2]}(std::get<Polygon>(shapes[2])));
+    EXPECT_EQ(labels[2], LabelPoint(shapes[2]));
+}
+
+TEST(LabelingTest, PoleAvoidsHoles) {
+    // Центр квадрата занят дырой, полюс уходит в самую широкую часть рамки — её правую полосу
+    const PolygonWithHoles frame{{{0, 0}, {10, 0}, {10, 10}, {0, 10}}, {{{1, 1}, {6, 1}, {6, 9}, {1, 9}}}};
+    const Point2D pole = PoleOfInaccessibility(frame, 1e-3);
+    EXPECT_TRUE(frame.Contains(pole));
+    EXPECT_NEAR(pole.x, 8.0, 1e-2);
+
+    // У мультиполигона подпись ставится в части с наибольшим вписанным кругом
+    const Shape multi = MultiPolygon{{PolygonWithHoles{{{0, 0}, {2, 0}, {2, 2}, {0, 2}}},
+                                      PolygonWithHoles{{{10, 0}, {16, 0}, {16, 6}, {10, 6}}}}};
+    const Point2D label = LabelPoint(multi, 1e-3);
+    EXPECT_NEAR(label.x, 13.0, 1e-2);
+    EXPECT_NEAR(label.y, 3.0, 1e-2);
+}
+
+TEST(LabelingTest, InstancedShapeLabelFollowsTransform) {
+    const auto prototype = std::make_shared<const PrototypeShape>(Polygon(U_SHAPE));
+    const auto transform = Transform2D::Make({100, 50}, std::numbers::pi / 2, 2.0);
+    const Point2D label = LabelPoint(InstancedShape(prototype, transform), 1e-3);
+    const Point2D expected = transform.Apply(PoleOfInaccessibility(U_SHAPE, 1e-3 / 2));
+    EXPECT_NEAR(label.x, expected.x, 1e-9);
+    EXPECT_NEAR(label.y, expected.y, 1e-9);
+}
@@ -0,0 +1,156 @@
+#include "navigation.hpp"
+#include <gtest/gtest.h>
+
+using namespace geometry;
+using namespace geometry::navigation;
+
+TEST(VisibilityGraphTest, DirectPathWithoutObstacles) {
+    VisibilityGraph graph({});
+    auto path = graph.ShortestPath({0, 0}, {3, 4});
+    ASSERT_TRUE(path.has_value());
+    EXPECT_EQ(path->points.size(), 2);
+    EXPECT_DOUBLE_EQ(path->length, 5.0);
+}
+
+TEST(VisibilityGraphTest, AroundRectangle) {
+    std::vector<Shape> obstacles = {Rectangle{{-1, -1}, 2, 2}};
+    VisibilityGraph graph(obstacles);
+    EXPECT_EQ(graph.Vertices().size(), 4);
+
+    // Путь огибает прямоугольник через две его вершины
+    auto path = graph.ShortestPath({-3, 0}, {3, 0});
+    ASSERT_TRUE(path.has_value());
+    ASSERT_EQ(path->points.size(), 4);
+    EXPECT_NEAR(path->length, 2 * std::hypot(2.0, 1.0) + 2.0, 1e-9);
+}
+
+TEST(VisibilityGraphTest, ConcavePolygonSkipsReflexVertex) {
+    // «Уголок»: вершина (1, 1) вогнутая и в граф не попадает
+    std::vector<Shape> obstacles = {Polygon{std::vector<Point2D>{{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}}}};
+    VisibilityGraph graph(obstacles);
+    EXPECT_EQ(graph.Vertices().size(), 5);
+
+    EXPECT_FALSE(graph.IsVisible({2, 2}, {-1, -1}));
+    EXPECT_TRUE(graph.IsVisible({2, 2}, {4, 4}));
+    EXPECT_FALSE(graph.IsVisible({0, 0}, {4, 1}));  // диагональ через внутренность
+    EXPECT_TRUE(graph.IsVisible({4, 0}, {4, 1}));   // вдоль ребра
+
+    auto path = graph.ShortestPath({2, 2}, {-1, -1});
+    ASSERT_TRUE(path.has_value());
+    EXPECT_GT(path->length, std::hypot(3.0, 3.0));
+    for (size_t i = 1; i < path->points.size(); ++i) {
+        EXPECT_TRUE(graph.IsVisible(path->points[i - 1], path->points[i]));
+    }
+}
+
+TEST(VisibilityGraphTest, CircleAndWall) {
+    std::vector<Shape> obstacles = {Circle{{0, 0}, 1}, Line{{2, -5}, {2, 5}}};
+    VisibilityGraph graph(obstacles);
+
+    auto path = graph.ShortestPath({-3, 0}, {3, 0});
+    ASSERT_TRUE(path.has_value());
+    // Путь обходит стену через её конец
+    EXPECT_GT(path->length, 10.0);
+    for (const auto &p : path->points) {
+        EXPECT_GE(p.DistanceTo({0, 0}), 1.0 - 1e-9);
+    }
+}
+
+TEST(VisibilityGraphTest, Errors) {
+    std::vector<Shape> obstacles = {Rectangle{{0, 0}, 2, 2}, Rectangle{{-10, -10}, 20, 1}, Rectangle{{-10, 9}, 20, 1},
+                                    Rectangle{{-10, -10}, 1, 20}, Rectangle{{9, -10}, 1, 20}};
+    VisibilityGraph graph(obstacles);
+
+    auto inside = graph.ShortestPath({1, 1}, {5, 5});
+    ASSERT_FALSE(inside.has_value());
+    EXPECT_EQ(inside.error(), "Start point is inside an obstacle.");
+
+    auto enclosed = graph.ShortestPath({5, 5}, {20, 20});
+    ASSERT_FALSE(enclosed.has_value());
+    EXPECT_EQ(enclosed.error(), "Goal is unreachable.");
+}
+
+TEST(VisibilityGraphTest, RepeatedQueriesReuseGraph) {
+    std::vector<Shape> obstacles = {Rectangle{{-1, -1}, 2, 2}, Triangle{{3, -1}, {5, -1}, {4, 2}}};
+    VisibilityGraph graph(obstacles, 2);
+
+    auto first = graph.ShortestPath({-3, 0}, {7, 0});
+    auto second = graph.ShortestPath({-3, 0}, {7, 0});
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_DOUBLE_EQ(first->length, second->length);
+    EXPECT_EQ(first->points, second->points);
+}
+
+TEST(VisibilityGraphTest, PolygonWithHolesBlocksLikeItsOuterRing) {
+    const std::vector<Shape> obstacles = {
+        PolygonWithHoles{{{-1, -1}, {1, -1}, {1, 1}, {-1, 1}}, {{{-0.5, -0.5}, {-0.5, 0.5}, {0.5, 0.5}, {0.5, -0.5}}}}};
+    EXPECT_EQ(ObstacleOutlines(obstacles.front()).size(), 1);
+
+    VisibilityGraph graph(obstacles);
+    EXPECT_EQ(graph.Vertices().size(), 4);
+    auto path = graph.ShortestPath({-3, 0}, {3, 0});
+    ASSERT_TRUE(path.has_value());
+    EXPECT_NEAR(path->length, 2 * std::hypot(2.0, 1.0) + 2.0, 1e-9);
+}
+
+TEST(VisibilityGraphTest, InstancedObstaclesUseWorldOutlines) {
+    const auto prototype = std::make_shared<const PrototypeShape>(Rectangle{{-1, -1}, 2, 2});
+    const std::vector<Shape> obstacles = {InstancedShape(prototype, Transform2D::Make({0, 0})),
+                                          InstancedShape(prototype, Transform2D::Make({10, 0}, 0.0, 0.5))};
+    const auto outline = ObstacleOutlines(obstacles[1]);
+    ASSERT_EQ(outline.size(), 1);
+    EXPECT_EQ(outline.front().front(), (Point2D{9.5, -0.5}));
+
+    VisibilityGraph graph(obstacles);
+    EXPECT_EQ(graph.Vertices().size(), 8);
+    auto path = graph.ShortestPath({-3, 0}, {3, 0});
+    ASSERT_TRUE(path.has_value());
+    EXPECT_NEAR(path->length, 2 * std::hypot(2.0, 1.0) + 2.0, 1e-9);
+}
+
+TEST(VisibilityGraphTest, SweepMatchesDirectVisibility) {
+    // Наложенные препятствия, вершины на общих лучах и рёбра вдоль лучей — вырожденные случаи развёртки
+    const std::vector<Shape> obstacles = {Rectangle{{0, 0}, 4, 2},        Rectangle{{2, 1}, 4, 2},
+                                          Rectangle{{8, 0}, 2, 2},        Rectangle{{12, 0}, 2, 2},
+                                          Rectangle{{0, 6}, 2, 2},        Triangle{{4, 5}, {8, 5}, {6, 9}},
+                                          Line{{10, 4}, {14, 8}},         Line{{9, 8}, {14, 3}},
+                                          Circle{{16, 6}, 1}};
+    VisibilityGraph graph(obstacles);
+
+    // Кратчайший путь по полному графу видимости, построенному прямыми проверками IsVisible
+    const auto direct = [&](const Point2D &start, const Point2D &goal) {
+        std::vector<Point2D> nodes{start, goal};
+        nodes.insert(nodes.end(), graph.Vertices().begin(), graph.Vertices().end());
+        std::vector<double> cost(nodes.size(), std::numeric_limits<double>::infinity());
+        std::vector<bool> done(nodes.size(), false);
+        cost[0] = 0.0;
+        for (size_t step = 0; step < nodes.size(); ++step) {
+            size_t node = nodes.size();
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (!done[i] && (node == nodes.size() || cost[i] < cost[node])) {
+                    node = i;
+                }
+            }
+            done[node] = true;
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (!done[i] && graph.IsVisible(nodes[node], nodes[i])) {
+                    cost[i] = std::min(cost[i], cost[node] + nodes[node].DistanceTo(nodes[i]));
+                }
+            }
+        }
+        return cost[1];
+    };
+
+    const std::vector<Point2D> ends = {{-2, -2}, {-1, 1}, {7, 4}, {11, 1}, {15, 10}, {18, 0}, {3, 10}, {12, 5.5}};
+    for (const auto &start : ends) {
+        for (const auto &goal : ends) {
+            const auto path = graph.ShortestPath(start, goal);
+            ASSERT_TRUE(path.has_value());
+            EXPECT_NEAR(path->length, direct(start, goal), 1e-9);
+            for (size_t i = 1; i < path->points.size(); ++i) {
+                EXPECT_TRUE(graph.IsVisible(path->points[i - 1], path->points[i]));
+            }
+        }
+    }
+}
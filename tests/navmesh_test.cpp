@@ -0,0 +1,73 @@
+#include "navmesh.hpp"
+#include <gtest/gtest.h>
+
+using namespace geometry;
+using namespace geometry::navigation;
+
+namespace {
+
+// Каждый отрезок пути не должен проходить сквозь прямоугольное препятствие
+bool SegmentAvoidsRectangle(const Point2D &a, const Point2D &b, const Rectangle &rect) {
+    for (int i = 1; i < 100; ++i) {
+        const Point2D p = a + (b - a) * (i / 100.0);
+        const auto top_right = rect.TopRight();
+        if (p.x > rect.bottom_left.x + 1e-9 && p.x < top_right.x - 1e-9 && p.y > rect.bottom_left.y + 1e-9 &&
+            p.y < top_right.y - 1e-9) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(NavMeshTest, EmptyRegion) {
+    auto navmesh = NavMesh::Build({0, 0, 10, 0}, {});
+    ASSERT_FALSE(navmesh.has_value());
+    EXPECT_EQ(navmesh.error(), "Navigation region must have positive area.");
+}
+
+TEST(NavMeshTest, StraightLineInOpenSpace) {
+    auto navmesh = NavMesh::Build({0, 0, 10, 10}, {}, {.max_edge_length = 2.5});
+    ASSERT_TRUE(navmesh.has_value());
+
+    auto path = navmesh->FindPath({1, 1}, {9, 8});
+    ASSERT_TRUE(path.has_value());
+    EXPECT_EQ(path->points.size(), 2);
+    EXPECT_NEAR(path->length, std::hypot(8.0, 7.0), 1e-9);
+}
+
+TEST(NavMeshTest, PathAroundObstacle) {
+    const Rectangle wall{{4, 0}, 2, 8};
+    std::vector<Shape> obstacles = {wall};
+    auto navmesh = NavMesh::Build({0, 0, 10, 10}, obstacles, {.max_edge_length = 1.0});
+    ASSERT_TRUE(navmesh.has_value());
+
+    EXPECT_FALSE(navmesh->Locate({5, 4}).has_value());
+    EXPECT_TRUE(navmesh->Locate({2, 2}).has_value());
+
+    auto path = navmesh->FindPath({2, 2}, {8, 2});
+    ASSERT_TRUE(path.has_value());
+    // Путь поднимается над стеной: не короче огибания через её верхние углы
+    const double around = std::hypot(2.0, 6.0) * 2 + 2.0;
+    EXPECT_GE(path->length, around - 1e-9);
+    EXPECT_LT(path->length, around * 1.2);
+    for (size_t i = 1; i < path->points.size(); ++i) {
+        EXPECT_TRUE(SegmentAvoidsRectangle(path->points[i - 1], path->points[i], wall));
+    }
+
+    auto blocked = navmesh->FindPath({5, 4}, {8, 2});
+    ASSERT_FALSE(blocked.has_value());
+    EXPECT_EQ(blocked.error(), "Start point is outside the navigation mesh.");
+}
+
+TEST(NavMeshTest, UnreachableGoal) {
+    // Стена во всю высоту области делит её на две несвязные части
+    std::vector<Shape> obstacles = {Rectangle{{4, -1}, 2, 12}};
+    auto navmesh = NavMesh::Build({0, 0, 10, 10}, obstacles, {.max_edge_length = 1.0});
+    ASSERT_TRUE(navmesh.has_value());
+
+    auto path = navmesh->FindPath({2, 2}, {8, 2});
+    ASSERT_FALSE(path.has_value());
+    EXPECT_EQ(path.error(), "Goal is unreachable.");
+}
@@ -0,0 +1,95 @@
+#include "numa.hpp"
+#include "queries.hpp"
+#include "spatial_index.hpp"
+#include <gtest/gtest.h>
+#include <mutex>
+#include <numeric>
+
+using namespace geometry;
+using namespace geometry::numa;
+
+TEST(NumaTest, TopologyIsConsistent) {
+    ASSERT_GE(NodeCount(), 1u);
+    EXPECT_LT(CurrentNode(), NodeCount());
+    EXPECT_FALSE(NodeCpus(0).empty());
+    EXPECT_TRUE(NodeCpus(NodeCount()).empty());
+}
+
+TEST(NumaTest, NodeSlicesCoverRangeWithoutGaps) {
+    size_t next = 0;
+    for (size_t node = 0; node < NodeCount(); ++node) {
+        const auto [begin, end] = NodeSlice(1001, node);
+        EXPECT_EQ(begin, next);
+        next = end;
+    }
+    EXPECT_EQ(next, 1001u);
+    EXPECT_EQ(WorkerNode(0, 8), 0u);
+    EXPECT_LT(WorkerNode(7, 8), NodeCount());
+}
+
+TEST(NumaTest, PinToNode) {
+    EXPECT_FALSE(PinCurrentThreadToNode(NodeCount()));
+    std::jthread worker([] {
+        EXPECT_TRUE(PinCurrentThreadToNode(0));
+        EXPECT_TRUE(PinCurrentThreadToNode(0));
+        EXPECT_EQ(CurrentNode(), 0u);
+    });
+}
+
+TEST(NumaTest, VectorWorksWithEveryPlacement) {
+    for (auto placement : {Placement::Default, Placement::FirstTouch, Placement::Node, Placement::Interleave}) {
+        for (auto huge_pages : {HugePages::None, HugePages::Transparent, HugePages::Explicit}) {
+            NumaVector<BoundingBox> boxes(NumaAllocator<BoundingBox>({placement, 0, huge_pages}));
+            for (int i = 0; i < 100000; ++i) {
+                boxes.push_back({double(i), 0, double(i) + 1, 1});
+            }
+            ASSERT_EQ(boxes.size(), 100000u);
+            EXPECT_DOUBLE_EQ(boxes[54321].min_x, 54321.0);
+            EXPECT_DOUBLE_EQ(boxes.back().max_x, 100000.0);
+
+            auto copy = boxes;
+            EXPECT_EQ(copy.get_allocator(), boxes.get_allocator());
+            EXPECT_DOUBLE_EQ(copy[777].max_x, 778.0);
+        }
+    }
+}
+
+TEST(NumaTest, ShapeStoreOnInterleavedPages) {
+    NumaVector<Shape> shapes(NumaAllocator<Shape>({Placement::Interleave}));
+    for (int i = 0; i < 1000; ++i) {
+        shapes.emplace_back(Polygon({{double(i), 0}, {double(i) + 1, 0}, {double(i), 1}}));
+    }
+    NumaVector<BoundingBox> boxes(NumaAllocator<BoundingBox>({Placement::FirstTouch}));
+    for (const auto &shape : shapes) {
+        boxes.push_back(queries::GetBoundBox(shape));
+    }
+    const index::GridIndex grid(boxes);
+    EXPECT_EQ(grid.Query({9.8, 0.1, 10.3, 0.2}), (std::vector<size_t>{9, 10}));
+}
+
+TEST(NumaTest, ReplicasAreBuiltPerNode) {
+    std::vector<BoundingBox> boxes;
+    for (int i = 0; i < 100; ++i) {
+        boxes.push_back({i * 3.0 - 1, -1, i * 3.0 + 1, 1});
+    }
+    std::vector<size_t> built;
+    std::mutex mutex;
+    NodeReplicas<index::GridIndex> replicas([&](size_t node) {
+        std::lock_guard lock(mutex);
+        built.push_back(node);
+        return index::GridIndex(boxes);
+    });
+
+    ASSERT_EQ(replicas.Count(), NodeCount());
+    std::ranges::sort(built);
+    std::vector<size_t> expected(NodeCount());
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(built, expected);
+    EXPECT_EQ(replicas.Local().Query({29.5, -0.5, 30.5, 0.5}), std::vector<size_t>{10});
+    EXPECT_EQ(&replicas.OnNode(NodeCount() + 5), &replicas.OnNode(0));
+}
+
+TEST(NumaTest, ReplicaBuildErrorIsRethrown) {
+    auto failing = [](size_t) -> int { throw std::runtime_error("build failed"); };
+    EXPECT_THROW(NodeReplicas<int>{failing}, std::runtime_error);
+}
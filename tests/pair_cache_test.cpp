@@ -0,0 +1,125 @@
+#include "pair_cache.hpp"
+#include "queries.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::collision;
+
+namespace {
+
+std::vector<IndexPair> BruteForce(std::span<const Shape> shapes) {
+    std::vector<IndexPair> pairs;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        for (size_t j = i + 1; j < shapes.size(); ++j) {
+            if (queries::ShapesIntersect(shapes[i], shapes[j])) {
+                pairs.emplace_back(i, j);
+            }
+        }
+    }
+    return pairs;
+}
+
+PrototypeShape RandomPrototype(std::mt19937 &rng) {
+    std::uniform_real_distribution<double> size(0.5, 3.0);
+    switch (rng() % 4) {
+    case 0:
+        return Circle{{0, 0}, size(rng)};
+    case 1:
+        return Rectangle{{0, 0}, size(rng), size(rng)};
+    case 2:
+        return Triangle{{0, 0}, {size(rng), 0}, {0, size(rng)}};
+    default:
+        return Polygon{{{0, 0}, {size(rng), 0}, {1, 1}, {0, size(rng)}}};
+    }
+}
+
+}  // namespace
+
+TEST(PairCacheTest, MatchesBruteForceAcrossFrames) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> pos(0.0, 40.0);
+    std::uniform_real_distribution<double> step(-0.7, 0.7);
+
+    // Фигуры — экземпляры неподвижных прототипов, движение задаётся сдвигом
+    std::vector<std::shared_ptr<const PrototypeShape>> prototypes;
+    std::vector<Point2D> offsets;
+    std::vector<Shape> shapes;
+    for (int i = 0; i < 150; ++i) {
+        prototypes.push_back(std::make_shared<const PrototypeShape>(RandomPrototype(rng)));
+        offsets.emplace_back(pos(rng), pos(rng));
+        shapes.push_back(InstancedShape(prototypes.back(), Transform2D::Make(offsets.back())));
+    }
+
+    PairCache cache(PairCacheOptions{.threads = 2});
+    cache.Update(shapes, {});
+    EXPECT_EQ(cache.Collisions(), BruteForce(shapes));
+
+    size_t warm_started = 0;
+    for (int frame = 0; frame < 20; ++frame) {
+        std::vector<size_t> moved;
+        for (size_t i = 0; i < shapes.size(); i += 1 + rng() % 6) {
+            offsets[i] = offsets[i] + Point2D{step(rng), step(rng)};
+            shapes[i] = InstancedShape(prototypes[i], Transform2D::Make(offsets[i]));
+            moved.push_back(i);
+        }
+        warm_started += cache.Update(shapes, moved).warm_started;
+        ASSERT_EQ(cache.Collisions(), BruteForce(shapes)) << "frame " << frame;
+    }
+    EXPECT_GT(warm_started, 0);
+}
+
+TEST(PairCacheTest, UnchangedFramesSkipNarrowPhase) {
+    std::vector<Shape> shapes = {Circle{{0, 0}, 1}, Circle{{1.5, 0}, 1}, Rectangle{{10, 10}, 2, 2},
+                                 Rectangle{{12.5, 10}, 1, 1}};
+    PairCache cache;
+    const auto first = cache.Update(shapes, {});
+    EXPECT_EQ(first.pairs, 1);
+    EXPECT_EQ(first.narrow_phase, 1);
+    EXPECT_EQ(cache.Collisions(), (std::vector<IndexPair>{{0, 1}}));
+
+    const auto idle = cache.Update(shapes, {});
+    EXPECT_EQ(idle.pairs, 1);
+    EXPECT_EQ(idle.rechecked, 0);
+    EXPECT_EQ(idle.narrow_phase, 0);
+    EXPECT_EQ(cache.Collisions(), (std::vector<IndexPair>{{0, 1}}));
+}
+
+TEST(PairCacheTest, SmallMotionIsWarmStarted) {
+    // Пара 0–1 пересекается, пара 2–3 разделена, но их bounding box перекрываются
+    std::vector<Shape> shapes = {Circle{{0, 0}, 1}, Circle{{1.5, 0}, 1}, Circle{{10, 10}, 1},
+                                 Rectangle{{10.75, 10.75}, 1, 1}};
+    PairCache cache;
+    cache.Update(shapes, {});
+    EXPECT_EQ(cache.Collisions(), (std::vector<IndexPair>{{0, 1}}));
+
+    shapes[1] = Circle{{1.4, 0.1}, 1};
+    shapes[3] = Rectangle{{10.8, 10.8}, 1, 1};
+    const std::vector<size_t> moved = {1, 3};
+    const auto stats = cache.Update(shapes, moved);
+    EXPECT_EQ(stats.rechecked, 2);
+    EXPECT_EQ(stats.warm_started, 2);
+    EXPECT_EQ(stats.narrow_phase, 0);
+    EXPECT_EQ(cache.Collisions(), (std::vector<IndexPair>{{0, 1}}));
+
+    // Разошедшиеся фигуры теряют пару, сблизившиеся — получают
+    shapes[1] = Circle{{5, 0}, 1};
+    shapes[3] = Rectangle{{10.5, 10.5}, 1, 1};
+    const auto apart = cache.Update(shapes, moved);
+    EXPECT_EQ(apart.pairs, 1);
+    EXPECT_EQ(cache.Collisions(), (std::vector<IndexPair>{{2, 3}}));
+}
+
+TEST(PairCacheTest, ShapeCountChangeRebuilds) {
+    std::vector<Shape> shapes = {Circle{{0, 0}, 1}, Circle{{1, 0}, 1}};
+    PairCache cache;
+    cache.Update(shapes, {});
+    shapes.push_back(Line{{-5, 0}, {5, 0}});
+    cache.Update(shapes, {});
+    EXPECT_EQ(cache.Collisions(), BruteForce(shapes));
+    EXPECT_EQ(cache.PairCount(), 3);
+
+    cache.Clear();
+    EXPECT_EQ(cache.PairCount(), 0);
+    EXPECT_TRUE(cache.Collisions().empty());
+}
@@ -0,0 +1,194 @@
+#include "convex_hull.hpp"
+#include "planner.hpp"
+#include "queries.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <numbers>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::planner;
+
+namespace {
+
+std::vector<IndexPair> BruteForce(std::span<const Shape> shapes) {
+    std::vector<IndexPair> pairs;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        for (size_t j = i + 1; j < shapes.size(); ++j) {
+            if (queries::ShapesIntersect(shapes[i], shapes[j])) {
+                pairs.emplace_back(i, j);
+            }
+        }
+    }
+    return pairs;
+}
+
+std::vector<Shape> UniformCircles(size_t count, double extent, double radius, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coord(0.0, extent);
+    std::vector<Shape> shapes;
+    for (size_t i = 0; i < count; ++i) {
+        shapes.emplace_back(Circle({coord(rng), coord(rng)}, radius));
+    }
+    return shapes;
+}
+
+std::vector<BoundingBox> Boxes(std::span<const Shape> shapes) {
+    std::vector<BoundingBox> boxes;
+    for (const auto &shape : shapes) {
+        boxes.push_back(queries::GetBoundBox(shape));
+    }
+    return boxes;
+}
+
+std::vector<Point2D> SortedHull(std::vector<Point2D> hull) {
+    std::ranges::sort(hull, [](const Point2D &a, const Point2D &b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+    return hull;
+}
+
+}  // namespace
+
+TEST(PlannerTest, StatsDescribeSizesAndClustering) {
+    const auto uniform = Boxes(UniformCircles(4000, 1000.0, 1.0, 1));
+    const auto stats = CollectStats(uniform);
+    EXPECT_EQ(stats.count, 4000u);
+    EXPECT_LE(stats.sampled, 4000u);
+    EXPECT_DOUBLE_EQ(stats.median_size, 2.0);
+    EXPECT_DOUBLE_EQ(stats.SizeSkew(), 1.0);
+    EXPECT_LT(stats.clustering, 0.2);
+    EXPECT_EQ(stats.size_histogram[DataStats::HISTOGRAM_BINS / 2], stats.sampled);
+
+    // Те же объекты, стянутые в угол поля, плюс один далёкий — почти вся сетка пуста
+    auto clustered = uniform;
+    for (auto &box : clustered) {
+        box = {box.min_x / 50, box.min_y / 50, box.min_x / 50 + 2, box.min_y / 50 + 2};
+    }
+    clustered.back() = {1000, 1000, 1002, 1002};
+    EXPECT_GT(CollectStats(clustered).clustering, 0.9);
+    EXPECT_EQ(CollectStats({}).count, 0u);
+}
+
+TEST(PlannerTest, CollisionEngineFollowsData) {
+    const auto small = UniformCircles(100, 100.0, 1.0, 2);
+    EXPECT_EQ(PlanCollisions(Boxes(small)).engine, BroadPhase::BruteForce);
+
+    const auto uniform = UniformCircles(5000, 1000.0, 1.0, 3);
+    const auto grid_plan = PlanCollisions(Boxes(uniform));
+    EXPECT_EQ(grid_plan.engine, BroadPhase::HashGrid);
+    EXPECT_DOUBLE_EQ(grid_plan.cell_size, 4.0);
+
+    // Каждый пятый объект в двадцать раз крупнее остальных
+    auto skewed = uniform;
+    for (size_t i = 0; i < skewed.size(); i += 5) {
+        skewed[i] = Circle(std::get<Circle>(skewed[i]).center_p, 20.0);
+    }
+    const auto bvh_plan = PlanCollisions(Boxes(skewed), {.threads = 3});
+    EXPECT_EQ(bvh_plan.engine, BroadPhase::Bvh);
+    EXPECT_EQ(bvh_plan.leaf_size, 8u);
+    EXPECT_LE(bvh_plan.threads, 3u);
+    EXPECT_GT(bvh_plan.stats.SizeSkew(), 4.0);
+}
+
+TEST(PlannerTest, EveryEngineFindsSameCollisions) {
+    auto shapes = UniformCircles(600, 60.0, 1.0, 4);
+    shapes.emplace_back(Rectangle({10, 10}, 15, 3));
+    shapes.emplace_back(Polygon({{30, 30}, {40, 31}, {35, 38}}));
+    const auto expected = BruteForce(shapes);
+    ASSERT_FALSE(expected.empty());
+
+    for (auto engine : {BroadPhase::BruteForce, BroadPhase::HashGrid, BroadPhase::Bvh}) {
+        CollisionPlan plan;
+        plan.engine = engine;
+        plan.cell_size = 3.0;
+        plan.threads = 4;
+        EXPECT_EQ(FindCollisions(shapes, plan), expected) << ToString(engine);
+    }
+
+    CollisionPlan chosen;
+    EXPECT_EQ(FindCollisions(shapes, &chosen), expected);
+    EXPECT_EQ(chosen.stats.count, shapes.size());
+    EXPECT_FALSE(chosen.reason.empty());
+}
+
+TEST(PlannerTest, JoinPlanMatchesDirectJoin) {
+    const auto a = UniformCircles(3000, 500.0, 1.0, 5);
+    const auto b = UniformCircles(2500, 500.0, 1.5, 6);
+    const auto plan = PlanJoin(Boxes(a), Boxes(b), true);
+    EXPECT_EQ(plan.options.strategy, join::JoinStrategy::Partition);
+    EXPECT_TRUE(plan.options.exact);
+
+    const auto few = UniformCircles(50, 500.0, 1.0, 7);
+    EXPECT_EQ(PlanJoin(Boxes(few), Boxes(b)).options.strategy, join::JoinStrategy::IndexNestedLoop);
+
+    JoinPlan chosen;
+    const auto pairs = SpatialJoin(a, b, true, &chosen);
+    EXPECT_EQ(pairs, join::SpatialJoin(a, b, {.exact = true}));
+    EXPECT_EQ(chosen.options.strategy, plan.options.strategy);
+}
+
+TEST(PlannerTest, HullAlgorithmFollowsData) {
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<double> coord(-100.0, 100.0);
+    std::vector<Point2D> square(200000);
+    for (auto &p : square) {
+        p = {coord(rng), coord(rng)};
+    }
+    const auto plan = PlanHull(square, {.threads = 4});
+    EXPECT_NE(plan.algorithm, HullAlgorithm::GrahamScan);
+    EXPECT_LT(plan.filter_survivors, 0.2);
+    EXPECT_EQ(PlanHull(square, {.threads = 1}).algorithm, HullAlgorithm::AklToussaint);
+
+    // Точки на окружности: отсев ничего не отбрасывает
+    std::vector<Point2D> circle(5000);
+    for (size_t i = 0; i < circle.size(); ++i) {
+        const double a = 2 * std::numbers::pi * static_cast<double>(i) / static_cast<double>(circle.size());
+        circle[i] = {std::cos(a), std::sin(a)};
+    }
+    EXPECT_EQ(PlanHull(circle).algorithm, HullAlgorithm::GrahamScan);
+    EXPECT_EQ(PlanHull(std::span(circle).first(100)).algorithm, HullAlgorithm::GrahamScan);
+}
+
+TEST(PlannerTest, EveryHullAlgorithmGivesSameHull) {
+    std::mt19937 rng(9);
+    std::normal_distribution<double> coord(0.0, 10.0);
+    std::vector<Point2D> points(50000);
+    for (auto &p : points) {
+        p = {coord(rng), coord(rng)};
+    }
+    auto copy = points;
+    const auto expected = SortedHull(convex_hull::GrahamScan(copy).value());
+
+    for (auto algorithm : {HullAlgorithm::GrahamScan, HullAlgorithm::AklToussaint, HullAlgorithm::ParallelChunks}) {
+        HullPlan plan;
+        plan.algorithm = algorithm;
+        plan.threads = 4;
+        const auto hull = ConvexHull(points, plan);
+        ASSERT_TRUE(hull.has_value()) << ToString(algorithm);
+        EXPECT_EQ(SortedHull(*hull), expected) << ToString(algorithm);
+    }
+    EXPECT_FALSE(ConvexHull(std::span(points).first(2)).has_value());
+}
+
+TEST(FormatterTest, PlannerPlans) {
+    CollisionPlan collision;
+    collision.engine = BroadPhase::HashGrid;
+    collision.cell_size = 4.0;
+    collision.threads = 2;
+    collision.stats.count = 5000;
+    collision.reason = "uniform";
+    EXPECT_EQ(std::format("{}", collision),
+              "CollisionPlan(engine=hash-grid, cell=4, leaf=0, threads=2, n=5000: uniform)");
+
+    JoinPlan join;
+    join.options.strategy = join::JoinStrategy::Partition;
+    join.options.threads = 1;
+    join.a_stats.count = 3;
+    join.b_stats.count = 4;
+    join.reason = "small";
+    EXPECT_EQ(std::format("{}", join), "JoinPlan(strategy=partition, threads=1, n=3x4: small)");
+
+    HullPlan hull;
+    hull.count = 10;
+    hull.reason = "tiny";
+    EXPECT_EQ(std::format("{}", hull), "HullPlan(algorithm=graham-scan, threads=1, n=10, survivors=1.00: tiny)");
+}
@@ -0,0 +1,155 @@
+#include "point_location.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::triangulation;
+
+namespace {
+
+bool Contains(const Triangle &t, const Point2D &p) {
+    constexpr double TOLERANCE = 1e-12;
+    return (t.b - t.a).Cross(p - t.a) >= -TOLERANCE && (t.c - t.b).Cross(p - t.b) >= -TOLERANCE &&
+           (t.a - t.c).Cross(p - t.c) >= -TOLERANCE;
+}
+
+// Эталон: есть ли вообще треугольник, содержащий точку
+bool Covered(const TriangleMesh &mesh, const Point2D &p) {
+    for (size_t t = 0; t < mesh.Size(); ++t) {
+        if (Contains(mesh.GetTriangle(t), p)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TriangleMesh RandomMesh(size_t count) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+    std::vector<Point2D> points = {{0, 0}, {100, 0}, {100, 100}, {0, 100}};
+    for (size_t i = 0; i < count; ++i) {
+        points.emplace_back(coord(rng), coord(rng));
+    }
+    return BuildMesh(DelaunayTriangulation(points).value());
+}
+
+}  // namespace
+
+TEST(PointLocationTest, ConvexGridMesh) {
+    constexpr size_t SIDE = 20;
+    std::vector<Point2D> vertices;
+    for (size_t y = 0; y <= SIDE; ++y) {
+        for (size_t x = 0; x <= SIDE; ++x) {
+            vertices.emplace_back(static_cast<double>(x), static_cast<double>(y));
+        }
+    }
+    std::vector<std::array<size_t, 3>> triangles;
+    for (size_t y = 0; y < SIDE; ++y) {
+        for (size_t x = 0; x < SIDE; ++x) {
+            const size_t v = y * (SIDE + 1) + x;
+            triangles.push_back({v, v + 1, v + SIDE + 2});
+            triangles.push_back({v, v + SIDE + 2, v + SIDE + 1});
+        }
+    }
+    const auto mesh = BuildMesh(vertices, triangles);
+    PointLocator locator(mesh);
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> coord(-1.0, SIDE + 1.0);
+    std::vector<Point2D> queries(2000);
+    for (auto &p : queries) {
+        p = {coord(rng), coord(rng)};
+    }
+    const auto batch = locator.LocateAll(queries);
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const bool inside = queries[i].x >= 0 && queries[i].x <= SIDE && queries[i].y >= 0 && queries[i].y <= SIDE;
+        ASSERT_EQ(batch[i].has_value(), inside);
+        if (inside) {
+            EXPECT_TRUE(Contains(mesh.GetTriangle(*batch[i]), queries[i]));
+        }
+    }
+}
+
+TEST(PointLocationTest, EmptyMesh) {
+    TriangleMesh mesh;
+    PointLocator locator(mesh);
+    EXPECT_FALSE(locator.Locate({0, 0}).has_value());
+    EXPECT_EQ(locator.LocateAll(std::vector<Point2D>{{1, 1}}).front(), std::nullopt);
+}
+
+TEST(PointLocationTest, LocateMatchesContainment) {
+    const auto mesh = RandomMesh(300);
+    PointLocator locator(mesh);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+    for (int i = 0; i < 500; ++i) {
+        const Point2D p{coord(rng), coord(rng)};
+        const auto t = locator.Locate(p);
+        ASSERT_EQ(t.has_value(), Covered(mesh, p));
+        if (t) {
+            EXPECT_TRUE(Contains(mesh.GetTriangle(*t), p));
+        }
+    }
+
+    // Вершина сетки лежит на границе своих треугольников
+    const auto vertex = locator.Locate(mesh.vertices[5]);
+    ASSERT_TRUE(vertex.has_value());
+    EXPECT_TRUE(Contains(mesh.GetTriangle(*vertex), mesh.vertices[5]));
+
+    EXPECT_FALSE(locator.Locate({-1, 50}).has_value());
+    EXPECT_FALSE(locator.Locate({50, 100.5}).has_value());
+}
+
+TEST(PointLocationTest, LocateAllMatchesSingleQueries) {
+    const auto mesh = RandomMesh(1000);
+    PointLocator locator(mesh);
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> coord(-10.0, 110.0);
+    std::vector<Point2D> queries(5000);
+    for (auto &p : queries) {
+        p = {coord(rng), coord(rng)};
+    }
+
+    const auto batch = locator.LocateAll(queries, 4);
+    ASSERT_EQ(batch.size(), queries.size());
+    for (size_t i = 0; i < queries.size(); ++i) {
+        ASSERT_EQ(batch[i].has_value(), Covered(mesh, queries[i]));
+        if (batch[i]) {
+            EXPECT_TRUE(Contains(mesh.GetTriangle(*batch[i]), queries[i]));
+        }
+    }
+}
+
+TEST(PointLocationTest, NonConvexMeshWithHole) {
+    // Квадрат 3x3 из ячеек без центральной: обход упирается в дыру и должен её обойти
+    std::vector<Point2D> vertices;
+    for (int y = 0; y <= 3; ++y) {
+        for (int x = 0; x <= 3; ++x) {
+            vertices.emplace_back(x, y);
+        }
+    }
+    std::vector<std::array<size_t, 3>> triangles;
+    for (size_t y = 0; y < 3; ++y) {
+        for (size_t x = 0; x < 3; ++x) {
+            if (x == 1 && y == 1) {
+                continue;
+            }
+            const size_t v = y * 4 + x;
+            triangles.push_back({v, v + 1, v + 5});
+            triangles.push_back({v, v + 5, v + 4});
+        }
+    }
+    const auto mesh = BuildMesh(vertices, triangles);
+    PointLocator locator(mesh);
+
+    EXPECT_FALSE(locator.Locate({1.5, 1.5}).has_value());
+    for (const Point2D p : {Point2D{0.5, 0.5}, Point2D{2.5, 2.5}, Point2D{0.5, 2.5}, Point2D{2.5, 1.5}}) {
+        for (size_t hint = 0; hint < mesh.Size(); ++hint) {
+            const auto t = locator.Locate(p, hint);
+            ASSERT_TRUE(t.has_value());
+            EXPECT_TRUE(Contains(mesh.GetTriangle(*t), p));
+        }
+    }
+}
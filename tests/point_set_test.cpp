@@ -0,0 +1,88 @@
+#include "point_set.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+#include <set>
+#include <unordered_set>
+
+using namespace geometry;
+using namespace geometry::point_set;
+
+TEST(PointSetTest, RemoveDuplicates_KeepsFirstOccurrenceOrder) {
+    std::vector<Point2D> points = {{1, 1}, {0, 0}, {1, 1}, {2, 0}, {0, 0}};
+    auto unique = RemoveDuplicates(points);
+    EXPECT_EQ(unique, (std::vector<Point2D>{{1, 1}, {0, 0}, {2, 0}}));
+}
+
+TEST(PointSetTest, RemoveDuplicates_NegativeZero) {
+    std::vector<Point2D> points = {{0.0, 0.0}, {-0.0, -0.0}};
+    EXPECT_EQ(RemoveDuplicates(points).size(), 1);
+}
+
+TEST(PointSetTest, WeldVertices_MergesNearPoints) {
+    std::vector<Point2D> points = {{0, 0}, {1e-7, -1e-7}, {1, 0}, {1 + 5e-7, 0}, {0, 1}};
+    auto welded = WeldVertices(points, 1e-6);
+
+    ASSERT_EQ(welded.points.size(), 3);
+    EXPECT_EQ(welded.remap, (std::vector<size_t>{0, 0, 1, 1, 2}));
+    EXPECT_EQ(welded.points[1], Point2D(1, 0));
+}
+
+TEST(PointSetTest, WeldVertices_AcrossCellBorder) {
+    // Точки по разные стороны границы ячейки сетки всё равно должны свариться
+    std::vector<Point2D> points = {{0.99, 0.0}, {1.01, 0.0}};
+    auto welded = WeldVertices(points, 0.1);
+    EXPECT_EQ(welded.points.size(), 1);
+}
+
+TEST(PointSetTest, WeldVertices_KeepsDistantPoints) {
+    std::vector<Point2D> points = {{0, 0}, {0.5, 0}, {1.0, 0}};
+    auto welded = WeldVertices(points, 0.1);
+    EXPECT_EQ(welded.points.size(), 3);
+}
+
+TEST(PointSetTest, WeldVertices_ZeroToleranceIsExactDedup) {
+    std::vector<Point2D> points = {{0, 0}, {1e-12, 0}, {0, 0}};
+    auto welded = WeldVertices(points, 0.0);
+    ASSERT_EQ(welded.points.size(), 2);
+    EXPECT_EQ(welded.remap, (std::vector<size_t>{0, 1, 0}));
+}
+
+TEST(PointSetTest, WeldVertices_Empty) {
+    auto welded = WeldVertices({}, 1e-6);
+    EXPECT_TRUE(welded.points.empty());
+    EXPECT_TRUE(welded.remap.empty());
+}
+
+TEST(PointSetTest, WeldVertices_HugeAndNonFiniteCoordinates) {
+    // При 1e12 / 1e-9 номер ячейки не умещается в int64_t, а соседние double различаются сильнее допуска
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<Point2D> points = {{1e12, 1e12}, {1e12, 1e12}, {std::nextafter(1e12, 2e12), 1e12},
+                                   {1e12, 0},    {1e12, 5e-10}, {-1e12, -1e12},
+                                   {inf, 0},     {inf, 0},     {nan, 0}};
+    auto welded = WeldVertices(points, 1e-9);
+    ASSERT_EQ(welded.points.size(), 6);
+    EXPECT_EQ(welded.remap, (std::vector<size_t>{0, 0, 1, 2, 2, 3, 4, 4, 5}));
+}
+
+TEST(PointSetTest, HilbertOrder_IsPermutationFollowingCurve) {
+    // Решётка 4x4 в порядке кривой Гильберта второго порядка
+    std::vector<Point2D> points;
+    for (int y = 0; y < 4; ++y) {
+        for (int x = 0; x < 4; ++x) {
+            points.emplace_back(x, y);
+        }
+    }
+    const auto order = HilbertOrder(points);
+    ASSERT_EQ(order.size(), points.size());
+    EXPECT_EQ(std::set<size_t>(order.begin(), order.end()).size(), points.size());
+
+    // Соседние по кривой точки — соседи по решётке
+    for (size_t i = 1; i < order.size(); ++i) {
+        EXPECT_DOUBLE_EQ(points[order[i - 1]].DistanceTo(points[order[i]]), 1.0);
+    }
+    EXPECT_EQ(points[order.front()], Point2D(0, 0));
+    EXPECT_EQ(points[order.back()], Point2D(3, 0));
+    EXPECT_TRUE(HilbertOrder({}).empty());
+}
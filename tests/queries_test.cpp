@@ -105,6 +105,55 @@ TEST(QueriesTest, DistanceBetweenShapes_Unsupported) {
     EXPECT_FALSE(dist.has_value());  // не поддерживается
 }
 
+TEST(QueriesTest, PointInShape_Polygon) {
+    // Невыпуклый «уголок»
+    Polygon poly{std::vector<Point2D>{{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}}};
+    Point2D in_vertical{0.5, 3};
+    Point2D in_horizontal{3, 0.5};
+    Point2D in_notch{3, 3};
+    Point2D outside{5, 0.5};
+
+    EXPECT_TRUE(PointInShapeVisitor{in_vertical}(poly));
+    EXPECT_TRUE(PointInShapeVisitor{in_horizontal}(poly));
+    EXPECT_FALSE(PointInShapeVisitor{in_notch}(poly));
+    EXPECT_FALSE(PointInShapeVisitor{outside}(poly));
+}
+
+TEST(QueriesTest, ShapesIntersect) {
+    Circle circle{{0, 0}, 1};
+    EXPECT_TRUE(ShapesIntersect(circle, Circle{{1.5, 0}, 1}));
+    EXPECT_FALSE(ShapesIntersect(circle, Rectangle{{0.9, 0.9}, 1, 1}));  // пересекаются только bounding box
+    EXPECT_TRUE(ShapesIntersect(circle, Rectangle{{-5, -5}, 10, 10}));   // круг внутри прямоугольника
+    EXPECT_TRUE(ShapesIntersect(Line{{-2, 0.5}, {2, 0.5}}, circle));
+
+    Triangle tri{{0, 0}, {4, 0}, {0, 4}};
+    EXPECT_TRUE(ShapesIntersect(tri, Rectangle{{0.5, 0.5}, 0.5, 0.5}));  // прямоугольник внутри треугольника
+    EXPECT_FALSE(ShapesIntersect(tri, Rectangle{{3, 3}, 1, 1}));
+    EXPECT_TRUE(ShapesIntersect(tri, Line{{2, 2}, {5, 5}}));              // касание в вершине отрезка
+    EXPECT_FALSE(ShapesIntersect(Line{{0, 0}, {1, 0}}, Line{{0, 1}, {1, 1}}));
+
+    Polygon corner{std::vector<Point2D>{{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}}};
+    EXPECT_FALSE(ShapesIntersect(corner, Circle{{3, 3}, 1}));
+    EXPECT_TRUE(ShapesIntersect(corner, Circle{{3, 3}, 2.1}));
+}
+
+TEST(QueriesTest, ExactDistanceBetweenShapes) {
+    Circle circle{{0, 0}, 1};
+    EXPECT_DOUBLE_EQ(ExactDistanceBetweenShapes(circle, Circle{{3, 0}, 1}), 1.0);
+    EXPECT_DOUBLE_EQ(ExactDistanceBetweenShapes(circle, Rectangle{{2, -1}, 1, 2}), 1.0);
+    EXPECT_DOUBLE_EQ(ExactDistanceBetweenShapes(Rectangle{{-5, -5}, 10, 10}, circle), 0.0);
+
+    Triangle tri{{0, 0}, {2, 0}, {0, 2}};
+    EXPECT_NEAR(ExactDistanceBetweenShapes(tri, Rectangle{{2, 2}, 1, 1}), std::sqrt(2.0), 1e-12);
+    EXPECT_DOUBLE_EQ(ExactDistanceBetweenShapes(tri, Line{{-1, 1}, {3, 1}}), 0.0);
+    EXPECT_DOUBLE_EQ(ExactDistanceBetweenShapes(Line{{0, 0}, {0, 1}}, Line{{2, -5}, {2, 5}}), 2.0);
+}
+
+TEST(QueriesTest, BoundingBoxDistance) {
+    EXPECT_DOUBLE_EQ(BoundingBoxDistance({0, 0, 1, 1}, {4, 5, 6, 6}), 5.0);
+    EXPECT_DOUBLE_EQ(BoundingBoxDistance({0, 0, 1, 1}, {0.5, 0.5, 2, 2}), 0.0);
+}
+
 // ========================================================
 // constexpr тесты
 // ========================================================
@@ -148,3 +197,119 @@ TEST(QueriesConstexprTest, BoundingBoxesOverlap) {
 
 // Попытка использовать DistanceToPoint в constexpr — не скомпилируется
 // static_assert(DistanceToPoint(Circle{{0, 0}, 1}, {2, 0}) == 1.0);  // ОШИБКА
+
+// ----------------------------
+// Многоугольники с дырами
+// ----------------------------
+
+namespace {
+
+Shape FrameShape() {
+    return PolygonWithHoles{{{0, 0}, {10, 0}, {10, 10}, {0, 10}}, {{{2, 2}, {2, 8}, {8, 8}, {8, 2}}}};
+}
+
+}  // namespace
+
+TEST(QueriesRingsTest, PointInShapeRespectsHoles) {
+    const Shape frame = FrameShape();
+
+    EXPECT_TRUE(std::visit(PointInShapeVisitor{{1, 5}}, frame));
+    EXPECT_FALSE(std::visit(PointInShapeVisitor{{5, 5}}, frame));
+}
+
+TEST(QueriesRingsTest, DistanceToPointMeasuresAllRings) {
+    const Shape frame = FrameShape();
+
+    EXPECT_DOUBLE_EQ(DistanceToPoint(frame, {5, 5}), 3.0);
+    EXPECT_DOUBLE_EQ(DistanceToPoint(frame, {5, 12}), 2.0);
+}
+
+TEST(QueriesRingsTest, ShapeInsideHoleDoesNotIntersect) {
+    const Shape frame = FrameShape();
+    const Shape inside_hole = Rectangle{{4, 4}, 2, 2};
+    const Shape across_ring = Rectangle{{7, 4}, 2, 2};
+    const Shape in_material = Circle{{1, 1}, 0.5};
+
+    EXPECT_FALSE(ShapesIntersect(frame, inside_hole));
+    EXPECT_FALSE(ShapesIntersect(inside_hole, frame));
+    EXPECT_DOUBLE_EQ(ExactDistanceBetweenShapes(frame, inside_hole), 2.0);
+
+    EXPECT_TRUE(ShapesIntersect(frame, across_ring));
+    EXPECT_TRUE(ShapesIntersect(in_material, frame));
+    EXPECT_DOUBLE_EQ(ExactDistanceBetweenShapes(frame, across_ring), 0.0);
+}
+
+TEST(QueriesRingsTest, CircleInHoleAndMultiPolygon) {
+    const Shape frame = FrameShape();
+    EXPECT_FALSE(ShapesIntersect(frame, Shape{Circle{{5, 5}, 2.5}}));
+    EXPECT_TRUE(ShapesIntersect(frame, Shape{Circle{{5, 5}, 3.5}}));
+    EXPECT_DOUBLE_EQ(ExactDistanceBetweenShapes(frame, Shape{Circle{{5, 5}, 1}}), 2.0);
+
+    const Shape multi = MultiPolygon{{PolygonWithHoles{{{0, 0}, {1, 0}, {1, 1}, {0, 1}}},
+                                      PolygonWithHoles{{{5, 0}, {6, 0}, {6, 1}, {5, 1}}}}};
+    const Shape between = Line{{2, 0.5}, {4, 0.5}};
+    EXPECT_FALSE(ShapesIntersect(multi, between));
+    EXPECT_DOUBLE_EQ(ExactDistanceBetweenShapes(multi, between), 1.0);
+    EXPECT_TRUE(ShapesIntersect(multi, Shape{Line{{0.5, 0.5}, {5.5, 0.5}}}));
+}
+
+TEST(QueriesRingsTest, LaterPartInsideOtherShape) {
+    // Вторая часть целиком внутри прямоугольника, первая далеко от него: границы не пересекаются
+    const Shape multi = MultiPolygon{{PolygonWithHoles{{{0, 0}, {1, 0}, {1, 1}, {0, 1}}},
+                                      PolygonWithHoles{{{10, 10}, {11, 10}, {11, 11}, {10, 11}}}}};
+    const Shape cover = Rectangle{{9.5, 9.5}, 2, 2};
+    EXPECT_TRUE(ShapesIntersect(multi, cover));
+    EXPECT_TRUE(ShapesIntersect(cover, multi));
+    EXPECT_DOUBLE_EQ(ExactDistanceBetweenShapes(multi, cover), 0.0);
+
+    // Прямоугольник внутри второй части
+    const Shape inner = Rectangle{{10.25, 10.25}, 0.5, 0.5};
+    EXPECT_TRUE(ShapesIntersect(multi, inner));
+    EXPECT_DOUBLE_EQ(ExactDistanceBetweenShapes(inner, multi), 0.0);
+}
+
+// ----------------------------
+// Экземпляры фигур
+// ----------------------------
+
+namespace {
+
+const auto L_PROTOTYPE =
+    std::make_shared<const PrototypeShape>(Polygon{{{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}}});
+
+}  // namespace
+
+TEST(QueriesInstancedTest, MatchesMaterializedShape) {
+    const InstancedShape instance(L_PROTOTYPE, Transform2D::Make({10, 5}, std::numbers::pi / 6, 1.5));
+    const Shape instanced = instance;
+    const Shape materialized = Polygon{instance.Vertices()};
+
+    for (const Point2D p : {Point2D{10.5, 6}, Point2D{12, 9}, Point2D{14, 6}, Point2D{8, 4}}) {
+        EXPECT_EQ(std::visit(PointInShapeVisitor{p}, instanced), std::visit(PointInShapeVisitor{p}, materialized));
+        EXPECT_NEAR(DistanceToPoint(instanced, p), DistanceToPoint(materialized, p), 1e-9);
+    }
+
+    const std::vector<Shape> others = {Circle{{13, 9}, 0.5}, Rectangle{{9, 4}, 1, 1}, Line{{20, 0}, {20, 20}},
+                                       Triangle{{11, 6}, {11.2, 6}, {11, 6.2}}};
+    for (const auto &other : others) {
+        EXPECT_EQ(ShapesIntersect(instanced, other), ShapesIntersect(materialized, other));
+        EXPECT_EQ(ShapesIntersect(other, instanced), ShapesIntersect(other, materialized));
+        const double expected = ExactDistanceBetweenShapes(materialized, other);
+        EXPECT_NEAR(ExactDistanceBetweenShapes(instanced, other), expected, 1e-9);
+        EXPECT_NEAR(ExactDistanceBetweenShapes(other, instanced), expected, 1e-9);
+    }
+}
+
+TEST(QueriesInstancedTest, InstanceAgainstInstance) {
+    const Shape a = InstancedShape(L_PROTOTYPE, Transform2D::Make({0, 0}));
+    const Shape b = InstancedShape(L_PROTOTYPE, Transform2D::Make({3.5, 3.5}, std::numbers::pi, 0.5));
+    const Shape far = InstancedShape(L_PROTOTYPE, Transform2D::Make({10, 0}, 0.0, 2.0));
+
+    // b — уменьшенная и развёрнутая «Г» в свободном углу a, в 0.5 от обеих её ножек
+    EXPECT_FALSE(ShapesIntersect(a, b));
+    EXPECT_NEAR(ExactDistanceBetweenShapes(a, b), 0.5, 1e-9);
+    EXPECT_FALSE(ShapesIntersect(a, far));
+    EXPECT_NEAR(ExactDistanceBetweenShapes(a, far), 6.0, 1e-9);
+    EXPECT_NEAR(ExactDistanceBetweenShapes(far, a), 6.0, 1e-9);
+    EXPECT_TRUE(ShapesIntersect(a, Shape{InstancedShape(L_PROTOTYPE, Transform2D::Make({0.5, 0.5}))}));
+}
@@ -0,0 +1,130 @@
+#include "retained_renderer.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::visualization;
+
+namespace {
+
+const RenderOptions OPTIONS{.view = {0, 0, 100, 100}, .width = 200, .height = 200, .tile_size = 16};
+
+Shape RandomShape(std::mt19937 &rng) {
+    std::uniform_real_distribution<double> coord(-10.0, 110.0);
+    std::uniform_real_distribution<double> size(0.5, 12.0);
+    const Point2D p{coord(rng), coord(rng)};
+    switch (rng() % 5) {
+    case 0:
+        return Circle(p, size(rng));
+    case 1:
+        return Rectangle(p, size(rng), size(rng));
+    case 2:
+        return Line(p, {coord(rng), coord(rng)});
+    case 3:
+        return Triangle(p, p + Point2D{size(rng), 0}, p + Point2D{0, size(rng)});
+    default:
+        return PolygonWithHoles({p, p + Point2D{8, 0}, p + Point2D{8, 8}, p + Point2D{0, 8}},
+                                {{p + Point2D{2, 2}, p + Point2D{2, 5}, p + Point2D{5, 5}}});
+    }
+}
+
+size_t PaintedPixels(const Image &image, Rgb background) {
+    return static_cast<size_t>(std::ranges::count_if(image.pixels, [&](Rgb p) { return p != background; }));
+}
+
+}  // namespace
+
+TEST(RetainedRendererTest, IncrementalFrameMatchesFullRender) {
+    std::mt19937 rng(1);
+    std::vector<Shape> shapes;
+    for (int i = 0; i < 200; ++i) {
+        shapes.push_back(RandomShape(rng));
+    }
+
+    RetainedRenderer incremental({.view = OPTIONS.view, .width = 200, .height = 200, .tile_size = 16, .threads = 4});
+    for (const auto &shape : shapes) {
+        incremental.Add(shape);
+    }
+    incremental.Render();
+
+    const std::vector<size_t> removed{5, 60, 61};
+    for (int frame = 0; frame < 5; ++frame) {
+        for (int edit = 0; edit < 8; ++edit) {
+            const size_t id = rng() % shapes.size();
+            if (std::ranges::find(removed, id) == removed.end()) {
+                shapes[id] = RandomShape(rng);
+                incremental.Update(id, shapes[id]);
+            }
+        }
+        incremental.Render();
+    }
+    for (size_t id : removed) {
+        incremental.Remove(id);
+    }
+    shapes.push_back(RandomShape(rng));
+    incremental.Add(shapes.back());
+    incremental.Render();
+
+    RetainedRenderer full(OPTIONS);
+    for (const auto &shape : shapes) {
+        full.Add(shape);
+    }
+    for (size_t id : removed) {
+        full.Remove(id);
+    }
+    full.Render();
+    EXPECT_EQ(incremental.Frame(), full.Frame());
+}
+
+TEST(RetainedRendererTest, EditRedrawsOnlyDamagedRegion) {
+    RetainedRenderer renderer(OPTIONS);
+    const size_t moving = renderer.Add(Circle({20, 20}, 5));
+    renderer.Add(Rectangle({70, 70}, 10, 10));
+    const auto first = renderer.Render();
+    EXPECT_EQ(first.shapes, 2u);
+    const Image before = renderer.Frame();
+
+    renderer.Update(moving, Circle({22, 20}, 5));
+    EXPECT_TRUE(renderer.HasDamage());
+    const auto stats = renderer.Render();
+    EXPECT_FALSE(renderer.HasDamage());
+    // Старое и новое положение перекрываются и сливаются в один прямоугольник
+    EXPECT_EQ(stats.regions, 1u);
+    EXPECT_EQ(stats.shapes, 1u);
+    EXPECT_LT(stats.pixels, 200u * 200u / 20);
+
+    // Прямоугольник в другом углу не тронут
+    for (size_t y = 30; y < 70; ++y) {
+        for (size_t x = 130; x < 170; ++x) {
+            EXPECT_EQ(renderer.Frame().At(x, y), before.At(x, y));
+        }
+    }
+    EXPECT_NE(renderer.Frame(), before);
+
+    const auto idle = renderer.Render();
+    EXPECT_EQ(idle.regions, 0u);
+    EXPECT_EQ(idle.pixels, 0u);
+}
+
+TEST(RetainedRendererTest, RemoveAndInvalidate) {
+    RetainedRenderer renderer(OPTIONS);
+    const size_t line = renderer.Add(Line({10, 50}, {90, 50}));
+    renderer.Add(Circle({500, 500}, 10));  // Вне кадра
+    const auto stats = renderer.Render();
+    EXPECT_EQ(stats.shapes, 1u);
+    const size_t painted = PaintedPixels(renderer.Frame(), OPTIONS.background);
+    // Горизонтальная линия толщиной 2 пикселя длиной 160 пикселей
+    EXPECT_GE(painted, 2u * 160);
+    EXPECT_LE(painted, 2u * 162);
+    EXPECT_EQ(renderer.Frame().At(100, 100), (Rgb{255, 255, 0}));
+
+    const Image before = renderer.Frame();
+    renderer.InvalidateAll();
+    EXPECT_EQ(renderer.Render().pixels, 200u * 200u);
+    EXPECT_EQ(renderer.Frame(), before);
+
+    renderer.Remove(line);
+    renderer.Render();
+    EXPECT_EQ(PaintedPixels(renderer.Frame(), OPTIONS.background), 0u);
+    EXPECT_THROW(renderer.Remove(7), std::out_of_range);
+}
@@ -0,0 +1,152 @@
+#include "queries.hpp"
+#include "sampling.hpp"
+#include <gtest/gtest.h>
+
+using namespace geometry;
+using namespace geometry::sampling;
+
+namespace {
+
+// Квадрат 10 × 10 с квадратной дырой 4 × 4 в центре
+const PolygonWithHoles FRAME({{0, 0}, {10, 0}, {10, 10}, {0, 10}}, {{{3, 3}, {3, 7}, {7, 7}, {7, 3}}});
+
+bool Inside(const Shape &shape, const Point2D &p) { return std::visit(queries::PointInShapeVisitor{p}, shape); }
+
+}  // namespace
+
+TEST(SamplingTest, AliasTableFollowsWeights) {
+    const std::vector<double> weights{1, 0, 3, 6};
+    const AliasTable table(weights);
+    const CounterRng rng(7);
+    std::vector<size_t> hits(weights.size(), 0);
+    constexpr size_t N = 200000;
+    for (uint64_t i = 0; i < N; ++i) {
+        ++hits[table.Sample(rng.Uniform(2 * i), rng.Uniform(2 * i + 1))];
+    }
+    EXPECT_EQ(hits[1], 0u);
+    EXPECT_NEAR(static_cast<double>(hits[0]) / N, 0.1, 0.005);
+    EXPECT_NEAR(static_cast<double>(hits[2]) / N, 0.3, 0.005);
+    EXPECT_NEAR(static_cast<double>(hits[3]) / N, 0.6, 0.005);
+}
+
+TEST(SamplingTest, InteriorPointsLieInsideEveryShapeType) {
+    const Polygon corner({{0, 0}, {4, 0}, {4, 1}, {1, 1}, {1, 4}, {0, 4}});
+    const auto prototype = std::make_shared<const PrototypeShape>(corner);
+    const std::vector<Shape> shapes{
+        Line({0, 0}, {3, 4}),
+        Triangle({0, 0}, {100, 0}, {100, 0.01}),  // Тонкий: отбраковка по bounding box почти всегда промахивается
+        Rectangle({1, 1}, 3, 2),
+        RegularPolygon({0, 0}, 2, 7),
+        Circle({5, 5}, 2),
+        Polygon({{0, 0}, {6, 0}, {6, 6}, {3, 2}, {0, 6}}),
+        FRAME,
+        MultiPolygon({FRAME, PolygonWithHoles({{20, 20}, {22, 20}, {21, 23}})}),
+        InstancedShape(prototype, Transform2D::Make({10, 10}, 0.7, 2.0)),
+    };
+    const CounterRng rng(1);
+    for (const auto &shape : shapes) {
+        const ShapeSampler sampler(shape);
+        for (uint64_t i = 0; i < 2000; ++i) {
+            const Point2D p = sampler.Sample(rng, i);
+            ASSERT_TRUE(Inside(shape, p)) << std::format("{}", shape) << " " << p.x << " " << p.y;
+        }
+    }
+}
+
+TEST(SamplingTest, MeasureIsAreaOrLength) {
+    EXPECT_NEAR(ShapeSampler(FRAME).Measure(), 100.0 - 16.0, 1e-9);
+    EXPECT_NEAR(ShapeSampler(FRAME, Region::Boundary).Measure(), 40.0 + 16.0, 1e-9);
+    EXPECT_NEAR(ShapeSampler(Polygon({{0, 0}, {6, 0}, {6, 6}, {3, 2}, {0, 6}})).Measure(), 36.0 - 12.0, 1e-9);
+    EXPECT_NEAR(ShapeSampler(Circle({0, 0}, 2)).Measure(), 4 * std::numbers::pi, 1e-9);
+    EXPECT_NEAR(ShapeSampler(Circle({0, 0}, 2), Region::Boundary).Measure(), 4 * std::numbers::pi, 1e-9);
+    EXPECT_NEAR(ShapeSampler(Line({0, 0}, {3, 4})).Measure(), 5.0, 1e-12);
+
+    const auto prototype = std::make_shared<const PrototypeShape>(Rectangle({0, 0}, 2, 1));
+    EXPECT_NEAR(ShapeSampler(InstancedShape(prototype, Transform2D::Make({5, 5}, 1.0, 3.0))).Measure(), 18.0, 1e-9);
+
+    // Вырожденный многоугольник сэмплируется по контуру
+    const ShapeSampler flat(Polygon({{0, 0}, {4, 0}, {2, 0}}));
+    EXPECT_NEAR(flat.Measure(), 8.0, 1e-12);
+    EXPECT_EQ(flat.Sample(CounterRng(3), 5).y, 0.0);
+}
+
+TEST(SamplingTest, InteriorDistributionIsUniform) {
+    const ShapeSampler sampler(FRAME);
+    constexpr size_t N = 100000;
+    std::vector<double> xs(N), ys(N);
+    sampler.Fill(CounterRng(11), 0, xs, ys);
+
+    // Доли по четвертям рамки равны, среднее — центр симметрии
+    std::array<size_t, 4> quadrants{};
+    double sum_x = 0, sum_y = 0;
+    for (size_t i = 0; i < N; ++i) {
+        ++quadrants[(xs[i] < 5 ? 0 : 1) + (ys[i] < 5 ? 0 : 2)];
+        sum_x += xs[i];
+        sum_y += ys[i];
+    }
+    for (size_t q : quadrants) {
+        EXPECT_NEAR(static_cast<double>(q) / N, 0.25, 0.01);
+    }
+    EXPECT_NEAR(sum_x / N, 5.0, 0.05);
+    EXPECT_NEAR(sum_y / N, 5.0, 0.05);
+
+    // Полоса 0 <= x < 1 занимает 10 / 84 площади рамки
+    const auto strip = std::ranges::count_if(xs, [](double x) { return x < 1.0; });
+    EXPECT_NEAR(static_cast<double>(strip) / N, 10.0 / 84.0, 0.005);
+}
+
+TEST(SamplingTest, BoundaryPointsLieOnContour) {
+    const CounterRng rng(5);
+    const ShapeSampler circle(Circle({1, 2}, 3), Region::Boundary);
+    const ShapeSampler frame(FRAME, Region::Boundary);
+    size_t on_hole = 0;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        EXPECT_NEAR(circle.Sample(rng, i).DistanceTo({1, 2}), 3.0, 1e-12);
+        const Point2D p = frame.Sample(rng, i);
+        const double outer = std::min({p.x, p.y, 10 - p.x, 10 - p.y});
+        const double hole = std::max(std::abs(p.x - 5), std::abs(p.y - 5)) - 2;
+        EXPECT_TRUE(std::abs(outer) < 1e-12 || std::abs(hole) < 1e-12) << p.x << " " << p.y;
+        on_hole += std::abs(hole) < 1e-12;
+    }
+    // Длина контура дыры — 16 из 56
+    EXPECT_NEAR(static_cast<double>(on_hole) / 1000, 16.0 / 56.0, 0.05);
+}
+
+TEST(SamplingTest, FillIsReproducibleAcrossThreads) {
+    const ShapeSampler sampler(MultiPolygon({FRAME, PolygonWithHoles({{20, 20}, {22, 20}, {21, 23}})}));
+    const CounterRng rng(42);
+    constexpr size_t N = 50000;
+    std::vector<double> xs1(N), ys1(N), xs8(N), ys8(N);
+    sampler.Fill(rng, 0, xs1, ys1, 1);
+    sampler.Fill(rng, 0, xs8, ys8, 8);
+    EXPECT_EQ(xs1, xs8);
+    EXPECT_EQ(ys1, ys8);
+
+    // Пакет со смещением продолжает ту же последовательность
+    std::vector<double> xs(10), ys(10);
+    sampler.Fill(rng, 1000, xs, ys, 3);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        EXPECT_EQ(xs[i], xs1[1000 + i]);
+        EXPECT_EQ(ys[i], ys1[1000 + i]);
+    }
+    EXPECT_NE(sampler.Sample(CounterRng(43), 0).x, xs1[0]);
+}
+
+TEST(SamplingTest, SelfIntersectingPolygonFollowsEvenOddRule) {
+    // Пентаграмма: центральный пятиугольник обходится дважды и по правилу чётности лежит снаружи
+    std::vector<Point2D> star;
+    for (int k = 0; k < 5; ++k) {
+        const double angle = std::numbers::pi / 2 + 4 * std::numbers::pi * k / 5;
+        star.emplace_back(10 * std::cos(angle), 10 * std::sin(angle));
+    }
+    const Shape pentagram = Polygon(star);
+    const ShapeSampler sampler(pentagram);
+    const CounterRng rng(9);
+    size_t near_center = 0;
+    for (uint64_t i = 0; i < 5000; ++i) {
+        const Point2D p = sampler.Sample(rng, i);
+        ASSERT_TRUE(Inside(pentagram, p)) << p.x << " " << p.y;
+        near_center += p.DistanceTo({0, 0}) < 3.0;
+    }
+    EXPECT_EQ(near_center, 0u);
+}
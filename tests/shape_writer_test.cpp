@@ -0,0 +1,107 @@
+#include "shape_utils.hpp"
+#include "shape_writer.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::utils;
+
+TEST(ShapeWriterTest, WritesParseShapesFormat) {
+    const std::vector<Shape> shapes{Circle({-3, 0}, 2), Line({0, 0}, {1.5, -2}), Triangle({0, 0}, {1, 0}, {0, 1}),
+                                    Rectangle({0.25, 0}, 2, 3), RegularPolygon({1, 1}, 2, 6)};
+    ShapeWriter writer(1);
+    const auto text = writer.Write(shapes);
+    ASSERT_TRUE(text.has_value());
+    EXPECT_EQ(*text, "circle -3 0 2;\n"
+                     "line 0 0 1.5 -2;\n"
+                     "triangle 0 0 1 0 0 1;\n"
+                     "rectangle 0.25 0 2 3;\n"
+                     "polygon 1 1 2 6;\n");
+    EXPECT_EQ(*writer.Write({}), "");
+}
+
+TEST(ShapeWriterTest, RoundTripsExactlyThroughParseShapes) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> coord(-1e3, 1e3);
+    std::uniform_real_distribution<double> size(1e-6, 50.0);
+    std::vector<Shape> shapes;
+    for (int i = 0; i < 20000; ++i) {
+        const Point2D p{coord(rng), coord(rng)};
+        switch (i % 5) {
+        case 0:
+            shapes.emplace_back(Circle(p, size(rng)));
+            break;
+        case 1:
+            shapes.emplace_back(Line(p, {coord(rng), coord(rng)}));
+            break;
+        case 2:
+            shapes.emplace_back(Triangle(p, {coord(rng), coord(rng)}, {coord(rng), coord(rng)}));
+            break;
+        case 3:
+            shapes.emplace_back(Rectangle(p, size(rng), size(rng)));
+            break;
+        default:
+            shapes.emplace_back(RegularPolygon(p, size(rng), 3 + i % 9));
+        }
+    }
+
+    ShapeWriter writer(4);
+    const auto text = writer.Write(shapes);
+    ASSERT_TRUE(text.has_value());
+    const auto parsed = ParseShapes(*text);
+    ASSERT_EQ(parsed.size(), shapes.size());
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        EXPECT_EQ(parsed[i].index(), shapes[i].index()) << i;
+        if (const auto *circle = std::get_if<Circle>(&shapes[i])) {
+            const auto &back = std::get<Circle>(parsed[i]);
+            EXPECT_EQ(back.center_p, circle->center_p);
+            EXPECT_EQ(back.radius, circle->radius);
+        } else if (const auto *triangle = std::get_if<Triangle>(&shapes[i])) {
+            const auto &back = std::get<Triangle>(parsed[i]);
+            EXPECT_EQ(back.Vertices(), triangle->Vertices());
+        } else if (const auto *polygon = std::get_if<RegularPolygon>(&shapes[i])) {
+            const auto &back = std::get<RegularPolygon>(parsed[i]);
+            EXPECT_EQ(back.center_p, polygon->center_p);
+            EXPECT_EQ(back.radius, polygon->radius);
+            EXPECT_EQ(back.sides, polygon->sides);
+        }
+    }
+
+    // Результат не зависит от числа потоков, буфер переиспользуется
+    const std::string parallel(*text);
+    ShapeWriter serial(1);
+    EXPECT_EQ(*serial.Write(shapes), parallel);
+    EXPECT_EQ(*writer.Write(shapes), parallel);
+}
+
+TEST(ShapeWriterTest, RejectsShapesWithoutTextForm) {
+    const std::vector<Shape> shapes{Circle({0, 0}, 1), Polygon({{0, 0}, {1, 0}, {0, 1}})};
+    ShapeWriter writer;
+    const auto text = writer.Write(shapes);
+    ASSERT_FALSE(text.has_value());
+    EXPECT_NE(text.error().find("no text form"), std::string::npos);
+}
+
+TEST(ShapeWriterTest, RejectsParametersParseShapesDrops) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    const std::vector<Shape> invalid{
+        Circle({0, 0}, 0),
+        Circle({0, 0}, inf),
+        Circle({nan, 0}, 1),
+        Rectangle({0, 0}, -1, 1),
+        Rectangle({0, 0}, 1, 0),
+        RegularPolygon({0, 0}, 1, 2),
+        RegularPolygon({0, 0}, -1, 5),
+        Line({0, 0}, {inf, 1}),
+        Triangle({0, 0}, {1, 0}, {0, nan}),
+    };
+    ShapeWriter writer;
+    for (const auto &shape : invalid) {
+        // Перед недопустимой фигурой стоит допустимая: ошибка называет номер именно плохой
+        const std::vector<Shape> shapes{Circle({0, 0}, 1), shape};
+        const auto text = writer.Write(shapes);
+        ASSERT_FALSE(text.has_value()) << std::format("{}", shape);
+        EXPECT_TRUE(text.error().starts_with("Shape 1 ")) << text.error();
+    }
+}
@@ -0,0 +1,93 @@
+#include "similarity.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::similarity;
+
+namespace {
+
+double NaiveDirectedHausdorff(std::span<const Point2D> a, std::span<const Point2D> b) {
+    double result = 0.0;
+    for (const auto &p : a) {
+        double nearest = std::numeric_limits<double>::max();
+        for (const auto &q : b) {
+            nearest = std::min(nearest, p.DistanceTo(q));
+        }
+        result = std::max(result, nearest);
+    }
+    return result;
+}
+
+std::vector<Point2D> RandomWalk(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> step(0.0, 1.0);
+    std::vector<Point2D> points{{0, 0}};
+    for (size_t i = 1; i < count; ++i) {
+        points.push_back(points.back() + Point2D{step(rng), step(rng)});
+    }
+    return points;
+}
+
+}  // namespace
+
+TEST(SimilarityTest, Hausdorff_Shapes) {
+    Rectangle rect{{0, 0}, 2, 2};
+    Triangle tri{{0, 0}, {2, 0}, {0, 2}};
+    // Вершина (2, 2) прямоугольника удалена от ближайших вершин треугольника на 2
+    EXPECT_DOUBLE_EQ(DirectedHausdorff(rect.Vertices(), tri.Vertices()), 2.0);
+    EXPECT_DOUBLE_EQ(DirectedHausdorff(tri.Vertices(), rect.Vertices()), 0.0);
+    EXPECT_DOUBLE_EQ(HausdorffDistance(tri.Vertices(), rect.Vertices()), 2.0);
+
+    Polygon poly{std::vector<Point2D>{{0, 0}, {2, 0}, {2, 2}, {0, 2}}};
+    EXPECT_DOUBLE_EQ(HausdorffDistance(poly.Vertices(), rect.Vertices()), 0.0);
+}
+
+TEST(SimilarityTest, Hausdorff_MatchesNaive) {
+    const auto a = RandomWalk(300, 1);
+    const auto b = RandomWalk(200, 2);
+    const double expected = std::max(NaiveDirectedHausdorff(a, b), NaiveDirectedHausdorff(b, a));
+
+    EXPECT_DOUBLE_EQ(DirectedHausdorff(a, b), NaiveDirectedHausdorff(a, b));
+    EXPECT_DOUBLE_EQ(HausdorffDistance(a, b), expected);
+}
+
+TEST(SimilarityTest, Hausdorff_Within) {
+    std::vector<Point2D> a = {{0, 0}, {1, 0}, {2, 0}};
+    std::vector<Point2D> b = {{0, 1}, {1, 1}, {2, 1}};
+
+    auto within = HausdorffDistanceWithin(a, b, 1.5);
+    ASSERT_TRUE(within.has_value());
+    EXPECT_DOUBLE_EQ(*within, 1.0);
+    EXPECT_FALSE(HausdorffDistanceWithin(a, b, 0.5).has_value());
+}
+
+TEST(SimilarityTest, Frechet_Basic) {
+    std::vector<Point2D> a = {{0, 0}, {1, 0}, {2, 0}};
+    std::vector<Point2D> b = {{0, 1}, {1, 1}, {2, 1}};
+    EXPECT_DOUBLE_EQ(DiscreteFrechetDistance(a, b), 1.0);
+
+    // Обратный порядок обхода: Хаусдорф не видит разницы, Фреше — видит
+    std::vector<Point2D> reversed(a.rbegin(), a.rend());
+    EXPECT_DOUBLE_EQ(HausdorffDistance(a, reversed), 0.0);
+    EXPECT_DOUBLE_EQ(DiscreteFrechetDistance(a, reversed), 2.0);
+}
+
+TEST(SimilarityTest, Frechet_Within) {
+    const auto a = RandomWalk(100, 3);
+    const auto b = RandomWalk(120, 4);
+    const double exact = DiscreteFrechetDistance(a, b);
+
+    auto above = DiscreteFrechetDistanceWithin(a, b, exact + 1e-9);
+    ASSERT_TRUE(above.has_value());
+    EXPECT_DOUBLE_EQ(*above, exact);
+    EXPECT_FALSE(DiscreteFrechetDistanceWithin(a, b, exact * 0.99).has_value());
+    EXPECT_GE(exact, HausdorffDistance(a, b));
+}
+
+TEST(SimilarityTest, EmptyInput) {
+    std::vector<Point2D> a = {{0, 0}};
+    EXPECT_TRUE(std::isinf(HausdorffDistance(a, {})));
+    EXPECT_TRUE(std::isinf(DiscreteFrechetDistance({}, a)));
+    EXPECT_FALSE(DiscreteFrechetDistanceWithin({}, a, 10.0).has_value());
+}
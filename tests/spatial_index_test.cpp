@@ -0,0 +1,54 @@
+#include "spatial_index.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::index;
+
+TEST(GridIndexTest, Empty) {
+    GridIndex grid(std::span<const BoundingBox>{});
+    EXPECT_EQ(grid.Size(), 0);
+    EXPECT_TRUE(grid.Query(BoundingBox{0, 0, 1, 1}).empty());
+}
+
+TEST(GridIndexTest, ReportsEachItemOnce) {
+    // Большой прямоугольник покрывает много ячеек, но должен вернуться один раз
+    std::vector<BoundingBox> boxes = {{0, 0, 10, 10}, {1, 1, 1.5, 1.5}, {8, 8, 9, 9}, {20, 20, 21, 21}};
+    GridIndex grid(boxes, 1.0);
+
+    auto hits = grid.Query(BoundingBox{0.5, 0.5, 9.5, 9.5});
+    std::ranges::sort(hits);
+    EXPECT_EQ(hits, (std::vector<size_t>{0, 1, 2}));
+
+    EXPECT_EQ(grid.Query(BoundingBox{20.5, 20.5, 30, 30}), (std::vector<size_t>{3}));
+    EXPECT_TRUE(grid.Query(BoundingBox{-5, -5, -1, -1}).empty());
+}
+
+TEST(GridIndexTest, MatchesBruteForce) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> pos(0.0, 100.0);
+    std::uniform_real_distribution<double> size(0.0, 5.0);
+
+    std::vector<BoundingBox> boxes;
+    for (int i = 0; i < 500; ++i) {
+        const double x = pos(rng), y = pos(rng);
+        boxes.emplace_back(x, y, x + size(rng), y + size(rng));
+    }
+    GridIndex grid(boxes);
+
+    for (int q = 0; q < 50; ++q) {
+        const double x = pos(rng), y = pos(rng);
+        const BoundingBox query{x, y, x + 3 * size(rng), y + 3 * size(rng)};
+
+        auto hits = grid.Query(query);
+        std::ranges::sort(hits);
+
+        std::vector<size_t> expected;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].Overlaps(query)) {
+                expected.push_back(i);
+            }
+        }
+        EXPECT_EQ(hits, expected);
+    }
+}
@@ -0,0 +1,126 @@
+#include "queries.hpp"
+#include "spatial_join.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::join;
+
+namespace {
+
+std::vector<Shape> RandomShapes(size_t count, double max_size, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> pos(0.0, 100.0);
+    std::uniform_real_distribution<double> size(0.1, max_size);
+
+    std::vector<Shape> shapes;
+    for (size_t i = 0; i < count; ++i) {
+        const Point2D p{pos(rng), pos(rng)};
+        switch (i % 3) {
+        case 0:
+            shapes.emplace_back(Circle{p, size(rng)});
+            break;
+        case 1:
+            shapes.emplace_back(Rectangle{p, size(rng), size(rng)});
+            break;
+        default:
+            shapes.emplace_back(Triangle{p, p + Point2D{size(rng), 0}, p + Point2D{0, size(rng)}});
+            break;
+        }
+    }
+    return shapes;
+}
+
+std::vector<IndexPair> BruteForceJoin(std::span<const Shape> a, std::span<const Shape> b, bool exact) {
+    std::vector<IndexPair> result;
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < b.size(); ++j) {
+            if (exact ? queries::ShapesIntersect(a[i], b[j]) : queries::BoundingBoxesOverlap(a[i], b[j])) {
+                result.emplace_back(i, j);
+            }
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+TEST(SpatialJoinTest, EmptyInput) {
+    std::vector<Shape> a = {Circle{{0, 0}, 1}};
+    EXPECT_TRUE(SpatialJoin(a, {}).empty());
+    EXPECT_TRUE(SpatialJoin({}, a).empty());
+}
+
+TEST(SpatialJoinTest, ChooseStrategy) {
+    EXPECT_EQ(ChooseJoinStrategy(10, 100), JoinStrategy::IndexNestedLoop);
+    EXPECT_EQ(ChooseJoinStrategy(1'000'000, 10'000), JoinStrategy::IndexNestedLoop);
+    EXPECT_EQ(ChooseJoinStrategy(100'000, 50'000), JoinStrategy::Partition);
+}
+
+TEST(SpatialJoinTest, StrategiesMatchBruteForce) {
+    const auto a = RandomShapes(700, 4.0, 1);
+    const auto b = RandomShapes(300, 8.0, 2);
+    const auto expected = BruteForceJoin(a, b, false);
+    ASSERT_FALSE(expected.empty());
+
+    for (auto strategy : {JoinStrategy::IndexNestedLoop, JoinStrategy::Partition}) {
+        for (size_t threads : {1uz, 4uz}) {
+            EXPECT_EQ(SpatialJoin(a, b, {.strategy = strategy, .threads = threads}), expected);
+            EXPECT_EQ(SpatialJoin(b, a, {.strategy = strategy, .threads = threads}).size(), expected.size());
+        }
+    }
+}
+
+TEST(SpatialJoinTest, ExactRefinement) {
+    // Bounding box круга задевает угол прямоугольника, а сам круг — нет
+    std::vector<Shape> a = {Circle{{0, 0}, 1}};
+    std::vector<Shape> b = {Rectangle{{0.9, 0.9}, 1, 1}, Rectangle{{0.5, -0.5}, 1, 1}};
+
+    EXPECT_EQ(SpatialJoin(a, b).size(), 2);
+    EXPECT_EQ(SpatialJoin(a, b, {.exact = true}), (std::vector<IndexPair>{{0, 1}}));
+
+    const auto big_a = RandomShapes(400, 6.0, 3);
+    const auto big_b = RandomShapes(400, 6.0, 4);
+    const auto expected = BruteForceJoin(big_a, big_b, true);
+    EXPECT_EQ(SpatialJoin(big_a, big_b, {.strategy = JoinStrategy::Partition, .exact = true}), expected);
+    EXPECT_EQ(SpatialJoin(big_a, big_b, {.strategy = JoinStrategy::IndexNestedLoop, .exact = true}), expected);
+}
+
+TEST(DistanceJoinTest, MatchesBruteForce) {
+    const auto sensors = RandomShapes(500, 2.0, 5);
+    const auto obstacles = RandomShapes(200, 6.0, 6);
+    const double distance = 1.5;
+
+    std::vector<IndexPair> expected;
+    for (size_t i = 0; i < sensors.size(); ++i) {
+        for (size_t j = 0; j < obstacles.size(); ++j) {
+            if (queries::ExactDistanceBetweenShapes(sensors[i], obstacles[j]) <= distance) {
+                expected.emplace_back(i, j);
+            }
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+
+    EXPECT_EQ(DistanceJoin(sensors, obstacles, distance, {.threads = 1}), expected);
+    EXPECT_EQ(DistanceJoin(sensors, obstacles, distance, {.threads = 4, .batch_size = 7}), expected);
+}
+
+TEST(DistanceJoinTest, StreamsToSink) {
+    std::vector<Shape> sensors = {Circle{{0, 0}, 0.5}, Circle{{10, 0}, 0.5}};
+    std::vector<Shape> obstacles = {Rectangle{{1, -1}, 2, 2}, Line{{0, 3}, {10, 3}}};
+
+    size_t batches = 0;
+    std::vector<IndexPair> pairs;
+    DistanceJoin(
+        sensors, obstacles, 1.0,
+        [&](std::span<const IndexPair> batch) {
+            ++batches;
+            pairs.insert(pairs.end(), batch.begin(), batch.end());
+        },
+        {.threads = 2, .batch_size = 1});
+
+    std::ranges::sort(pairs);
+    EXPECT_EQ(pairs, (std::vector<IndexPair>{{0, 0}}));
+    EXPECT_EQ(batches, 1);
+    EXPECT_TRUE(DistanceJoin(sensors, obstacles, 2.5).size() == 3);
+}
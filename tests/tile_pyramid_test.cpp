@@ -0,0 +1,164 @@
+#include "tile_pyramid.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::tiles;
+
+namespace {
+
+const BoundingBox WORLD{0, 0, 100, 100};
+
+std::vector<TileFeature> Decode(const TilePyramid &pyramid, const TileKey &key) {
+    auto features = DecodeTile(pyramid.Tile(key));
+    EXPECT_TRUE(features.has_value());
+    return features.value_or(std::vector<TileFeature>{});
+}
+
+std::vector<Shape> RandomScene(std::mt19937 &rng, size_t count) {
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+    std::uniform_real_distribution<double> size(0.5, 8.0);
+    std::vector<Shape> shapes;
+    for (size_t i = 0; i < count; ++i) {
+        const Point2D p{coord(rng), coord(rng)};
+        switch (i % 5) {
+        case 0:
+            shapes.emplace_back(Circle(p, size(rng)));
+            break;
+        case 1:
+            shapes.emplace_back(Rectangle(p, size(rng), size(rng)));
+            break;
+        case 2:
+            shapes.emplace_back(Line(p, {coord(rng), coord(rng)}));
+            break;
+        case 3:
+            shapes.emplace_back(Triangle(p, p + Point2D{size(rng), 0}, p + Point2D{0, size(rng)}));
+            break;
+        default:
+            shapes.emplace_back(PolygonWithHoles({p, p + Point2D{6, 0}, p + Point2D{6, 6}, p + Point2D{0, 6}},
+                                                 {{p + Point2D{2, 2}, p + Point2D{2, 4}, p + Point2D{4, 4}}}));
+        }
+    }
+    return shapes;
+}
+
+}  // namespace
+
+TEST(TilePyramidTest, WorldCoveringRectangleFillsEveryTile) {
+    TilePyramid pyramid(WORLD, {.max_zoom = 2});
+    const std::vector<Shape> shapes{Rectangle({-10, -10}, 120, 120)};
+    pyramid.Build(shapes);
+    EXPECT_EQ(pyramid.TileCount(), 1u + 4u + 16u);
+
+    for (const auto &[key, blob] : pyramid.Tiles()) {
+        const auto features = Decode(pyramid, key);
+        ASSERT_EQ(features.size(), 1u);
+        EXPECT_TRUE(features[0].closed);
+        ASSERT_EQ(features[0].rings.size(), 1u);
+        // Кольцо обрезано окном тайла с запасом: от -buffer до extent + buffer
+        for (const auto &p : features[0].rings[0]) {
+            EXPECT_TRUE(p.x == -64 || p.x == 4096 + 64) << p.x;
+            EXPECT_TRUE(p.y == -64 || p.y == 4096 + 64) << p.y;
+        }
+    }
+}
+
+TEST(TilePyramidTest, LineIsClippedPerTile) {
+    TilePyramid pyramid(WORLD, {.max_zoom = 1, .buffer = 0});
+    const std::vector<Shape> shapes{Line({10, 30}, {90, 30})};
+    pyramid.Build(shapes);
+
+    const auto root = Decode(pyramid, {0, 0, 0});
+    ASSERT_EQ(root.size(), 1u);
+    EXPECT_FALSE(root[0].closed);
+    EXPECT_EQ(root[0].rings[0], (std::vector<Point2D>{{410, 1229}, {3686, 1229}}));
+
+    const auto left = Decode(pyramid, {1, 0, 0});
+    const auto right = Decode(pyramid, {1, 1, 0});
+    ASSERT_EQ(left.size(), 1u);
+    ASSERT_EQ(right.size(), 1u);
+    EXPECT_EQ(left[0].rings[0], (std::vector<Point2D>{{819, 2458}, {4096, 2458}}));
+    EXPECT_EQ(right[0].rings[0], (std::vector<Point2D>{{0, 2458}, {3277, 2458}}));
+    EXPECT_TRUE(pyramid.Tile({1, 0, 1}).empty());
+}
+
+TEST(TilePyramidTest, SimplificationDependsOnZoom) {
+    // Квадрат, у которого нижняя сторона — пила с зубцами 0.01
+    std::vector<Point2D> outline;
+    for (int i = 0; i <= 1000; ++i) {
+        outline.push_back({20 + 0.05 * i, 20 + (i % 2) * 0.01});
+    }
+    outline.push_back({70, 70});
+    outline.push_back({20, 70});
+    const std::vector<Shape> shapes{Polygon(outline)};
+
+    TilePyramid pyramid(WORLD, {.max_zoom = 8});
+    pyramid.Build(shapes);
+    const auto coarse = Decode(pyramid, {0, 0, 0});
+    ASSERT_EQ(coarse.size(), 1u);
+    EXPECT_EQ(coarse[0].rings[0].size(), 4u);
+
+    // На уровне 8 клетка решётки около 0.0001, и зубцы видны
+    const auto key = TileKey{8, 256 * 30 / 100, 256 * 20 / 100};
+    const auto fine = Decode(pyramid, key);
+    ASSERT_EQ(fine.size(), 1u);
+    EXPECT_GT(fine[0].rings[0].size(), 8u);
+}
+
+TEST(TilePyramidTest, ShapesOutsideWorldProduceNoTiles) {
+    TilePyramid pyramid(WORLD, {.max_zoom = 3});
+    const std::vector<Shape> shapes{Circle({300, 300}, 5)};
+    pyramid.Build(shapes);
+    EXPECT_EQ(pyramid.TileCount(), 0u);
+    EXPECT_TRUE(pyramid.Tile({0, 0, 0}).empty());
+}
+
+TEST(TilePyramidTest, ParallelBuildIsDeterministic) {
+    std::mt19937 rng(1);
+    const auto shapes = RandomScene(rng, 300);
+    TilePyramid serial(WORLD, {.max_zoom = 4, .threads = 1});
+    TilePyramid parallel(WORLD, {.max_zoom = 4, .threads = 4});
+    serial.Build(shapes);
+    parallel.Build(shapes);
+    EXPECT_EQ(serial.Tiles(), parallel.Tiles());
+
+    const auto root = Decode(serial, {0, 0, 0});
+    EXPECT_EQ(root.size(), shapes.size());
+    for (size_t i = 0; i < root.size(); ++i) {
+        EXPECT_EQ(root[i].id, i);
+    }
+}
+
+TEST(TilePyramidTest, UpdateMatchesFullRebuild) {
+    std::mt19937 rng(2);
+    auto shapes = RandomScene(rng, 300);
+    TilePyramid pyramid(WORLD, {.max_zoom = 5, .threads = 3});
+    pyramid.Build(shapes);
+
+    std::vector<size_t> changed{3, 77, 150, 151, 299};
+    for (size_t i : changed) {
+        shapes[i] = Circle({static_cast<double>(i % 90) + 5, 50}, 2.0);
+    }
+    const size_t regenerated = pyramid.Update(shapes, changed);
+    EXPECT_GT(regenerated, 0u);
+    EXPECT_LT(regenerated, pyramid.TileCount());
+
+    TilePyramid rebuilt(WORLD, {.max_zoom = 5});
+    rebuilt.Build(shapes);
+    EXPECT_EQ(pyramid.Tiles(), rebuilt.Tiles());
+    EXPECT_EQ(pyramid.Update(shapes, {}), 0u);
+}
+
+TEST(TilePyramidTest, DecodeRejectsDamagedBlob) {
+    TilePyramid pyramid(WORLD, {.max_zoom = 0});
+    const std::vector<Shape> shapes{Triangle({10, 10}, {50, 10}, {30, 40})};
+    pyramid.Build(shapes);
+    const auto blob = pyramid.Tile({0, 0, 0});
+    ASSERT_FALSE(blob.empty());
+
+    EXPECT_FALSE(DecodeTile(blob.first(blob.size() - 1)).has_value());
+    std::vector<uint8_t> padded(blob.begin(), blob.end());
+    padded.push_back(0);
+    EXPECT_FALSE(DecodeTile(padded).has_value());
+    EXPECT_TRUE(DecodeTile({}).has_value());
+}
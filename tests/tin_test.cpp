@@ -0,0 +1,122 @@
+#include "tin.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::triangulation;
+
+namespace {
+
+double Plane(const Point2D &p) { return 2.0 * p.x - 3.0 * p.y + 5.0; }
+
+struct Samples {
+    std::vector<Point2D> points;
+    std::vector<double> values;
+};
+
+Samples RandomSamples(size_t count, double (*f)(const Point2D &)) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coord(0.0, 10.0);
+    Samples samples;
+    samples.points = {{0, 0}, {10, 0}, {10, 10}, {0, 10}};
+    for (size_t i = 0; i < count; ++i) {
+        samples.points.emplace_back(coord(rng), coord(rng));
+    }
+    for (const auto &p : samples.points) {
+        samples.values.push_back(f(p));
+    }
+    return samples;
+}
+
+}  // namespace
+
+TEST(TinTest, BuildErrors) {
+    std::vector<Point2D> points = {{0, 0}, {1, 0}, {2, 0}};
+    std::vector<double> values = {1, 2};
+    auto mismatched = Tin::Build(points, values);
+    ASSERT_FALSE(mismatched.has_value());
+    EXPECT_EQ(mismatched.error(), "Each sample point requires exactly one value.");
+
+    values.push_back(3);
+    EXPECT_FALSE(Tin::Build(points, values).has_value());
+}
+
+TEST(TinTest, DuplicateSamplesAreAveraged) {
+    std::vector<Point2D> points = {{0, 0}, {1, 0}, {0, 1}, {0, 0}};
+    std::vector<double> values = {1, 2, 3, 5};
+    auto tin = Tin::Build(points, values);
+    ASSERT_TRUE(tin.has_value());
+    EXPECT_EQ(tin->Mesh().vertices.size(), 3);
+    EXPECT_DOUBLE_EQ(*tin->Interpolate({0, 0}), 3.0);
+}
+
+TEST(TinTest, LinearPrecision) {
+    // Обе схемы воспроизводят линейную функцию точно
+    const auto samples = RandomSamples(200, Plane);
+    auto tin = Tin::Build(samples.points, samples.values);
+    ASSERT_TRUE(tin.has_value());
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> coord(1.0, 9.0);
+    for (int i = 0; i < 200; ++i) {
+        const Point2D p{coord(rng), coord(rng)};
+        const auto linear = tin->Interpolate(p);
+        const auto natural = tin->Interpolate(p, InterpolationMethod::NaturalNeighbor);
+        ASSERT_TRUE(linear.has_value());
+        ASSERT_TRUE(natural.has_value());
+        EXPECT_NEAR(*linear, Plane(p), 1e-9);
+        EXPECT_NEAR(*natural, Plane(p), 1e-7);
+    }
+}
+
+TEST(TinTest, NaturalNeighborInterpolatesSamplesAndEdges) {
+    const auto samples = RandomSamples(50, [](const Point2D &p) { return std::sin(p.x) * std::cos(p.y); });
+    auto tin = Tin::Build(samples.points, samples.values);
+    ASSERT_TRUE(tin.has_value());
+
+    for (size_t i = 0; i < samples.points.size(); ++i) {
+        EXPECT_NEAR(*tin->Interpolate(samples.points[i], InterpolationMethod::NaturalNeighbor), samples.values[i],
+                    1e-9);
+    }
+
+    // Точка ровно на внутреннем ребре: результат непрерывен и лежит между значениями соседей
+    const auto &mesh = tin->Mesh();
+    for (size_t t = 0; t < mesh.Size(); ++t) {
+        if (mesh.neighbors[t][0] == NO_NEIGHBOR) {
+            continue;
+        }
+        const Point2D a = mesh.vertices[mesh.triangles[t][0]];
+        const Point2D b = mesh.vertices[mesh.triangles[t][1]];
+        const Point2D mid = (a + b) / 2.0;
+        const auto value = tin->Interpolate(mid, InterpolationMethod::NaturalNeighbor);
+        ASSERT_TRUE(value.has_value());
+        EXPECT_TRUE(std::isfinite(*value));
+        EXPECT_NEAR(*value, *tin->Interpolate(mid + Point2D{1e-6, 1e-6}, InterpolationMethod::NaturalNeighbor),
+                    1e-4);
+        break;
+    }
+}
+
+TEST(TinTest, BatchMatchesSingleQueries) {
+    const auto samples = RandomSamples(300, [](const Point2D &p) { return p.x * p.y; });
+    auto tin = Tin::Build(samples.points, samples.values);
+    ASSERT_TRUE(tin.has_value());
+
+    const RasterGrid grid{{-1, -1, 11, 11}, 24, 24};
+    for (auto method : {InterpolationMethod::Linear, InterpolationMethod::NaturalNeighbor}) {
+        const auto values = tin->Interpolate(grid, method, 4);
+        ASSERT_EQ(values.size(), grid.columns * grid.rows);
+        for (size_t row = 0; row < grid.rows; ++row) {
+            for (size_t column = 0; column < grid.columns; ++column) {
+                const auto single = tin->Interpolate(grid.Node(column, row), method);
+                const double batch = values[row * grid.columns + column];
+                ASSERT_EQ(single.has_value(), !std::isnan(batch));
+                if (single) {
+                    EXPECT_NEAR(*single, batch, 1e-12);
+                }
+            }
+        }
+    }
+    EXPECT_TRUE(std::isnan(tin->Interpolate(std::vector<Point2D>{{-5, -5}}).front()));
+}
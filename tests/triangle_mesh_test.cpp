@@ -0,0 +1,37 @@
+#include "triangle_mesh.hpp"
+#include <gtest/gtest.h>
+
+using namespace geometry;
+using namespace geometry::triangulation;
+
+TEST(TriangleMeshTest, BuildFromDelaunay) {
+    std::vector<Point2D> points = {{0, 0}, {1, 0}, {0, 1}, {1, 1}};
+    auto triangles = DelaunayTriangulation(points);
+    ASSERT_TRUE(triangles.has_value());
+
+    auto mesh = BuildMesh(*triangles);
+    EXPECT_EQ(mesh.vertices.size(), 4);
+    ASSERT_EQ(mesh.Size(), 2);
+
+    // Два треугольника квадрата смежны ровно по одному ребру
+    size_t shared = 0;
+    for (size_t t = 0; t < mesh.Size(); ++t) {
+        for (size_t k = 0; k < 3; ++k) {
+            if (mesh.neighbors[t][k] != NO_NEIGHBOR) {
+                EXPECT_EQ(mesh.neighbors[t][k], 1 - t);
+                ++shared;
+            }
+        }
+    }
+    EXPECT_EQ(shared, 2);
+}
+
+TEST(TriangleMeshTest, OrientsAndDropsDegenerate) {
+    std::vector<Point2D> vertices = {{0, 0}, {1, 0}, {0, 1}, {2, 0}};
+    auto mesh = BuildMesh(vertices, {{0, 2, 1}, {0, 1, 3}});
+
+    ASSERT_EQ(mesh.Size(), 1);
+    const Triangle t = mesh.GetTriangle(0);
+    EXPECT_GT((t.b - t.a).Cross(t.c - t.a), 0.0);
+    EXPECT_EQ(mesh.neighbors[0], (std::array{NO_NEIGHBOR, NO_NEIGHBOR, NO_NEIGHBOR}));
+}
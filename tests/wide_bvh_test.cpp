@@ -0,0 +1,95 @@
+#include "wide_bvh.hpp"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace geometry;
+using namespace geometry::index;
+
+namespace {
+
+std::vector<size_t> BruteForce(std::span<const BoundingBox> boxes, const BoundingBox &query) {
+    std::vector<size_t> hits;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        if (boxes[i].Overlaps(query)) {
+            hits.push_back(i);
+        }
+    }
+    return hits;
+}
+
+}  // namespace
+
+TEST(WideBvhTest, Empty) {
+    WideBvh bvh(std::span<const BoundingBox>{});
+    EXPECT_EQ(bvh.Size(), 0);
+    EXPECT_EQ(bvh.NodeCount(), 0);
+    EXPECT_TRUE(bvh.Query(BoundingBox{0, 0, 1, 1}).empty());
+}
+
+TEST(WideBvhTest, SingleLeafAndDegenerateBoxes) {
+    // Точки и отрезки нулевой ширины: шаг решётки по вырожденной оси не должен стать нулевым
+    std::vector<BoundingBox> boxes = {{1, 1, 1, 1}, {2, 1, 2, 1}, {5, 1, 6, 1}};
+    WideBvh bvh(boxes);
+    EXPECT_EQ(bvh.NodeCount(), 1);
+
+    auto hits = bvh.Query(BoundingBox{0, 0, 2, 2});
+    std::ranges::sort(hits);
+    EXPECT_EQ(hits, (std::vector<size_t>{0, 1}));
+    EXPECT_EQ(bvh.Query(BoundingBox{5.5, 0, 5.5, 3}), (std::vector<size_t>{2}));
+    EXPECT_TRUE(bvh.Query(BoundingBox{3, 3, 4, 4}).empty());
+}
+
+TEST(WideBvhTest, ReportsSupersetOfExactHits) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> pos(-500.0, 500.0);
+    std::uniform_real_distribution<double> size(0.0, 4.0);
+
+    std::vector<BoundingBox> boxes;
+    for (int i = 0; i < 5000; ++i) {
+        const double x = pos(rng), y = pos(rng);
+        boxes.emplace_back(x, y, x + size(rng), y + size(rng));
+    }
+    const WideBvh bvh(boxes);
+    EXPECT_EQ(bvh.Size(), boxes.size());
+
+    size_t exact_total = 0, reported_total = 0;
+    for (int q = 0; q < 200; ++q) {
+        const double x = pos(rng), y = pos(rng);
+        const BoundingBox query{x, y, x + 30, y + 30};
+
+        auto hits = bvh.Query(query);
+        std::ranges::sort(hits);
+        EXPECT_EQ(std::ranges::adjacent_find(hits), hits.end());
+
+        const auto exact = BruteForce(boxes, query);
+        EXPECT_TRUE(std::ranges::includes(hits, exact));
+        // Лишние кандидаты не дальше шага решётки листа от запроса
+        for (size_t i : hits) {
+            EXPECT_TRUE(boxes[i].Overlaps({query.min_x - 1, query.min_y - 1, query.max_x + 1, query.max_y + 1}));
+        }
+        exact_total += exact.size();
+        reported_total += hits.size();
+    }
+    EXPECT_LT(reported_total, exact_total + exact_total / 4 + 10);
+}
+
+TEST(WideBvhTest, CompactNodes) {
+    std::vector<BoundingBox> boxes;
+    for (int i = 0; i < 4096; ++i) {
+        boxes.emplace_back(i % 64, i / 64, i % 64 + 0.5, i / 64 + 0.5);
+    }
+    const WideBvh bvh(boxes);
+
+    // 512 листьев, 64 + 8 + 1 узел выше
+    EXPECT_EQ(bvh.NodeCount(), 585);
+    // Меньше 16 байт на объект против 32 байт одного BoundingBox
+    EXPECT_LT(bvh.MemoryUsage(), boxes.size() * 16);
+}
+
+TEST(WideBvhTest, BuildsFromShapes) {
+    std::vector<Shape> shapes = {Circle{{0, 0}, 1}, Rectangle{{10, 10}, 2, 2}, Line{{-5, 5}, {-3, 7}}};
+    const WideBvh bvh(shapes);
+    EXPECT_EQ(bvh.Query(BoundingBox{0.5, 0.5, 0.6, 0.6}), (std::vector<size_t>{0}));
+    EXPECT_EQ(bvh.Query(BoundingBox{11, 11, 20, 20}), (std::vector<size_t>{1}));
+    EXPECT_EQ(bvh.Query(BoundingBox{-4, 6, -4, 6}), (std::vector<size_t>{2}));
+}